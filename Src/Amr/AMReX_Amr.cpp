@@ -303,6 +303,8 @@ Amr::InitAmr ()
     pp.query("regrid_file"      , regrid_grids_file);
 
     pp.query("message_int", message_int);
+
+    pp.query("derive_cache", AmrLevel::derive_cache);
     
     if (pp.contains("run_log"))
     {
@@ -1416,6 +1418,8 @@ Amr::FinalizeInit (Real              strt_time,
       amr_level[lev]->post_init(stop_time);
     }
 
+    AmrLevel::InvalidateDeriveCache();
+
     if (ParallelDescriptor::IOProcessor())
     {
        if (verbose > 1)
@@ -2108,6 +2112,8 @@ Amr::timeStep (int  level,
     perilla::syncAllWorkerThreads();
 #endif
 
+    AmrLevel::InvalidateDeriveCache();
+
     BL_PROFILE_REGION_START("amr_level.advance");
     Real dt_new = amr_level[level]->advance(time,dt_level[level],iteration,niter);
     BL_PROFILE_REGION_STOP("amr_level.advance");
@@ -2186,6 +2192,8 @@ Amr::timeStep (int  level,
 
     amr_level[level]->post_timestep(iteration);
 
+    AmrLevel::InvalidateDeriveCache();
+
 #if defined(USE_PERILLA_PTHREADS) || defined(USE_PERILLA_OMP)
     perilla::syncAllWorkerThreads();
     if(perilla::isMasterThread())
@@ -2440,6 +2448,8 @@ Amr::coarseTimeStep (Real stop_time)
 
     amr_level[0]->postCoarseTimeStep(cumtime);
 
+    AmrLevel::InvalidateDeriveCache();
+
 
     if (verbose > 0)
     {
@@ -2981,6 +2991,8 @@ Amr::regrid (int  lbase,
       amr_level[lev]->post_regrid(lbase,new_finest);
     }
 
+    AmrLevel::InvalidateDeriveCache();
+
     //
     // Report creation of new grids.
     //
@@ -3079,6 +3091,7 @@ Amr::LoadBalanceLevel0 (Real time)
     const auto& dm = makeLoadBalanceDistributionMap(0, time, boxArray(0));
     InstallNewDistributionMap(0, dm);
     amr_level[0]->post_regrid(0,time);
+    AmrLevel::InvalidateDeriveCache();
 }
 
 void
@@ -3131,6 +3144,7 @@ Amr::regrid_level_0_on_restart()
 	this->SetDistributionMap(0, amr_level[0]->DistributionMap());
 
 	amr_level[0]->post_regrid(0,0);
+	AmrLevel::InvalidateDeriveCache();
 	
 	if (ParallelDescriptor::IOProcessor())
 	{
@@ -38,6 +38,8 @@ EBSupport AmrLevel::m_eb_support_level = EBSupport::volume;
 #endif
 
 DescriptorList AmrLevel::desc_lst;
+int            AmrLevel::derive_cache = 0;
+int            AmrLevel::derive_cache_generation = 0;
 DeriveList     AmrLevel::derive_lst;
 
 void
@@ -1608,6 +1610,11 @@ AmrLevel::derive (const std::string& name, Real time, int ngrow)
     if (isStateVariable(name, index, scomp))
     {
         mf.reset(new MultiFab(state[index].boxArray(), dmap, 1, ngrow, MFInfo(), *m_factory));
+        if (const MultiFab* cached = cachedDerive(name, time, *mf))
+        {
+            MultiFab::Copy(*mf, *cached, 0, 0, 1, ngrow);
+            return mf;
+        }
         FillPatch(*this,*mf,ngrow,time,index,scomp,1,0);
     }
     else if (const DeriveRec* rec = derive_lst.get(name))
@@ -1619,6 +1626,15 @@ AmrLevel::derive (const std::string& name, Real time, int ngrow)
         BoxArray dstBA(srcBA);
         dstBA.convert(rec->deriveType());
 
+        const int dncomp = rec->numDerive();
+        mf.reset(new MultiFab(dstBA, dmap, dncomp, ngrow, MFInfo(), *m_factory));
+
+        if (const MultiFab* cached = cachedDerive(name, time, *mf))
+        {
+            MultiFab::Copy(*mf, *cached, 0, 0, dncomp, ngrow);
+            return mf;
+        }
+
 	int ngrow_src = ngrow;
 	{
 	    Box bx0 = srcBA[0];
@@ -1627,16 +1643,8 @@ AmrLevel::derive (const std::string& name, Real time, int ngrow)
 	    ngrow_src += g;
 	}
 
-        MultiFab srcMF(srcBA, dmap, rec->numState(), ngrow_src, MFInfo(), *m_factory);
-
-        for (int k = 0, dc = 0; k < rec->numRange(); k++, dc += ncomp)
-        {
-            rec->getRange(k, index, scomp, ncomp);
-            FillPatch(*this,srcMF,ngrow_src,time,index,scomp,ncomp,dc);
-        }
-
-        const int dncomp = rec->numDerive();
-        mf.reset(new MultiFab(dstBA, dmap, dncomp, ngrow, MFInfo(), *m_factory));
+        std::shared_ptr<MultiFab> src = deriveSource(*rec, time, ngrow_src);
+        MultiFab& srcMF = *src;
 
         if (rec->derFuncFab() != nullptr)
         {
@@ -1748,6 +1756,8 @@ AmrLevel::derive (const std::string& name, Real time, int ngrow)
         amrex::Error(msg.c_str());
     }
 
+    cacheDerive(name, time, *mf, 0, mf->nComp());
+
     return mf;
 }
 
@@ -1758,11 +1768,18 @@ AmrLevel::derive (const std::string& name, Real time, MultiFab& mf, int dcomp)
 
     const int ngrow = mf.nGrow();
 
+    if (const MultiFab* cached = cachedDerive(name, time, mf))
+    {
+        MultiFab::Copy(mf, *cached, 0, dcomp, cached->nComp(), ngrow);
+        return;
+    }
+
     int index, scomp, ncomp;
 
     if (isStateVariable(name,index,scomp))
     {
         FillPatch(*this,mf,ngrow,time,index,scomp,1,dcomp);
+        cacheDerive(name, time, mf, dcomp, 1);
     }
     else if (const DeriveRec* rec = derive_lst.get(name))
     {
@@ -1778,14 +1795,8 @@ AmrLevel::derive (const std::string& name, Real time, MultiFab& mf, int dcomp)
 	    ngrow_src += g;
 	}
 
-        MultiFab srcMF(srcBA,dmap,rec->numState(),ngrow_src, MFInfo(), *m_factory);
-
-        for (int k = 0, dc = 0; k < rec->numRange(); k++, dc += ncomp)
-        {
-            rec->getRange(k,index,scomp,ncomp);
-
-            FillPatch(*this,srcMF,ngrow_src,time,index,scomp,ncomp,dc);
-        }
+        std::shared_ptr<MultiFab> src = deriveSource(*rec, time, ngrow_src);
+        MultiFab& srcMF = *src;
 
         if (rec->derFuncFab() != nullptr)
         {
@@ -1886,6 +1897,8 @@ AmrLevel::derive (const std::string& name, Real time, MultiFab& mf, int dcomp)
         }
 #endif
         }
+
+        cacheDerive(name, time, mf, dcomp, rec->numDerive());
     }
     else
     {
@@ -1898,6 +1911,97 @@ AmrLevel::derive (const std::string& name, Real time, MultiFab& mf, int dcomp)
     }
 }
 
+bool
+AmrLevel::checkDeriveCache ()
+{
+    if (!derive_cache) return false;
+
+    if (m_derive_cache_generation != derive_cache_generation ||
+        m_derive_state_generation != StateData::Generation())
+    {
+        m_derive_cache.clear();
+        m_derive_source_cache.clear();
+        m_derive_cache_generation = derive_cache_generation;
+        m_derive_state_generation = StateData::Generation();
+    }
+    return true;
+}
+
+const MultiFab*
+AmrLevel::cachedDerive (const std::string& name, Real time, const MultiFab& mf)
+{
+    if (!checkDeriveCache()) return nullptr;
+
+    auto it = m_derive_cache.find(std::make_tuple(name, time, mf.nGrow()));
+    if (it == m_derive_cache.end()) return nullptr;
+
+    // The data may have been derived on other grids.
+    const MultiFab& cached = *it->second;
+    if (cached.boxArray() != mf.boxArray() || cached.DistributionMap() != mf.DistributionMap()) {
+        return nullptr;
+    }
+    return &cached;
+}
+
+void
+AmrLevel::cacheDerive (const std::string& name, Real time,
+                       const MultiFab& mf, int dcomp, int ncomp)
+{
+    if (!checkDeriveCache()) return;
+
+    const int ngrow = mf.nGrow();
+    std::unique_ptr<MultiFab> c(new MultiFab(mf.boxArray(), mf.DistributionMap(), ncomp, ngrow,
+                                             MFInfo(), mf.Factory()));
+    MultiFab::Copy(*c, mf, dcomp, 0, ncomp, ngrow);
+    m_derive_cache[std::make_tuple(name, time, ngrow)] = std::move(c);
+}
+
+std::shared_ptr<MultiFab>
+AmrLevel::deriveSource (const DeriveRec& rec, Real time, int ngrow)
+{
+    //
+    // The source is identified by the state components it is made of, so
+    // derived quantities with the same sources share one FillPatch.
+    //
+    std::vector<int> ranges;
+    int index, scomp, ncomp;
+    for (int k = 0; k < rec.numRange(); k++)
+    {
+        rec.getRange(k, index, scomp, ncomp);
+        ranges.push_back(index);
+        ranges.push_back(scomp);
+        ranges.push_back(ncomp);
+    }
+    const auto key = std::make_pair(ranges, time);
+
+    const bool use_cache = checkDeriveCache();
+    if (use_cache)
+    {
+        auto it = m_derive_source_cache.find(key);
+        if (it != m_derive_source_cache.end() && it->second->nGrow() >= ngrow) {
+            return it->second;
+        }
+    }
+
+    rec.getRange(0, index, scomp, ncomp);
+
+    std::shared_ptr<MultiFab> src = std::make_shared<MultiFab>(state[index].boxArray(), dmap,
+                                                               rec.numState(), ngrow,
+                                                               MFInfo(), *m_factory);
+
+    for (int k = 0, dc = 0; k < rec.numRange(); k++, dc += ncomp)
+    {
+        rec.getRange(k, index, scomp, ncomp);
+        FillPatch(*this,*src,ngrow,time,index,scomp,ncomp,dc);
+    }
+
+    if (use_cache) {
+        m_derive_source_cache[key] = src;
+    }
+
+    return src;
+}
+
 //! Update the distribution maps in StateData based on the size of the map
 void
 AmrLevel::UpdateDistributionMaps ( DistributionMapping& update_dmap )
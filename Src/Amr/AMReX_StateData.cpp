@@ -23,6 +23,7 @@ static constexpr int MFOLDDATA = 1;
 
 Vector<std::string> StateData::fabArrayHeaderNames;
 std::map<std::string, Vector<char> > *StateData::faHeaderMap;
+int StateData::generation = 0;
 
 
 StateData::StateData () 
@@ -302,6 +303,7 @@ StateData::getBC (int comp, int i) const noexcept
 void
 StateData::setOldTimeLevel (Real time)
 {
+    ++generation;
     if (desc->timeType() == StateDescriptor::Point)
     {
         old_time.start = old_time.stop = time;
@@ -315,6 +317,7 @@ StateData::setOldTimeLevel (Real time)
 void
 StateData::setNewTimeLevel (Real time)
 {
+    ++generation;
     if (desc->timeType() == StateDescriptor::Point)
     {
         new_time.start = new_time.stop = time;
@@ -347,6 +350,7 @@ StateData::setTimeLevel (Real time,
                          Real dt_old,
                          Real dt_new)
 {
+    ++generation;
     if (desc->timeType() == StateDescriptor::Point)
     {
         new_time.start = new_time.stop = time;
@@ -364,6 +368,7 @@ StateData::setTimeLevel (Real time,
 void
 StateData::swapTimeLevels (Real dt)
 {
+    ++generation;
     old_time = new_time;
     if (desc->timeType() == StateDescriptor::Point)
     {
@@ -381,6 +386,7 @@ StateData::swapTimeLevels (Real dt)
 void
 StateData::replaceOldData (MultiFab&& mf)
 {
+    ++generation;
     old_data.reset(new MultiFab(std::move(mf)));
 }
 
@@ -389,12 +395,14 @@ StateData::replaceOldData (MultiFab&& mf)
 void
 StateData::replaceOldData (StateData& s)
 {
+    ++generation;
     std::swap(old_data, s.old_data);
 }
 
 void
 StateData::replaceNewData (MultiFab&& mf)
 {
+    ++generation;
     new_data.reset(new MultiFab(std::move(mf)));
 }
 
@@ -403,6 +411,7 @@ StateData::replaceNewData (MultiFab&& mf)
 void
 StateData::replaceNewData (StateData& s)
 {
+    ++generation;
     std::swap(new_data, s.new_data);
 }
 
@@ -86,12 +86,42 @@ FluxRegister::define (const BoxArray&            fine_boxes,
         BndryRegister::define(lo_face,typ,0,1,0,nvar,dm);
         BndryRegister::define(hi_face,typ,0,1,0,nvar,dm);
     }
+
+    //
+    // Combined layout of the registers of all faces, shifted onto the coarse
+    // cells they correct.  It is kept for the life of the FluxRegister so
+    // the communication metadata of Reflux is cached.
+    //
+    const int nfine = grids.size();
+    const Vector<int>& pmap = dm.ProcessorMap();
+
+    Vector<Box> reflux_bxs;
+    Vector<int> reflux_pmap;
+    reflux_bxs.reserve(2*AMREX_SPACEDIM*nfine);
+    reflux_pmap.reserve(2*AMREX_SPACEDIM*nfine);
+    for (OrientationIter fi; fi; ++fi)
+    {
+        const Orientation face = fi();
+        const BoxArray& ba = bndry[face].boxArray();
+        for (int i = 0; i < nfine; ++i) {
+            // The register on a low face corrects the cell below the face.
+            const Box& fbx = ba[i];
+            Box bx(fbx.smallEnd(), fbx.bigEnd());
+            if (face.isLow()) bx.shift(face.coordDir(), -1);
+            reflux_bxs.push_back(bx);
+        }
+        reflux_pmap.insert(reflux_pmap.end(), pmap.begin(), pmap.end());
+    }
+    reflux_grids = BoxArray(BoxList(std::move(reflux_bxs)));
+    reflux_dmap = DistributionMapping(std::move(reflux_pmap));
 }
 
 void
 FluxRegister::clear ()
 {
     BndryRegister::clear();
+    reflux_grids.clear();
+    reflux_dmap = DistributionMapping();
 }
 
 FluxRegister::~FluxRegister () {}
@@ -452,10 +482,56 @@ FluxRegister::Reflux (MultiFab&       mf,
 		      int             nc,
 		      const Geometry& geom)
 {
-    for (OrientationIter fi; fi; ++fi)
+    BL_PROFILE("FluxRegister::Reflux()");
+
+    //
+    // Gather the registers of all faces, with the sign of their correction,
+    // onto the coarse cells they correct and sum them with one parallel add.
+    //
+    MultiFab corr(reflux_grids, reflux_dmap, nc, 0);
+
+    const int nfine = grids.size();
+    int iface = 0;
+    for (OrientationIter fi; fi; ++fi, ++iface)
     {
-	const Orientation& face = fi();
-        Reflux(mf, volume, face, scale, scomp, dcomp, nc, geom);
+        const Orientation face = fi();
+        const FabSet& fs = bndry[face];
+        const Dim3 iv = (face.isLow() ? IntVect::TheDimensionVector(face.coordDir())
+                                      : IntVect::TheZeroVector()).dim3();
+        const Real sign = face.isLow() ? -1.0 : 1.0;
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (FabSetIter fsi(fs); fsi.isValid(); ++fsi)
+        {
+            const int K = iface*nfine + fsi.index();
+            const Box& bx = corr.box(K);
+            auto const sfab = fs.array(fsi);
+            auto       dfab = corr.array(K);
+            AMREX_HOST_DEVICE_FOR_4D (bx, nc, i, j, k, n,
+            {
+                dfab(i,j,k,n) = sign*sfab(i+iv.x,j+iv.y,k+iv.z,n+scomp);
+            });
+        }
+    }
+
+    MultiFab fsum(mf.boxArray(), mf.DistributionMap(), nc, 0, MFInfo(), mf.Factory());
+    fsum.setVal(0.0);
+    fsum.ParallelAdd(corr, 0, 0, nc, geom.periodicity());
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(mf,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        Array4<Real> const& sfab = mf.array(mfi);
+        Array4<Real const> const& ffab = fsum.const_array(mfi);
+        Array4<Real const> const& vfab = volume.const_array(mfi);
+        AMREX_HOST_DEVICE_FOR_4D (bx, nc, i, j, k, n,
+        {
+            sfab(i,j,k,n+dcomp) += scale*ffab(i,j,k,n)/vfab(i,j,k);
+        });
     }
 }
 
@@ -1,6 +1,7 @@
 
 #include <climits>
 
+#include <AMReX_BoxList.H>
 #include <AMReX_FArrayBox.H>
 #include <AMReX_Geometry.H>
 #include <AMReX_Interpolater.H>
@@ -12,14 +13,20 @@ namespace amrex {
 //
 // PCInterp, NodeBilinear, and CellConservativeLinear are supported for all dimensions on cpu and gpu.
 //
-// CellConsertiveProtected only works in 2D and 3D on cpu.
+// CellConsertiveProtected works in 2D and 3D on cpu and gpu.
 //
 // CellBilinear works in 1D, 2D and 3D on cpu.
 //
-// CellQuadratic only works in 2D on cpu.
+// CellQuadratic only works in 2D on cpu and gpu.
+//
+// On cpu, NodeBilinear, CellConservativeLinear and CellQuadratic work through
+// the coarse region in cache blocks so that the slopes of all components are
+// computed and consumed while they are still in cache.
 //
 // CellConservativeQuartic only works with ref ratio of 2 on cpu
 //
+// CellConservativePPM is supported for all dimensions on cpu and gpu.
+//
 
 //
 // CONSTRUCT A GLOBAL OBJECT OF EACH VERSION.
@@ -32,6 +39,21 @@ CellConservativeLinear    lincc_interp;
 CellConservativeLinear    cell_cons_interp(0);
 CellConservativeProtected protected_interp;
 CellConservativeQuartic   quartic_interp;
+CellConservativePPM       ppm_interp;
+
+namespace {
+    // Size of the coarse blocks used by the cpu kernels.  Whole rows are
+    // kept in x so that the inner loops vectorize.
+    const IntVect interp_block_size(AMREX_D_DECL(1024000,4,4));
+
+    BoxList
+    interp_blocks (const Box& cbx)
+    {
+        BoxList bl(cbx);
+        bl.maxSize(interp_block_size);
+        return bl;
+    }
+}
 
 Interpolater::~Interpolater () {}
 
@@ -116,23 +138,49 @@ NodeBilinear::interp (const FArrayBox&  crse,
 
     int num_slope  = ncomp*(AMREX_D_TERM(2,*2,*2)-1);
     const Box cslope_bx = amrex::enclosedCells(CoarseBox(fine_region, ratio));
-    FArrayBox slopefab(cslope_bx, num_slope);
-    Elixir slopeeli;
-    if (run_on_gpu) slopeeli = slopefab.elixir();
 
     Array4<Real const> const& crsearr = crse.const_array();
     Array4<Real> const& finearr = fine.array();
-    Array4<Real> const& slopearr = slopefab.array();
 
-    AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, cslope_bx, tbx,
+    if (run_on_gpu)
     {
-        amrex::nodebilin_slopes(tbx, slopearr, crsearr, crse_comp, ncomp, ratio);
-    });
+        FArrayBox slopefab(cslope_bx, num_slope);
+        Elixir slopeeli = slopefab.elixir();
+        Array4<Real> const& slopearr = slopefab.array();
 
-    AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, fine_region, tbx,
+        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, cslope_bx, tbx,
+        {
+            amrex::nodebilin_slopes(tbx, slopearr, crsearr, crse_comp, ncomp, ratio);
+        });
+
+        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, fine_region, tbx,
+        {
+            amrex::nodebilin_interp(tbx, finearr, fine_comp, ncomp, slopearr, crsearr, crse_comp, ratio);
+        });
+    }
+    else
     {
-        amrex::nodebilin_interp(tbx, finearr, fine_comp, ncomp, slopearr, crsearr, crse_comp, ratio);
-    });
+        FArrayBox slopefab;
+        for (const Box& cbx : interp_blocks(cslope_bx))
+        {
+            // Each block owns the fine nodes from its low coarse node up to,
+            // but not including, its high coarse node, except at the high
+            // end of cslope_bx where the remaining nodes are included.
+            IntVect flo = cbx.smallEnd() * ratio;
+            IntVect fhi = (cbx.bigEnd() + 1) * ratio;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                if (cbx.bigEnd(idim) < cslope_bx.bigEnd(idim)) fhi[idim] -= 1;
+            }
+            const Box& fbx = Box(flo, fhi, IndexType::TheNodeType()) & fine_region;
+            if (!fbx.ok()) continue;
+
+            slopefab.resize(cbx, num_slope);
+            Array4<Real> const& slopearr = slopefab.array();
+
+            amrex::nodebilin_slopes(cbx, slopearr, crsearr, crse_comp, ncomp, ratio);
+            amrex::nodebilin_interp(fbx, finearr, fine_comp, ncomp, slopearr, crsearr, crse_comp, ratio);
+        }
+    }
 }
 
 CellBilinear::~CellBilinear () {}
@@ -288,9 +336,6 @@ CellConservativeLinear::interp (const FArrayBox& crse,
     const Box& crse_region = CoarseBox(fine_region,ratio);
     const Box& cslope_bx = amrex::grow(crse_region,-1);
 
-    AsyncArray<BCRec> async_bcr(bcr.data(), (run_on_gpu) ? ncomp : 0);
-    BCRec const* bcrp = (run_on_gpu) ? async_bcr.data() : bcr.data();
-
     // component of ccfab : slopes for first compoent for x-direction
     //                      slopes for second component for x-direction
     //                      ...
@@ -301,54 +346,90 @@ CellConservativeLinear::interp (const FArrayBox& crse,
     //      lin_lim = true : factors (one for all components) for x, y and z-direction
     //      lin_lim = false: min for every component followed by max for every component
     const int ntmp = do_linear_limiting ? (ncomp+1)*AMREX_SPACEDIM : ncomp*(AMREX_SPACEDIM+2);
-    FArrayBox ccfab(cslope_bx, ntmp);
-    Elixir cceli;
-    if (run_on_gpu) cceli = ccfab.elixir();
-    Array4<Real> const& ccarr = ccfab.array();
-
-    const Vector<Real>& vec_voff = amrex::ccinterp_compute_voff(cslope_bx, ratio, crse_geom, fine_geom);
 
-    AsyncArray<Real> async_voff(vec_voff.data(), (run_on_gpu) ? vec_voff.size() : 0);
-    Real const* voff = (run_on_gpu) ? async_voff.data() : vec_voff.data();
-
-    if (do_linear_limiting) {
-        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG ( run_on_gpu, cslope_bx, tbx,
+    if (run_on_gpu)
+    {
+        AsyncArray<BCRec> async_bcr(bcr.data(), ncomp);
+        BCRec const* bcrp = async_bcr.data();
+
+        FArrayBox ccfab(cslope_bx, ntmp);
+        Elixir cceli = ccfab.elixir();
+        Array4<Real> const& ccarr = ccfab.array();
+
+        const Vector<Real>& vec_voff = amrex::ccinterp_compute_voff(cslope_bx, ratio, crse_geom, fine_geom);
+
+        AsyncArray<Real> async_voff(vec_voff.data(), vec_voff.size());
+        Real const* voff = async_voff.data();
+
+        if (do_linear_limiting) {
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG ( run_on_gpu, cslope_bx, tbx,
+            {
+                amrex::cellconslin_slopes_linlim(tbx, ccarr, crsearr, crse_comp, ncomp, bcrp, cslope_bx);
+            });
+
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG ( run_on_gpu, fine_region, tbx,
+            {
+                amrex::cellconslin_interp(tbx, finearr, fine_comp, ncomp, ccarr, crsearr, crse_comp,
+                                          voff, ratio);
+            });
+        } else {
+            const Box& fslope_bx = amrex::refine(cslope_bx,ratio);
+            FArrayBox fafab(fslope_bx, ncomp);
+            Elixir faeli = fafab.elixir();
+            Array4<Real> const& faarr = fafab.array();
+
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, cslope_bx, tbx,
+            {
+                amrex::cellconslin_slopes_mclim(tbx, ccarr, crsearr, crse_comp, ncomp, bcrp, cslope_bx);
+            });
+
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, fslope_bx, tbx,
+            {
+                amrex::cellconslin_fine_alpha(tbx, faarr, ccarr, ncomp, voff, ratio);
+            });
+
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, cslope_bx, tbx,
+            {
+                amrex::cellconslin_slopes_mmlim(tbx, ccarr, faarr, ncomp, ratio);
+            });
+
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, fine_region, tbx,
+            {
+                amrex::cellconslin_interp(tbx, finearr, fine_comp, ncomp, ccarr, crsearr, crse_comp,
+                                          voff, ratio);
+            });
+        }
+    }
+    else
+    {
+        BCRec const* bcrp = bcr.data();
+        FArrayBox ccfab, fafab;
+        for (const Box& cbx : interp_blocks(cslope_bx))
         {
-            amrex::cellconslin_slopes_linlim(tbx, ccarr, crsearr, crse_comp, ncomp, bcrp);
-        });
+            const Box& fbx = amrex::refine(cbx,ratio) & fine_region;
+            if (!fbx.ok()) continue;
 
-        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG ( run_on_gpu, fine_region, tbx,
-        {
-            amrex::cellconslin_interp(tbx, finearr, fine_comp, ncomp, ccarr, crsearr, crse_comp,
-                                      voff, ratio);
-        });
-    } else {
-        const Box& fslope_bx = amrex::refine(cslope_bx,ratio);
-        FArrayBox fafab(fslope_bx, ncomp);
-        Elixir faeli;
-        if (run_on_gpu) faeli = fafab.elixir();
-        Array4<Real> const& faarr = fafab.array();
+            ccfab.resize(cbx, ntmp);
+            Array4<Real> const& ccarr = ccfab.array();
 
-        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, cslope_bx, tbx,
-        {
-            amrex::cellconslin_slopes_mclim(tbx, ccarr, crsearr, crse_comp, ncomp, bcrp);
-        });
+            const Vector<Real>& vec_voff = amrex::ccinterp_compute_voff(cbx, ratio, crse_geom, fine_geom);
+            Real const* voff = vec_voff.data();
 
-        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, fslope_bx, tbx,
-        {
-            amrex::cellconslin_fine_alpha(tbx, faarr, ccarr, ncomp, voff, ratio);
-        });
+            if (do_linear_limiting) {
+                amrex::cellconslin_slopes_linlim(cbx, ccarr, crsearr, crse_comp, ncomp, bcrp, cslope_bx);
+            } else {
+                const Box& fslope_bx = amrex::refine(cbx,ratio);
+                fafab.resize(fslope_bx, ncomp);
+                Array4<Real> const& faarr = fafab.array();
 
-        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, cslope_bx, tbx,
-        {
-            amrex::cellconslin_slopes_mmlim(tbx, ccarr, faarr, ncomp, ratio);
-        });
+                amrex::cellconslin_slopes_mclim(cbx, ccarr, crsearr, crse_comp, ncomp, bcrp, cslope_bx);
+                amrex::cellconslin_fine_alpha(fslope_bx, faarr, ccarr, ncomp, voff, ratio);
+                amrex::cellconslin_slopes_mmlim(cbx, ccarr, faarr, ncomp, ratio);
+            }
 
-        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, fine_region, tbx,
-        {
-            amrex::cellconslin_interp(tbx, finearr, fine_comp, ncomp, ccarr, crsearr, crse_comp,
+            amrex::cellconslin_interp(fbx, finearr, fine_comp, ncomp, ccarr, crsearr, crse_comp,
                                       voff, ratio);
-        });
+        }
     }
 }
 
@@ -388,95 +469,77 @@ CellQuadratic::interp (const FArrayBox& crse,
                        const Geometry&  crse_geom,
                        const Geometry&  fine_geom,
                        Vector<BCRec> const&  bcr,
-                       int              actual_comp,
-                       int              actual_state,
+                       int              /*actual_comp*/,
+                       int              /*actual_state*/,
                        RunOn            runon)
 {
     BL_PROFILE("CellQuadratic::interp()");
     BL_ASSERT(bcr.size() >= ncomp);
+
+#if (AMREX_SPACEDIM == 2)
     //
     // Make box which is intersection of fine_region and domain of fine.
     //
     Box target_fine_region = fine_region & fine.box();
 
-    Box crse_bx(amrex::coarsen(target_fine_region,ratio));
-    Box fslope_bx(amrex::refine(crse_bx,ratio));
-    Box cslope_bx(crse_bx);
-    cslope_bx.grow(1);
-    BL_ASSERT(crse.box().contains(cslope_bx));
-    //
-    // Alloc temp space for coarse grid slopes: here we use 5
-    // instead of AMREX_SPACEDIM because of the x^2, y^2 and xy terms
-    //
-    long t_long = cslope_bx.numPts();
-    BL_ASSERT(t_long < INT_MAX);
-    int c_len = int(t_long);
-
-    Vector<Real> cslope(5*c_len);
+    const Box& cslope_bx = amrex::coarsen(target_fine_region,ratio);
+    BL_ASSERT(crse.box().contains(amrex::grow(cslope_bx,1)));
 
-    int loslp = cslope_bx.index(crse_bx.smallEnd());
-    int hislp = cslope_bx.index(crse_bx.bigEnd());
+    bool run_on_gpu = (runon == RunOn::Gpu && Gpu::inLaunchRegion());
 
-    t_long = cslope_bx.numPts();
-    BL_ASSERT(t_long < INT_MAX);
-    int cslope_vol = int(t_long);
-    int clo        = 1 - loslp;
-    int chi        = clo + cslope_vol - 1;
-    c_len          = hislp - loslp + 1;
-    //
-    // Alloc temp space for one strip of fine grid slopes: here we use 5
-    // instead of AMREX_SPACEDIM because of the x^2, y^2 and xy terms.
-    //
-    int dir;
-    int f_len = fslope_bx.longside(dir);
+    Array4<Real const> const& crsearr = crse.const_array();
+    Array4<Real> const& finearr = fine.array();
 
-    Vector<Real> strip((5+2)*f_len);
+    // component of slopefab : x, y, xx, yy and xy slopes for every component
+    const int nslope = 5*ncomp;
 
-    Real* fstrip = strip.dataPtr();
-    Real* foff   = fstrip + f_len;
-    Real* fslope = foff + f_len;
-    //
-    // Get coarse and fine edge-centered volume coordinates.
-    //
-    Vector<Real> fvc[AMREX_SPACEDIM];
-    Vector<Real> cvc[AMREX_SPACEDIM];
-    for (dir = 0; dir < AMREX_SPACEDIM; dir++)
+    if (run_on_gpu)
     {
-        fine_geom.GetEdgeVolCoord(fvc[dir],target_fine_region,dir);
-        crse_geom.GetEdgeVolCoord(cvc[dir],crse_bx,dir);
+        AsyncArray<BCRec> async_bcr(bcr.data(), ncomp);
+        BCRec const* bcrp = async_bcr.data();
+
+        FArrayBox slopefab(cslope_bx, nslope);
+        Elixir slopeeli = slopefab.elixir();
+        Array4<Real> const& slopearr = slopefab.array();
+
+        const Vector<Real>& vec_voff = amrex::ccinterp_compute_voff(cslope_bx, ratio, crse_geom, fine_geom);
+
+        AsyncArray<Real> async_voff(vec_voff.data(), vec_voff.size());
+        Real const* voff = async_voff.data();
+
+        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, cslope_bx, tbx,
+        {
+            amrex::cellquad_slopes(tbx, slopearr, crsearr, crse_comp, ncomp, bcrp, cslope_bx);
+        });
+
+        AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, target_fine_region, tbx,
+        {
+            amrex::cellquad_interp(tbx, finearr, fine_comp, ncomp, slopearr, crsearr, crse_comp,
+                                   voff, ratio);
+        });
     }
-    //
-    // Alloc tmp space for slope calc and to allow for vectorization.
-    //
-    Real* fdat        = fine.dataPtr(fine_comp);
-    const Real* cdat  = crse.dataPtr(crse_comp);
-    const int* flo    = fine.loVect();
-    const int* fhi    = fine.hiVect();
-    const int* fblo   = target_fine_region.loVect();
-    const int* fbhi   = target_fine_region.hiVect();
-    const int* cblo   = crse_bx.loVect();
-    const int* cbhi   = crse_bx.hiVect();
-    const int* fslo   = fslope_bx.loVect();
-    const int* fshi   = fslope_bx.hiVect();
-    int slope_flag    = (do_limited_slope ? 1 : 0);
-    Vector<int> bc     = GetBCArray(bcr);
-    const int* ratioV = ratio.getVect();
+    else
+    {
+        BCRec const* bcrp = bcr.data();
+        FArrayBox slopefab;
+        for (const Box& cbx : interp_blocks(cslope_bx))
+        {
+            const Box& fbx = amrex::refine(cbx,ratio) & target_fine_region;
+            if (!fbx.ok()) continue;
 
-#if (AMREX_SPACEDIM > 1)
+            slopefab.resize(cbx, nslope);
+            Array4<Real> const& slopearr = slopefab.array();
 
-    amrex_cqinterp (fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),
-                   AMREX_ARLIM(fblo), AMREX_ARLIM(fbhi),
-                   &ncomp,AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
-                   cdat,&clo,&chi,
-                   AMREX_ARLIM(cblo), AMREX_ARLIM(cbhi),
-                   fslo,fshi,
-                   cslope.dataPtr(),&c_len,fslope,fstrip,&f_len,foff,
-                   bc.dataPtr(), &slope_flag,
-                   AMREX_D_DECL(fvc[0].dataPtr(),fvc[1].dataPtr(),fvc[2].dataPtr()),
-                   AMREX_D_DECL(cvc[0].dataPtr(),cvc[1].dataPtr(),cvc[2].dataPtr()),
-                   &actual_comp,&actual_state);
+            const Vector<Real>& vec_voff = amrex::ccinterp_compute_voff(cbx, ratio, crse_geom, fine_geom);
 
-#endif /*(AMREX_SPACEDIM > 1)*/
+            amrex::cellquad_slopes(cbx, slopearr, crsearr, crse_comp, ncomp, bcrp, cslope_bx);
+            amrex::cellquad_interp(fbx, finearr, fine_comp, ncomp, slopearr, crsearr, crse_comp,
+                                   vec_voff.data(), ratio);
+        }
+    }
+#elif (AMREX_SPACEDIM == 3)
+    amrex::Abort("CellQuadratic::interp: not implemented in 3D");
+#endif
 }
 
 PCInterp::~PCInterp () {}
@@ -596,7 +659,7 @@ CellConservativeProtected::interp (const FArrayBox& crse,
 
     AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, cslope_bx, tbx,
     {
-        amrex::cellconslin_slopes_linlim(tbx, ccarr, crsearr, crse_comp, ncomp, bcrp);
+        amrex::cellconslin_slopes_linlim(tbx, ccarr, crsearr, crse_comp, ncomp, bcrp, cslope_bx);
     });
 
     AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, fine_region, tbx,
@@ -607,8 +670,8 @@ CellConservativeProtected::interp (const FArrayBox& crse,
 }
 
 void
-CellConservativeProtected::protect (const FArrayBox& crse,
-                                    int              crse_comp,
+CellConservativeProtected::protect (const FArrayBox& /*crse*/,
+                                    int              /*crse_comp*/,
                                     FArrayBox&       fine,
                                     int              fine_comp,
                                     FArrayBox&       fine_state,
@@ -624,84 +687,54 @@ CellConservativeProtected::protect (const FArrayBox& crse,
     BL_PROFILE("CellConservativeProtected::protect()");
     BL_ASSERT(bcr.size() >= ncomp);
 
+#if (AMREX_SPACEDIM > 1)
     //
     // Make box which is intersection of fine_region and domain of fine.
     //
     Box target_fine_region = fine_region & fine.box();
 
-    //
-    // crse_bx is coarsening of target_fine_region, grown by 1.
-    //
-    Box crse_bx = CoarseBox(target_fine_region,ratio);
-
     //
     // cs_bx is coarsening of target_fine_region.
     //
-    Box cs_bx(crse_bx);
-    cs_bx.grow(-1);
+    const Box& cs_bx = amrex::coarsen(target_fine_region,ratio);
+    const Box& fine_bx = fine.box();
+
+    Array4<Real> const& finearr = fine.array();
+    Array4<Real const> const& statearr = fine_state.const_array();
 
+#if (AMREX_SPACEDIM == 2)
     //
     // Get coarse and fine edge-centered volume coordinates.
     //
-    int dir;
-    Vector<Real> fvc[AMREX_SPACEDIM];
-    Vector<Real> cvc[AMREX_SPACEDIM];
-    for (dir = 0; dir < AMREX_SPACEDIM; dir++)
+    const Box& fvbx = amrex::refine(cs_bx,ratio) & fine_bx;
+    Vector<Real> vec_fvc, vec_cvc, vc;
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++)
     {
-        fine_geom.GetEdgeVolCoord(fvc[dir],target_fine_region,dir);
-        crse_geom.GetEdgeVolCoord(cvc[dir],crse_bx,dir);
+        fine_geom.GetEdgeVolCoord(vc,fvbx,dir);
+        vec_fvc.insert(vec_fvc.end(), vc.begin(), vc.end());
+        crse_geom.GetEdgeVolCoord(vc,cs_bx,dir);
+        vec_cvc.insert(vec_cvc.end(), vc.begin(), vc.end());
     }
 
-#if (AMREX_SPACEDIM == 2)
-    const int* cvcblo = crse_bx.loVect();
-    const int* fvcblo = target_fine_region.loVect();
-
-    int cvcbhi[AMREX_SPACEDIM];
-    int fvcbhi[AMREX_SPACEDIM];
+    const bool run_on_gpu = (runon == RunOn::Gpu && Gpu::inLaunchRegion());
+    AsyncArray<Real> async_fvc(vec_fvc.data(), (run_on_gpu) ? vec_fvc.size() : 0);
+    AsyncArray<Real> async_cvc(vec_cvc.data(), (run_on_gpu) ? vec_cvc.size() : 0);
+    Real const* fvc = (run_on_gpu) ? async_fvc.data() : vec_fvc.data();
+    Real const* cvc = (run_on_gpu) ? async_cvc.data() : vec_cvc.data();
 
-    for (dir=0; dir<AMREX_SPACEDIM; dir++)
+    AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, cs_bx, tbx,
     {
-        cvcbhi[dir] = cvcblo[dir] + cvc[dir].size() - 1;
-        fvcbhi[dir] = fvcblo[dir] + fvc[dir].size() - 1;
-    }
-#endif
-
-    Real* fdat       = fine.dataPtr(fine_comp);
-    Real* state_dat  = fine_state.dataPtr(state_comp);
-    const Real* cdat = crse.dataPtr(crse_comp);
-
-    const int* flo    = fine.loVect();
-    const int* fhi    = fine.hiVect();
-    const int* slo    = fine_state.loVect();
-    const int* shi    = fine_state.hiVect();
-    const int* clo    = crse.loVect();
-    const int* chi    = crse.hiVect();
-    const int* fblo   = target_fine_region.loVect();
-    const int* fbhi   = target_fine_region.hiVect();
-    const int* csbhi  = cs_bx.hiVect();
-    const int* csblo  = cs_bx.loVect();
-
-    Vector<int> bc     = GetBCArray(bcr);
-    const int* ratioV = ratio.getVect();
-
-#if (AMREX_SPACEDIM > 1)
-
-    amrex_protect_interp (fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),
-                         fblo, fbhi,
-                         cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),
-                         csblo, csbhi,
-#if (AMREX_SPACEDIM == 2)
-                         fvc[0].dataPtr(),fvc[1].dataPtr(),
-                         AMREX_ARLIM(fvcblo), AMREX_ARLIM(fvcbhi),
-                         cvc[0].dataPtr(),cvc[1].dataPtr(),
-                         AMREX_ARLIM(cvcblo), AMREX_ARLIM(cvcbhi),
+        amrex::ccprotect_interp(tbx, fine_bx, finearr, fine_comp, statearr, state_comp, ncomp,
+                                fvc, fvbx, cvc, cs_bx, ratio);
+    });
+#else
+    AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (runon == RunOn::Gpu && Gpu::inLaunchRegion(), cs_bx, tbx,
+    {
+        amrex::ccprotect_interp(tbx, fine_bx, finearr, fine_comp, statearr, state_comp, ncomp,
+                                ratio);
+    });
 #endif
-                         state_dat, AMREX_ARLIM(slo), AMREX_ARLIM(shi),
-                         &ncomp,AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
-                         bc.dataPtr());
-
 #endif /*(AMREX_SPACEDIM > 1)*/
-
 }
 
 CellConservativeQuartic::~CellConservativeQuartic () {}
@@ -804,4 +837,95 @@ CellConservativeQuartic::interp (const FArrayBox&  crse,
 		      bc.dataPtr(),&actual_comp,&actual_state);
 }
 
+CellConservativePPM::~CellConservativePPM () {}
+
+Box
+CellConservativePPM::CoarseBox (const Box& fine,
+                                int        ratio)
+{
+    Box crse(amrex::coarsen(fine,ratio));
+    crse.grow(2);
+    return crse;
+}
+
+Box
+CellConservativePPM::CoarseBox (const Box&     fine,
+                                const IntVect& ratio)
+{
+    Box crse = amrex::coarsen(fine,ratio);
+    crse.grow(2);
+    return crse;
+}
+
+void
+CellConservativePPM::interp (const FArrayBox& crse,
+                             int              crse_comp,
+                             FArrayBox&       fine,
+                             int              fine_comp,
+                             int              ncomp,
+                             const Box&       fine_region,
+                             const IntVect&   ratio,
+                             const Geometry&  crse_geom,
+                             const Geometry&  /*fine_geom*/,
+                             Vector<BCRec> const& bcr,
+                             int              /*actual_comp*/,
+                             int              /*actual_state*/,
+                             RunOn            runon)
+{
+    BL_PROFILE("CellConservativePPM::interp()");
+    BL_ASSERT(bcr.size() >= ncomp);
+
+    AMREX_ASSERT(fine.box().contains(fine_region));
+
+    bool run_on_gpu = (runon == RunOn::Gpu && Gpu::inLaunchRegion());
+
+    const Box& crse_region = CoarseBox(fine_region,ratio);
+    BL_ASSERT(crse.box().contains(crse_region));
+    const Box& cdomain = crse_geom.Domain();
+
+    AsyncArray<BCRec> async_bcr(bcr.data(), (run_on_gpu) ? ncomp : 0);
+    BCRec const* bcrp = (run_on_gpu) ? async_bcr.data() : bcr.data();
+
+    //
+    // Interpolate one direction at a time.  After the sweep in direction
+    // dir the data are fine in directions 0 through dir, and still coarse,
+    // with the ghost cells the later sweeps need, in the others.
+    //
+    FArrayBox tmpfab[AMREX_SPACEDIM];
+    Elixir tmpeli[AMREX_SPACEDIM];
+
+    Array4<Real const> srcarr = crse.const_array();
+    int scomp = crse_comp;
+    Box obx = crse_region;
+
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir)
+    {
+        obx.setRange(dir, fine_region.smallEnd(dir), fine_region.length(dir));
+        const int r = ratio[dir];
+
+        if (dir == AMREX_SPACEDIM-1)
+        {
+            Array4<Real> const& finearr = fine.array();
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, obx, tbx,
+            {
+                amrex::ccppm_interp_dir(tbx, finearr, fine_comp, srcarr, scomp, ncomp,
+                                        dir, r, bcrp, cdomain);
+            });
+        }
+        else
+        {
+            tmpfab[dir].resize(obx, ncomp);
+            if (run_on_gpu) tmpeli[dir] = tmpfab[dir].elixir();
+            Array4<Real> const& tmparr = tmpfab[dir].array();
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG (run_on_gpu, obx, tbx,
+            {
+                amrex::ccppm_interp_dir(tbx, tmparr, 0, srcarr, scomp, ncomp,
+                                        dir, r, bcrp, cdomain);
+            });
+            srcarr = tmparr;
+            scomp = 0;
+        }
+    }
+}
+
 }
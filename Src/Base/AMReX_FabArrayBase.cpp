@@ -1062,6 +1062,21 @@ FabArrayBase::getFB (const IntVect& nghost, const Periodicity& period,
     return *new_fb;
 }
 
+long
+FabArrayBase::numFillBoundarySendPoints (const IntVect& nghost, const Periodicity& period,
+                                         bool cross) const
+{
+    if (nghost == IntVect::TheZeroVector()) return 0;
+    const FB& TheFB = getFB(nghost, period, cross);
+    long npts = 0;
+    for (const auto& kv : *TheFB.m_SndTags) {
+        for (const auto& tag : kv.second) {
+            npts += tag.sbox.numPts();
+        }
+    }
+    return npts;
+}
+
 FabArrayBase::FPinfo::FPinfo (const FabArrayBase& srcfa,
 			      const FabArrayBase& dstfa,
 			      const Box&          dstdomain,
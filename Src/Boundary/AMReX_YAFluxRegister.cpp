@@ -250,13 +250,25 @@ YAFluxRegister::CrseAdd (const MFIter& mfi,
                          const Real* dx, Real dt, RunOn runon) noexcept
 {
     BL_ASSERT(m_crse_data.nComp() == flux[0]->nComp());
+    CrseAdd(mfi, flux, dx, dt, 0, 0, m_ncomp, runon);
+}
+
+
+void
+YAFluxRegister::CrseAdd (const MFIter& mfi,
+                         const std::array<FArrayBox const*, AMREX_SPACEDIM>& flux,
+                         const Real* dx, Real dt, int srccomp, int destcomp, int numcomp,
+                         RunOn runon) noexcept
+{
+    BL_ASSERT(srccomp >= 0 && srccomp+numcomp <= flux[0]->nComp());
+    BL_ASSERT(destcomp >= 0 && destcomp+numcomp <= m_crse_data.nComp());
 
     if (m_crse_fab_flag[mfi.LocalIndex()] == crse_cell) {
         return;  // this coarse fab is not close to fine fabs.
     }
 
     const Box& bx = mfi.tilebox();
-    const int nc = m_crse_data.nComp();
+    const int nc = numcomp;
     AMREX_D_TERM(const Real dtdx = dt/dx[0];,
                  const Real dtdy = dt/dx[1];,
                  const Real dtdz = dt/dx[2];);
@@ -264,12 +276,12 @@ YAFluxRegister::CrseAdd (const MFIter& mfi,
                  FArrayBox const* fy = flux[1];,
                  FArrayBox const* fz = flux[2];);
 
-    auto fab = m_crse_data.array(mfi);
+    Array4<Real> fab(m_crse_data.array(mfi), destcomp);
     auto const flag = m_crse_flag.array(mfi);
 
-    AMREX_D_TERM(Array4<Real const> fxarr = fx->const_array();,
-                 Array4<Real const> fyarr = fy->const_array();,
-                 Array4<Real const> fzarr = fz->const_array(););
+    AMREX_D_TERM(Array4<Real const> fxarr(fx->const_array(), srccomp);,
+                 Array4<Real const> fyarr(fy->const_array(), srccomp);,
+                 Array4<Real const> fzarr(fz->const_array(), srccomp););
 
     bool run_on_gpu = (runon == RunOn::Gpu && Gpu::inLaunchRegion());
     AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG ( run_on_gpu, bx, tbx,
@@ -286,6 +298,18 @@ YAFluxRegister::FineAdd (const MFIter& mfi,
                          const Real* dx, Real dt, RunOn runon) noexcept
 {
     BL_ASSERT(m_cfpatch.nComp() == a_flux[0]->nComp());
+    FineAdd(mfi, a_flux, dx, dt, 0, 0, m_ncomp, runon);
+}
+
+
+void
+YAFluxRegister::FineAdd (const MFIter& mfi,
+                         const std::array<FArrayBox const*, AMREX_SPACEDIM>& a_flux,
+                         const Real* dx, Real dt, int srccomp, int destcomp, int numcomp,
+                         RunOn runon) noexcept
+{
+    BL_ASSERT(srccomp >= 0 && srccomp+numcomp <= a_flux[0]->nComp());
+    BL_ASSERT(destcomp >= 0 && destcomp+numcomp <= m_cfpatch.nComp());
 
     const int li = mfi.LocalIndex();
     Vector<FArrayBox*>& cfp_fabs = m_cfp_fab[li];
@@ -294,7 +318,7 @@ YAFluxRegister::FineAdd (const MFIter& mfi,
     const Box& tbx = mfi.tilebox();
     const Box& bx = amrex::coarsen(tbx, m_ratio);
     const Box& fbx = amrex::refine(bx, m_ratio);
-    const int nc = m_cfpatch.nComp();
+    const int nc = numcomp;
 
     const Real ratio = static_cast<Real>(AMREX_D_TERM(m_ratio[0],*m_ratio[1],*m_ratio[2]));
     std::array<Real,AMREX_SPACEDIM> dtdx{AMREX_D_DECL(dt/(dx[0]*ratio),
@@ -303,17 +327,22 @@ YAFluxRegister::FineAdd (const MFIter& mfi,
     const Dim3 rr = m_ratio.dim3();
 
     std::array<FArrayBox const*,AMREX_SPACEDIM> flux{AMREX_D_DECL(a_flux[0],a_flux[1],a_flux[2])};
+    int fcomp = srccomp;
     bool use_gpu = (runon == RunOn::Gpu) && Gpu::inLaunchRegion();
     std::array<FArrayBox,AMREX_SPACEDIM> ftmp;
+    // A tile that is not aligned with the coarse cells shares them with its
+    // neighbors, so its contribution is added atomically.
+    const bool atomic = (fbx != tbx);
     if (fbx != tbx) {
         AMREX_ASSERT(!use_gpu);
         for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
             const Box& b = amrex::surroundingNodes(fbx,idim);
             ftmp[idim].resize(b,nc);
             ftmp[idim].setVal(0.0);
-            ftmp[idim].copy(*a_flux[idim]);
+            ftmp[idim].copy(*a_flux[idim], srccomp, 0, nc);
             flux[idim] = &ftmp[idim];
         }
+        fcomp = 0;
     }
     
     AMREX_ASSERT(bx.cellCentered());
@@ -330,13 +359,13 @@ YAFluxRegister::FineAdd (const MFIter& mfi,
                 const int side = 0;
                 if (lobx_is.ok())
                 {
-                    auto d = cfp->array();
+                    Array4<Real> d(cfp->array(), destcomp);
                     Real dtdxs = dtdx[idim];
                     int dirside = idim*2+side;
-                    Array4<Real const> farr = f->const_array();
+                    Array4<Real const> farr(f->const_array(), fcomp);
                     AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG(use_gpu, lobx_is, tmpbox,
                     {
-                        yafluxreg_fineadd(tmpbox, d, farr, dtdxs, nc, dirside, rr);
+                        yafluxreg_fineadd(tmpbox, d, farr, dtdxs, nc, dirside, rr, atomic);
                     });
                 }
             }
@@ -345,13 +374,13 @@ YAFluxRegister::FineAdd (const MFIter& mfi,
                 const int side = 1;
                 if (hibx_is.ok())
                 {
-                    auto d = cfp->array();
+                    Array4<Real> d(cfp->array(), destcomp);
                     Real dtdxs = dtdx[idim];
                     int dirside = idim*2+side;
-                    Array4<Real const> farr = f->const_array();
+                    Array4<Real const> farr(f->const_array(), fcomp);
                     AMREX_LAUNCH_HOST_DEVICE_LAMBDA_FLAG(use_gpu, hibx_is, tmpbox,
                     {
-                        yafluxreg_fineadd(tmpbox, d, farr, dtdxs, nc, dirside, rr);
+                        yafluxreg_fineadd(tmpbox, d, farr, dtdxs, nc, dirside, rr, atomic);
                     });
                 }
             }
@@ -14,7 +14,8 @@ namespace
         &amrex::lincc_interp,	         // 4
         &amrex::cell_cons_interp,	 // 5
         &amrex::protected_interp,	 // 6
-        &amrex::quartic_interp           // 7
+        &amrex::quartic_interp,          // 7
+        &amrex::ppm_interp               // 8
     };
 }
 
@@ -10,9 +10,10 @@ MLABecLaplacian::MLABecLaplacian (const Vector<Geometry>& a_geom,
                                   const Vector<BoxArray>& a_grids,
                                   const Vector<DistributionMapping>& a_dmap,
                                   const LPInfo& a_info,
-                                  const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                                  const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                                  const int a_ncomp)
 {
-    define(a_geom, a_grids, a_dmap, a_info, a_factory);
+    define(a_geom, a_grids, a_dmap, a_info, a_factory, a_ncomp);
 }
 
 void
@@ -20,10 +21,13 @@ MLABecLaplacian::define (const Vector<Geometry>& a_geom,
                          const Vector<BoxArray>& a_grids,
                          const Vector<DistributionMapping>& a_dmap,
                          const LPInfo& a_info,
-                         const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                         const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                         const int a_ncomp)
 {
     BL_PROFILE("MLABecLaplacian::define()");
 
+    m_ncomp = a_ncomp;
+
     MLCellABecLap::define(a_geom, a_grids, a_dmap, a_info, a_factory);
 
     const int ncomp = getNComp();
@@ -57,6 +61,7 @@ MLABecLaplacian::~MLABecLaplacian ()
 void
 MLABecLaplacian::setScalars (Real a, Real b) noexcept
 {
+    if (!coeffsChanged(m_a_scalar, a) && !coeffsChanged(m_b_scalar, b)) return;
     m_a_scalar = a;
     m_b_scalar = b;
     if (a == 0.0)
@@ -71,6 +76,7 @@ MLABecLaplacian::setScalars (Real a, Real b) noexcept
 void
 MLABecLaplacian::setACoeffs (int amrlev, const MultiFab& alpha)
 {
+    if (!coeffsChanged(m_a_coeffs[amrlev][0], 0, alpha, 0, 1)) return;
     MultiFab::Copy(m_a_coeffs[amrlev][0], alpha, 0, 0, 1, 0);
     m_needs_update = true;
 }
@@ -80,6 +86,13 @@ MLABecLaplacian::setBCoeffs (int amrlev,
                              const Array<MultiFab const*,AMREX_SPACEDIM>& beta)
 {
     const int ncomp = getNComp();
+    bool changed = false;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        for (int icomp = 0; icomp < ncomp && !changed; ++icomp) {
+            changed = coeffsChanged(m_b_coeffs[amrlev][0][idim], icomp, *beta[idim], 0, 1);
+        }
+    }
+    if (!changed) return;
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
         for (int icomp = 0; icomp < ncomp; ++icomp) {
             MultiFab::Copy(m_b_coeffs[amrlev][0][idim], *beta[idim], 0, icomp, 1, 0);
@@ -406,6 +419,61 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
     }
 }
 
+Vector<MultiFab const*>
+MLABecLaplacian::smootherCoeffs (int amrlev, int mglev) const
+{
+    return {&m_a_coeffs[amrlev][mglev],
+            AMREX_D_DECL(&m_b_coeffs[amrlev][mglev][0],
+                         &m_b_coeffs[amrlev][mglev][1],
+                         &m_b_coeffs[amrlev][mglev][2])};
+}
+
+void
+MLABecLaplacian::FsmoothBlocked (int amrlev, int mglev, const Box& bx, const Box& vbx,
+                                 Array4<Real> const& sol, Array4<Real const> const& rhs,
+                                 const Vector<Array4<Real const> >& coeffs,
+                                 const Array<Array4<int const>,2*AMREX_SPACEDIM>& m,
+                                 const Array<Array4<Real const>,2*AMREX_SPACEDIM>& f,
+                                 int redblack) const
+{
+    const int nc = getNComp();
+    const Real* h = m_geom[amrlev][mglev].CellSize();
+    AMREX_D_TERM(const Real dhx = m_b_scalar/(h[0]*h[0]);,
+                 const Real dhy = m_b_scalar/(h[1]*h[1]);,
+                 const Real dhz = m_b_scalar/(h[2]*h[2]));
+    const Real alpha = m_a_scalar;
+
+#if (AMREX_SPACEDIM == 1)
+    abec_gsrb(bx, sol, rhs, alpha, dhx,
+              coeffs[0], coeffs[1],
+              f[0], m[0],
+              f[1], m[1],
+              vbx, nc, redblack);
+#endif
+
+#if (AMREX_SPACEDIM == 2)
+    abec_gsrb(bx, sol, rhs, alpha, dhx, dhy,
+              coeffs[0], coeffs[1], coeffs[2],
+              f[0], m[0],
+              f[1], m[1],
+              f[2], m[2],
+              f[3], m[3],
+              vbx, nc, redblack);
+#endif
+
+#if (AMREX_SPACEDIM == 3)
+    abec_gsrb(bx, sol, rhs, alpha, dhx, dhy, dhz,
+              coeffs[0], coeffs[1], coeffs[2], coeffs[3],
+              f[0], m[0],
+              f[1], m[1],
+              f[2], m[2],
+              f[3], m[3],
+              f[4], m[4],
+              f[5], m[5],
+              vbx, nc, redblack);
+#endif
+}
+
 void
 MLABecLaplacian::FFlux (int amrlev, const MFIter& mfi,
                         const Array<FArrayBox*,AMREX_SPACEDIM>& flux,
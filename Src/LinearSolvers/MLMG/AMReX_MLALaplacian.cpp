@@ -45,6 +45,7 @@ MLALaplacian::~MLALaplacian ()
 void
 MLALaplacian::setScalars (Real a, Real b) noexcept
 {
+    if (!coeffsChanged(m_a_scalar, a) && !coeffsChanged(m_b_scalar, b)) return;
     m_a_scalar = a;
     m_b_scalar = b;
     if (a == 0.0)
@@ -59,6 +60,7 @@ MLALaplacian::setScalars (Real a, Real b) noexcept
 void
 MLALaplacian::setACoeffs (int amrlev, const MultiFab& alpha)
 {
+    if (!coeffsChanged(m_a_coeffs[amrlev][0], 0, alpha, 0, 1)) return;
     MultiFab::Copy(m_a_coeffs[amrlev][0], alpha, 0, 0, 1, 0);
 }
 
@@ -0,0 +1,758 @@
+#include <AMReX_MLAMGBottomSolver.H>
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace amrex {
+
+constexpr long MLAMGBottomSolver::max_coarse_size;
+constexpr long MLAMGBottomSolver::max_direct_size;
+constexpr int MLAMGBottomSolver::max_levels;
+
+namespace {
+
+Real
+dot (Vector<Real> const& x, Vector<Real> const& y)
+{
+    const long n = x.size();
+    Real s = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:s)
+#endif
+    for (long i = 0; i < n; ++i) {
+        s += x[i]*y[i];
+    }
+    return s;
+}
+
+Real
+norminf (Vector<Real> const& x)
+{
+    const long n = x.size();
+    Real s = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(max:s)
+#endif
+    for (long i = 0; i < n; ++i) {
+        s = std::max(s, std::abs(x[i]));
+    }
+    return s;
+}
+
+}
+
+void
+MLAMGBottomSolver::spmv (const CSR& A, Vector<Real> const& x, Vector<Real>& y)
+{
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < A.nrows; ++i) {
+        Real s = 0.0;
+        for (long k = A.ptr[i]; k < A.ptr[i+1]; ++k) {
+            s += A.val[k]*x[A.col[k]];
+        }
+        y[i] = s;
+    }
+}
+
+MLAMGBottomSolver::CSR
+MLAMGBottomSolver::multiply (const CSR& A, const CSR& B)
+{
+    // Row by row with a dense marker of the columns of B, once to count
+    // the entries of each row and once to fill them.
+    CSR C;
+    C.nrows = A.nrows;
+    C.ncols = B.ncols;
+    C.ptr.assign(C.nrows+1, 0);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        Vector<long> marker(B.ncols, -1);
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (long i = 0; i < A.nrows; ++i) {
+            long m = 0;
+            for (long ka = A.ptr[i]; ka < A.ptr[i+1]; ++ka) {
+                const long j = A.col[ka];
+                for (long kb = B.ptr[j]; kb < B.ptr[j+1]; ++kb) {
+                    if (marker[B.col[kb]] != i) {
+                        marker[B.col[kb]] = i;
+                        ++m;
+                    }
+                }
+            }
+            C.ptr[i+1] = m;
+        }
+    }
+
+    for (long i = 0; i < C.nrows; ++i) {
+        C.ptr[i+1] += C.ptr[i];
+    }
+    C.col.resize(C.ptr[C.nrows]);
+    C.val.resize(C.ptr[C.nrows]);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        Vector<long> pos(B.ncols, -1);
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (long i = 0; i < A.nrows; ++i) {
+            const long start = C.ptr[i];
+            long m = start;
+            for (long ka = A.ptr[i]; ka < A.ptr[i+1]; ++ka) {
+                const long j = A.col[ka];
+                const Real a = A.val[ka];
+                for (long kb = B.ptr[j]; kb < B.ptr[j+1]; ++kb) {
+                    const long c = B.col[kb];
+                    if (pos[c] < start) {
+                        pos[c] = m;
+                        C.col[m] = c;
+                        C.val[m] = a*B.val[kb];
+                        ++m;
+                    } else {
+                        C.val[pos[c]] += a*B.val[kb];
+                    }
+                }
+            }
+        }
+    }
+
+    return C;
+}
+
+MLAMGBottomSolver::CSR
+MLAMGBottomSolver::transpose (const CSR& A)
+{
+    CSR T;
+    T.nrows = A.ncols;
+    T.ncols = A.nrows;
+    T.ptr.assign(T.nrows+1, 0);
+    for (long k = 0, N = A.col.size(); k < N; ++k) {
+        ++T.ptr[A.col[k]+1];
+    }
+    for (long i = 0; i < T.nrows; ++i) {
+        T.ptr[i+1] += T.ptr[i];
+    }
+    T.col.resize(A.col.size());
+    T.val.resize(A.val.size());
+    Vector<long> next(T.ptr.begin(), T.ptr.end()-1);
+    for (long i = 0; i < A.nrows; ++i) {
+        for (long k = A.ptr[i]; k < A.ptr[i+1]; ++k) {
+            const long m = next[A.col[k]]++;
+            T.col[m] = i;
+            T.val[m] = A.val[k];
+        }
+    }
+    return T;
+}
+
+long
+MLAMGBottomSolver::aggregate (const CSR& A, Vector<long>& agg) const
+{
+    BL_PROFILE("MLAMGBottomSolver::aggregate");
+
+    const long n = A.nrows;
+
+    Vector<Real> diag(n, 0.0);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < n; ++i) {
+        for (long k = A.ptr[i]; k < A.ptr[i+1]; ++k) {
+            if (A.col[k] == i) diag[i] = A.val[k];
+        }
+    }
+
+    // strong connections: |a_ij| >= theta*sqrt(|a_ii*a_jj|)
+    Vector<char> strong(A.col.size(), 0);
+    Vector<char> isolated(n, 1);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < n; ++i) {
+        for (long k = A.ptr[i]; k < A.ptr[i+1]; ++k) {
+            const long j = A.col[k];
+            if (j != i && A.val[k] != 0.0 &&
+                std::abs(A.val[k]) >= m_theta*std::sqrt(std::abs(diag[i]*diag[j])))
+            {
+                strong[k] = 1;
+                isolated[i] = 0;
+            }
+        }
+    }
+
+    // Greedy aggregation in three passes.  Cells without strong
+    // connections are not aggregated and are left to the smoother.
+    agg.assign(n, -1);
+    long nagg = 0;
+
+    // 1. Cells whose strong neighbors are all free seed a new aggregate.
+    for (long i = 0; i < n; ++i) {
+        if (isolated[i] || agg[i] >= 0) continue;
+        bool free = true;
+        for (long k = A.ptr[i]; k < A.ptr[i+1] && free; ++k) {
+            if (strong[k] && agg[A.col[k]] >= 0) free = false;
+        }
+        if (free) {
+            agg[i] = nagg;
+            for (long k = A.ptr[i]; k < A.ptr[i+1]; ++k) {
+                if (strong[k]) agg[A.col[k]] = nagg;
+            }
+            ++nagg;
+        }
+    }
+
+    // 2. Remaining cells join an aggregate of one of their strong neighbors.
+    Vector<long> agg1 = agg;
+    for (long i = 0; i < n; ++i) {
+        if (isolated[i] || agg[i] >= 0) continue;
+        for (long k = A.ptr[i]; k < A.ptr[i+1]; ++k) {
+            if (strong[k] && agg1[A.col[k]] >= 0) {
+                agg[i] = agg1[A.col[k]];
+                break;
+            }
+        }
+    }
+
+    // 3. Anything left forms aggregates with its free strong neighbors.
+    for (long i = 0; i < n; ++i) {
+        if (isolated[i] || agg[i] >= 0) continue;
+        agg[i] = nagg;
+        for (long k = A.ptr[i]; k < A.ptr[i+1]; ++k) {
+            if (strong[k] && agg[A.col[k]] < 0) agg[A.col[k]] = nagg;
+        }
+        ++nagg;
+    }
+
+    return nagg;
+}
+
+bool
+MLAMGBottomSolver::setup ()
+{
+    BL_PROFILE("MLAMGBottomSolver::setup()");
+
+    Vector<long> rows, cols;
+    Vector<Real> vals;
+    long bw;
+    if (!probe(rows, cols, vals, bw)) return false;
+
+    // A singular matrix is kept as it is and only pinned on the coarsest
+    // level, which does not disturb the hierarchy.
+    gather(rows, cols, vals, false);
+
+    bool ok = true;
+    if (isLeader())
+    {
+        BL_PROFILE("MLAMGBottomSolver::hierarchy");
+
+        const long n = m_n;
+
+        // Every row gets a diagonal entry, so that empty rows, such as
+        // those of covered cells, can become identity rows.
+        for (long i = 0; i < n; ++i) {
+            rows.push_back(i);
+            cols.push_back(i);
+            vals.push_back(0.0);
+        }
+
+        CSR A;
+        A.nrows = n;
+        A.ncols = n;
+        Vector<long> cnt(n+1, 0);
+        for (long r : rows) ++cnt[r+1];
+        for (long i = 0; i < n; ++i) cnt[i+1] += cnt[i];
+        Vector<long> tcol(rows.size());
+        Vector<Real> tval(rows.size());
+        {
+            Vector<long> next(cnt.begin(), cnt.end()-1);
+            for (long k = 0, N = rows.size(); k < N; ++k) {
+                const long m = next[rows[k]]++;
+                tcol[m] = cols[k];
+                tval[m] = vals[k];
+            }
+        }
+
+        // Sort the columns of each row and merge duplicates.
+        Vector<long> len(n);
+        int bad = 0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:bad)
+#endif
+        for (long i = 0; i < n; ++i) {
+            const long p0 = cnt[i];
+            const long p1 = cnt[i+1];
+            for (long k = p0+1; k < p1; ++k) {
+                const long c = tcol[k];
+                const Real v = tval[k];
+                long m = k;
+                for (; m > p0 && tcol[m-1] > c; --m) {
+                    tcol[m] = tcol[m-1];
+                    tval[m] = tval[m-1];
+                }
+                tcol[m] = c;
+                tval[m] = v;
+            }
+            long m = p0;
+            for (long k = p0; k < p1; ++k) {
+                if (m > p0 && tcol[m-1] == tcol[k]) {
+                    tval[m-1] += tval[k];
+                } else {
+                    tcol[m] = tcol[k];
+                    tval[m] = tval[k];
+                    ++m;
+                }
+            }
+            bool empty = true;
+            long kd = -1;
+            for (long k = p0; k < m; ++k) {
+                if (tcol[k] == i) {
+                    kd = k;
+                } else if (tval[k] != 0.0) {
+                    empty = false;
+                }
+            }
+            if (tval[kd] == 0.0) {
+                if (empty) {
+                    tval[kd] = 1.0;
+                } else {
+                    ++bad;
+                }
+            }
+            len[i] = m - p0;
+        }
+
+        if (bad > 0)
+        {
+            ok = false;
+        }
+        else
+        {
+            A.ptr.assign(n+1, 0);
+            for (long i = 0; i < n; ++i) A.ptr[i+1] = A.ptr[i] + len[i];
+            A.col.resize(A.ptr[n]);
+            A.val.resize(A.ptr[n]);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (long i = 0; i < n; ++i) {
+                std::copy(tcol.begin()+cnt[i], tcol.begin()+cnt[i]+len[i], A.col.begin()+A.ptr[i]);
+                std::copy(tval.begin()+cnt[i], tval.begin()+cnt[i]+len[i], A.val.begin()+A.ptr[i]);
+            }
+        }
+
+        Vector<long>().swap(rows);
+        Vector<long>().swap(cols);
+        Vector<Real>().swap(vals);
+        Vector<long>().swap(tcol);
+        Vector<Real>().swap(tval);
+
+        m_levels.clear();
+        if (ok) {
+            m_levels.resize(1);
+            m_levels[0].A = std::move(A);
+        }
+
+        while (ok && static_cast<int>(m_levels.size()) < max_levels &&
+               m_levels.back().A.nrows > max_coarse_size)
+        {
+            const CSR& Af = m_levels.back().A;
+            const long nf = Af.nrows;
+
+            Vector<long> agg;
+            const long nagg = aggregate(Af, agg);
+            if (nagg == 0 || nagg >= nf) break;
+
+            // piecewise constant tentative prolongation, with unit columns
+            Vector<long> size(nagg, 0);
+            for (long a : agg) {
+                if (a >= 0) ++size[a];
+            }
+            CSR T;
+            T.nrows = nf;
+            T.ncols = nagg;
+            T.ptr.assign(nf+1, 0);
+            for (long i = 0; i < nf; ++i) {
+                T.ptr[i+1] = T.ptr[i] + (agg[i] >= 0 ? 1 : 0);
+            }
+            for (long i = 0; i < nf; ++i) {
+                if (agg[i] >= 0) {
+                    T.col.push_back(agg[i]);
+                    T.val.push_back(1.0/std::sqrt(Real(size[agg[i]])));
+                }
+            }
+
+            // P = (I - omega D^{-1} A) T with omega = (4/3)/rho(D^{-1} A),
+            // where rho is bounded by the largest scaled row sum.
+            Vector<Real> diag(nf);
+            Real rho = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(max:rho)
+#endif
+            for (long i = 0; i < nf; ++i) {
+                Real s = 0.0;
+                for (long k = Af.ptr[i]; k < Af.ptr[i+1]; ++k) {
+                    if (Af.col[k] == i) diag[i] = Af.val[k];
+                    s += std::abs(Af.val[k]);
+                }
+                rho = std::max(rho, s/std::abs(diag[i]));
+            }
+            const Real omega = (4.0/3.0)/rho;
+
+            CSR P = multiply(Af, T);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+            for (long i = 0; i < nf; ++i) {
+                const Real f = -omega/diag[i];
+                for (long k = P.ptr[i]; k < P.ptr[i+1]; ++k) {
+                    P.val[k] *= f;
+                    if (P.col[k] == agg[i]) P.val[k] += T.val[T.ptr[i]];
+                }
+            }
+
+            CSR R = transpose(P);
+            CSR Ac = multiply(R, multiply(Af, P));
+
+            m_levels.back().P = std::move(P);
+            m_levels.back().R = std::move(R);
+            m_levels.emplace_back();
+            m_levels.back().A = std::move(Ac);
+        }
+
+        if (ok)
+        {
+            for (auto& lev : m_levels) {
+                const long nl = lev.A.nrows;
+                lev.x.resize(nl);
+                lev.b.resize(nl);
+                lev.r.resize(nl);
+                buildSmoother(lev);
+            }
+            if (m_levels.back().A.nrows <= max_direct_size) {
+                if (!factorCoarsest()) {
+                    m_coarse_lu.clear();
+                }
+            }
+        }
+    }
+
+    ok = leaderStatus(ok);
+
+    if (verbose > 0)
+    {
+        if (!ok) {
+            amrex::Print() << "MLAMGBottomSolver: zero diagonal in the matrix\n";
+        } else if (isLeader()) {
+            long nnz = 0;
+            for (auto const& lev : m_levels) nnz += lev.A.ptr.back();
+            amrex::Print() << "MLAMGBottomSolver: " << m_levels.size() << " levels, "
+                           << m_n << " to " << m_levels.back().A.nrows << " unknowns, "
+                           << "operator complexity "
+                           << Real(nnz)/Real(m_levels[0].A.ptr.back()) << "\n";
+        }
+    }
+
+    return ok;
+}
+
+void
+MLAMGBottomSolver::buildSmoother (Level& lev) const
+{
+    const CSR& A = lev.A;
+    const long n = A.nrows;
+
+#ifdef _OPENMP
+    const long nthreads = omp_get_max_threads();
+#else
+    const long nthreads = 1;
+#endif
+    const long nparts = std::max(long(1), std::min(nthreads, n/max_coarse_size));
+    lev.part.resize(nparts+1);
+    for (long t = 0; t <= nparts; ++t) {
+        lev.part[t] = (n*t)/nparts;
+    }
+
+    // Entries coupling to other threads' rows are added to the diagonal
+    // (l1 Gauss-Seidel), which keeps the hybrid smoother convergent.
+    lev.dinv.resize(n);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long t = 0; t < nparts; ++t) {
+        const long lo = lev.part[t];
+        const long hi = lev.part[t+1];
+        for (long i = lo; i < hi; ++i) {
+            Real d = 0.0;
+            for (long k = A.ptr[i]; k < A.ptr[i+1]; ++k) {
+                const long j = A.col[k];
+                if (j == i) {
+                    d += A.val[k];
+                } else if (j < lo || j >= hi) {
+                    d += std::abs(A.val[k]);
+                }
+            }
+            lev.dinv[i] = 1.0/d;
+        }
+    }
+}
+
+bool
+MLAMGBottomSolver::factorCoarsest ()
+{
+    BL_PROFILE("MLAMGBottomSolver::factorCoarsest");
+
+    const CSR& A = m_levels.back().A;
+    const long n = A.nrows;
+    m_coarse_lu.assign(n*n, 0.0);
+    m_coarse_piv.resize(n);
+    for (long i = 0; i < n; ++i) {
+        for (long k = A.ptr[i]; k < A.ptr[i+1]; ++k) {
+            m_coarse_lu[i*n+A.col[k]] = A.val[k];
+        }
+    }
+
+    // The coarse matrix of a singular operator is singular too.  The
+    // unknown with the largest diagonal is pinned to zero.
+    if (Lp.isBottomSingular()) {
+        long p = 0;
+        for (long i = 1; i < n; ++i) {
+            if (m_coarse_lu[i*n+i] > m_coarse_lu[p*n+p]) p = i;
+        }
+        for (long i = 0; i < n; ++i) {
+            m_coarse_lu[p*n+i] = 0.0;
+            m_coarse_lu[i*n+p] = 0.0;
+        }
+        m_coarse_lu[p*n+p] = 1.0;
+        m_coarse_pinned = p;
+    }
+
+    Real* a = m_coarse_lu.data();
+    for (long k = 0; k < n; ++k)
+    {
+        long p = k;
+        for (long i = k+1; i < n; ++i) {
+            if (std::abs(a[i*n+k]) > std::abs(a[p*n+k])) p = i;
+        }
+        if (!(std::abs(a[p*n+k]) > 0.0)) return false;
+        m_coarse_piv[k] = p;
+        if (p != k) {
+            std::swap_ranges(a+k*n, a+(k+1)*n, a+p*n);
+        }
+        const Real piv = a[k*n+k];
+#ifdef _OPENMP
+#pragma omp parallel for if (n-k > 64)
+#endif
+        for (long i = k+1; i < n; ++i) {
+            const Real l = a[i*n+k]/piv;
+            a[i*n+k] = l;
+            if (l != 0.0) {
+                for (long j = k+1; j < n; ++j) {
+                    a[i*n+j] -= l*a[k*n+j];
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void
+MLAMGBottomSolver::smooth (Level& lev, bool forward) const
+{
+    const CSR& A = lev.A;
+    Vector<Real>& x = lev.x;
+    Vector<Real> const& b = lev.b;
+    const long nparts = lev.part.size()-1;
+
+    // Gauss-Seidel within each thread's rows and Jacobi between them,
+    // with the values from other threads' rows taken from xold.
+    Vector<Real>& xold = lev.r;
+    if (nparts > 1) xold = x;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long t = 0; t < nparts; ++t) {
+        const long lo = lev.part[t];
+        const long hi = lev.part[t+1];
+        for (long m = 0; m < hi-lo; ++m) {
+            const long i = forward ? lo+m : hi-1-m;
+            Real s = b[i];
+            for (long k = A.ptr[i]; k < A.ptr[i+1]; ++k) {
+                const long j = A.col[k];
+                s -= A.val[k] * ((j >= lo && j < hi) ? x[j] : xold[j]);
+            }
+            x[i] += s*lev.dinv[i];
+        }
+    }
+}
+
+void
+MLAMGBottomSolver::coarseSolve ()
+{
+    Level& lev = m_levels.back();
+    const long n = lev.A.nrows;
+
+    if (m_coarse_lu.empty())
+    {
+        std::fill(lev.x.begin(), lev.x.end(), 0.0);
+        for (int i = 0; i < 10; ++i) {
+            smooth(lev, true);
+            smooth(lev, false);
+        }
+        return;
+    }
+
+    Vector<Real>& x = lev.x;
+    x = lev.b;
+    if (m_coarse_pinned >= 0) x[m_coarse_pinned] = 0.0;
+    Real const* a = m_coarse_lu.data();
+    for (long k = 0; k < n; ++k) {
+        std::swap(x[k], x[m_coarse_piv[k]]);
+    }
+    for (long i = 0; i < n; ++i) {
+        Real s = x[i];
+        for (long j = 0; j < i; ++j) {
+            s -= a[i*n+j]*x[j];
+        }
+        x[i] = s;
+    }
+    for (long i = n-1; i >= 0; --i) {
+        Real s = x[i];
+        for (long j = i+1; j < n; ++j) {
+            s -= a[i*n+j]*x[j];
+        }
+        x[i] = s/a[i*n+i];
+    }
+}
+
+void
+MLAMGBottomSolver::vcycle (int ilev)
+{
+    if (ilev == static_cast<int>(m_levels.size())-1) {
+        coarseSolve();
+        return;
+    }
+
+    Level& lev = m_levels[ilev];
+    Level& crse = m_levels[ilev+1];
+    const long n = lev.A.nrows;
+
+    std::fill(lev.x.begin(), lev.x.end(), 0.0);
+    smooth(lev, true);
+
+    spmv(lev.A, lev.x, lev.r);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < n; ++i) {
+        lev.r[i] = lev.b[i] - lev.r[i];
+    }
+    spmv(lev.R, lev.r, crse.b);
+
+    vcycle(ilev+1);
+
+    spmv(lev.P, crse.x, lev.r);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < n; ++i) {
+        lev.x[i] += lev.r[i];
+    }
+    smooth(lev, false);
+}
+
+void
+MLAMGBottomSolver::precondition (Vector<Real> const& r, Vector<Real>& z)
+{
+    m_levels[0].b = r;
+    vcycle(0);
+    z = m_levels[0].x;
+}
+
+void
+MLAMGBottomSolver::solveGathered (Vector<Real>& v)
+{
+    BL_PROFILE("MLAMGBottomSolver::solve()");
+
+    const CSR& A = m_levels[0].A;
+    const long n = A.nrows;
+
+    const Real bnorm = norminf(v);
+    if (bnorm == 0.0) return;
+    const Real tol = std::max(m_reltol*bnorm, m_abstol);
+
+    // BiCGStab with right preconditioning by one V-cycle
+    Vector<Real> x(n, 0.0), r = v, rh = v;
+    Vector<Real> p(n, 0.0), q(n, 0.0), ph(n), s(n), sh(n), t(n);
+    Real rho = 1.0, alpha = 1.0, omega = 1.0;
+    Real rnorm = bnorm;
+    bool converged = false;
+    int iter = 1;
+    for (; iter <= m_maxiter; ++iter)
+    {
+        const Real rho_new = dot(rh, r);
+        if (rho_new == 0.0) break;
+        const Real beta = (rho_new/rho)*(alpha/omega);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (long i = 0; i < n; ++i) {
+            p[i] = r[i] + beta*(p[i] - omega*q[i]);
+        }
+        precondition(p, ph);
+        spmv(A, ph, q);
+
+        const Real rq = dot(rh, q);
+        if (rq == 0.0) break;
+        alpha = rho_new/rq;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (long i = 0; i < n; ++i) {
+            x[i] += alpha*ph[i];
+            s[i] = r[i] - alpha*q[i];
+        }
+        rnorm = norminf(s);
+        if (rnorm <= tol) { converged = true; break; }
+
+        precondition(s, sh);
+        spmv(A, sh, t);
+
+        const Real tt = dot(t, t);
+        if (tt == 0.0) break;
+        omega = dot(t, s)/tt;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (long i = 0; i < n; ++i) {
+            x[i] += omega*sh[i];
+            r[i] = s[i] - omega*t[i];
+        }
+        rnorm = norminf(r);
+        if (rnorm <= tol) { converged = true; break; }
+        if (omega == 0.0) break;
+        rho = rho_new;
+    }
+
+    if (verbose > 0) {
+        amrex::Print() << "MLAMGBottomSolver: " << (converged ? "" : "not converged after ")
+                       << std::min(iter, m_maxiter) << " iterations, residual "
+                       << rnorm << " of " << bnorm << "\n";
+    }
+
+    v = std::move(x);
+}
+
+}
@@ -48,6 +48,55 @@ sxay (MultiFab&       ss,
     sxay(ss,xx,a,yy,0,nghost);
 }
 
+// ss = xx + scale*a[n]*yy in each component n
+void
+sxay (MultiFab&           ss,
+      const MultiFab&     xx,
+      Vector<Real> const& a,
+      const MultiFab&     yy,
+      const int           nghost,
+      const Real          scale = 1.0)
+{
+    BL_PROFILE("CGSolver::sxay()");
+
+    for (int n = 0; n < ss.nComp(); ++n) {
+        MultiFab::LinComb(ss, 1.0, xx, n, scale*a[n], yy, n, n, 1, nghost);
+    }
+}
+
+//
+// Sums of nsum values and the max of one value over comm.  The reductions
+// are started without blocking so that they can be overlapped with an
+// operator apply, and are finished by wait().
+//
+class AsyncReduce
+{
+public:
+    AsyncReduce (Real* sums, int nsum, Real& vmax, MPI_Comm comm)
+    {
+#ifdef BL_USE_MPI
+        BL_PROFILE("MLCGSolver::ParallelAllReduce");
+        MPI_Iallreduce(MPI_IN_PLACE, sums, nsum, ParallelDescriptor::Mpi_typemap<Real>::type(),
+                       MPI_SUM, comm, &m_req[0]);
+        MPI_Iallreduce(MPI_IN_PLACE, &vmax, 1, ParallelDescriptor::Mpi_typemap<Real>::type(),
+                       MPI_MAX, comm, &m_req[1]);
+#endif
+    }
+
+    void wait ()
+    {
+#ifdef BL_USE_MPI
+        BL_PROFILE("MLCGSolver::ParallelAllReduce");
+        MPI_Waitall(2, m_req, MPI_STATUSES_IGNORE);
+#endif
+    }
+
+private:
+#ifdef BL_USE_MPI
+    MPI_Request m_req[2];
+#endif
+};
+
 }
 
 MLCGSolver::MLCGSolver (MLMG* a_mlmg, MLLinOp& _lp, Type _typ)
@@ -69,10 +118,20 @@ MLCGSolver::solve (MultiFab&       sol,
                    Real            eps_rel,
                    Real            eps_abs)
 {
-    if (solver_type == Type::BiCGStab) {
+    if (Lp.hasIndependentComponents() && sol.nComp() > 1) {
+        if (solver_type == Type::CG || solver_type == Type::PipelinedCG) {
+            return solve_cg_batched(sol,rhs,eps_rel,eps_abs);
+        } else {
+            return solve_bicgstab_batched(sol,rhs,eps_rel,eps_abs);
+        }
+    } else if (solver_type == Type::BiCGStab) {
         return solve_bicgstab(sol,rhs,eps_rel,eps_abs);
-    } else {
+    } else if (solver_type == Type::CG) {
         return solve_cg(sol,rhs,eps_rel,eps_abs);
+    } else if (solver_type == Type::PipelinedBiCGStab) {
+        return solve_pipelined_bicgstab(sol,rhs,eps_rel,eps_abs);
+    } else {
+        return solve_pipelined_cg(sol,rhs,eps_rel,eps_abs);
     }
 }
 
@@ -391,6 +450,748 @@ MLCGSolver::solve_cg (MultiFab&       sol,
     return ret;
 }
 
+//
+// Pipelined BiCGStab of Cools and Vanroose.  The two reductions of each
+// iteration are overlapped with the two operator applies.  The vectors
+// are w = A r, s = A p, z = A s, t = A w and v = A z, where A includes the
+// normalization.
+//
+int
+MLCGSolver::solve_pipelined_bicgstab (MultiFab&       sol,
+                                      const MultiFab& rhs,
+                                      Real            eps_rel,
+                                      Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::pipelined_bicgstab");
+
+    const int ncomp = sol.nComp();
+    const int ngsol = sol.nGrow();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    // These are the ones the operator is applied to.
+    MultiFab p    (ba, dm, ncomp, ngsol, MFInfo(), factory);
+    MultiFab w    (ba, dm, ncomp, ngsol, MFInfo(), factory);
+    MultiFab z    (ba, dm, ncomp, ngsol, MFInfo(), factory);
+    p.setVal(0.0);
+    w.setVal(0.0);
+    z.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab r    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab rh   (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab s    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab t    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab v    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab q    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab y    (ba, dm, ncomp, nghost, MFInfo(), factory);
+
+    auto applyOp = [&] (MultiFab& out, MultiFab& in)
+    {
+        Lp.apply(amrlev, mglev, out, in, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        Lp.normalize(amrlev, mglev, out);
+    };
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+    Lp.normalize(amrlev, mglev, r);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+    MultiFab::Copy(rh,   r,  0,0,ncomp,nghost);
+
+    sol.setVal(0);
+
+    MultiFab::Copy(p,r,0,0,ncomp,nghost);
+    applyOp(w, p);
+
+    Real rnorm = norm_inf(r,true);
+    Real rsums[2] = { dotxy(rh,r,true), dotxy(rh,w,true) };
+    {
+        AsyncReduce red(rsums, 2, rnorm, Lp.BottomCommunicator());
+        applyOp(t, w);
+        red.wait();
+    }
+    const Real rnorm0 = rnorm;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipelinedBiCGStab: Initial error (error0) =        " << rnorm0 << '\n';
+    }
+    int ret = 0, nit = 1;
+    Real rho = rsums[0], alpha = 0, beta = 0, omega = 0;
+
+    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    {
+        if ( verbose > 0 )
+        {
+            amrex::Print() << "MLCGSolver_PipelinedBiCGStab: niter = 0,"
+                           << ", rnorm = " << rnorm
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return ret;
+    }
+
+    if ( rho == 0 )
+    {
+        ret = 1;
+    }
+    else if ( rsums[1] == 0 )
+    {
+        ret = 2;
+    }
+    else
+    {
+        alpha = rho/rsums[1];
+    }
+
+    for (; nit <= maxiter && ret == 0; ++nit)
+    {
+        if ( nit == 1 )
+        {
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+            MultiFab::Copy(s,w,0,0,ncomp,nghost);
+            MultiFab::Copy(z,t,0,0,ncomp,nghost);
+        }
+        else
+        {
+            sxay(p, p, -omega, s, nghost);
+            sxay(p, r,   beta, p, nghost);
+            sxay(s, s, -omega, z, nghost);
+            sxay(s, w,   beta, s, nghost);
+            sxay(z, z, -omega, v, nghost);
+            sxay(z, t,   beta, z, nghost);
+        }
+        sxay(q, r, -alpha, s, nghost);
+        sxay(y, w, -alpha, z, nghost);
+
+        rnorm = norm_inf(q,true);
+        Real qsums[2] = { dotxy(q,y,true), dotxy(y,y,true) };
+        {
+            AsyncReduce red(qsums, 2, rnorm, Lp.BottomCommunicator());
+            applyOp(v, z);
+            red.wait();
+        }
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_PipelinedBiCGStab: Half Iter "
+                           << std::setw(11) << nit
+                           << " rel. err. "
+                           << rnorm/(rnorm0) << '\n';
+        }
+
+        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs )
+        {
+            sxay(sol, sol, alpha, p, nghost);
+            break;
+        }
+
+        if ( qsums[1] )
+        {
+            omega = qsums[0]/qsums[1];
+        }
+        else
+        {
+            ret = 3; break;
+        }
+
+        sxay(sol, sol, alpha, p, nghost);
+        sxay(sol, sol, omega, q, nghost);
+        sxay(r, q, -omega, y, nghost);
+        sxay(t, t, -alpha, v, nghost);
+        sxay(w, y, -omega, t, nghost);
+
+        rnorm = norm_inf(r,true);
+        Real rsums[4] = { dotxy(rh,r,true), dotxy(rh,w,true), dotxy(rh,s,true), dotxy(rh,z,true) };
+        {
+            AsyncReduce red(rsums, 4, rnorm, Lp.BottomCommunicator());
+            applyOp(t, w);
+            red.wait();
+        }
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_PipelinedBiCGStab: Iteration "
+                           << std::setw(11) << nit
+                           << " rel. err. "
+                           << rnorm/(rnorm0) << '\n';
+        }
+
+        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
+
+        if ( omega == 0 )
+        {
+            ret = 4; break;
+        }
+
+        const Real rho_1 = rho;
+        rho = rsums[0];
+        if ( rho == 0 )
+        {
+            ret = 1; break;
+        }
+        beta = (rho/rho_1)*(alpha/omega);
+
+        const Real rhTAp = rsums[1] + beta*rsums[2] - beta*omega*rsums[3];
+        if ( rhTAp )
+        {
+            alpha = rho/rhTAp;
+        }
+        else
+        {
+            ret = 2; break;
+        }
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipelinedBiCGStab: Final: Iteration "
+                       << std::setw(4) << nit
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 && rnorm > eps_rel*rnorm0 && rnorm > eps_abs)
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_PipelinedBiCGStab:: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
+//
+// Pipelined CG of Ghysels and Vanroose.  The reduction of each iteration
+// is overlapped with the operator apply.  The vectors are w = A r,
+// s = A p, q = A w and z = A s.
+//
+int
+MLCGSolver::solve_pipelined_cg (MultiFab&       sol,
+                                const MultiFab& rhs,
+                                Real            eps_rel,
+                                Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::pipelined_cg");
+
+    const int ncomp = sol.nComp();
+    const int ngsol = sol.nGrow();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    // These are the ones the operator is applied to.
+    MultiFab p    (ba, dm, ncomp, ngsol, MFInfo(), factory);
+    MultiFab w    (ba, dm, ncomp, ngsol, MFInfo(), factory);
+    p.setVal(0.0);
+    w.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab r    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab s    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab q    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab z    (ba, dm, ncomp, nghost, MFInfo(), factory);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+
+    sol.setVal(0);
+
+    MultiFab::Copy(p,r,0,0,ncomp,nghost);
+    Lp.apply(amrlev, mglev, w, p, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+
+    Real rnorm = 0, rnorm0 = 0;
+    Real gamma_1 = 0, alpha = 0;
+    int  ret = 0;
+    int  nit = 1;
+
+    for (; nit <= maxiter; ++nit)
+    {
+        rnorm = norm_inf(r,true);
+        Real sums[2] = { dotxy(r,r,true), dotxy(w,r,true) };
+        {
+            AsyncReduce red(sums, 2, rnorm, Lp.BottomCommunicator());
+            Lp.apply(amrlev, mglev, q, w, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+            red.wait();
+        }
+
+        if ( nit == 1 )
+        {
+            rnorm0 = rnorm;
+
+            if ( verbose > 0 )
+            {
+                amrex::Print() << "MLCGSolver_PipelinedCG: Initial error (error0) :        " << rnorm0 << '\n';
+            }
+
+            if ( rnorm0 == 0 || rnorm0 < eps_abs )
+            {
+                if ( verbose > 0 ) {
+                    amrex::Print() << "MLCGSolver_PipelinedCG: niter = 0,"
+                                   << ", rnorm = " << rnorm
+                                   << ", eps_abs = " << eps_abs << std::endl;
+                }
+                sol.plus(sorig, 0, ncomp, nghost);
+                return ret;
+            }
+        }
+        else
+        {
+            if ( verbose > 2 )
+            {
+                amrex::Print() << "MLCGSolver_PipelinedCG:       Iteration"
+                               << std::setw(4) << nit-1
+                               << " rel. err. "
+                               << rnorm/(rnorm0) << '\n';
+            }
+
+            if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
+        }
+
+        const Real gamma = sums[0];
+        const Real delta = sums[1];
+        if ( gamma == 0 )
+        {
+            ret = 1; break;
+        }
+
+        Real beta, pw;
+        if ( nit == 1 )
+        {
+            beta = 0;
+            pw = delta;
+        }
+        else
+        {
+            beta = gamma/gamma_1;
+            pw = delta - beta*gamma/alpha;
+        }
+        if ( pw )
+        {
+            alpha = gamma/pw;
+        }
+        else
+        {
+            ret = 1; break;
+        }
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_PipelinedCG:"
+                           << " nit " << nit
+                           << " rho " << gamma
+                           << " alpha " << alpha << '\n';
+        }
+
+        if ( nit == 1 )
+        {
+            MultiFab::Copy(z,q,0,0,ncomp,nghost);
+            MultiFab::Copy(s,w,0,0,ncomp,nghost);
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+        }
+        else
+        {
+            sxay(z, q, beta, z, nghost);
+            sxay(s, w, beta, s, nghost);
+            sxay(p, r, beta, p, nghost);
+        }
+        sxay(sol, sol,  alpha, p, nghost);
+        sxay(  r,   r, -alpha, s, nghost);
+        sxay(  w,   w, -alpha, z, nghost);
+
+        gamma_1 = gamma;
+    }
+
+    if ( nit > maxiter )
+    {
+        // The residual of the last update has not been checked.
+        rnorm = norm_inf(r);
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_PipelinedCG: Final Iteration"
+                       << std::setw(4) << nit-1
+                       << " rel. err. "
+                       << rnorm/(rnorm0) << '\n';
+    }
+
+    if ( ret == 0 &&  rnorm > eps_rel*rnorm0 && rnorm > eps_abs )
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_PipelinedCG: failed to converge!");
+        ret = 8;
+    }
+
+    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
+    {
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+    else
+    {
+        sol.setVal(0);
+        sol.plus(sorig, 0, ncomp, nghost);
+    }
+
+    return ret;
+}
+
+int
+MLCGSolver::solve_bicgstab_batched (MultiFab&       sol,
+                                    const MultiFab& rhs,
+                                    Real            eps_rel,
+                                    Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::bicgstab_batched");
+
+    const int ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    MultiFab ph(ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    MultiFab sh(ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    ph.setVal(0.0);
+    sh.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab p    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab r    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab s    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab rh   (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab v    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab t    (ba, dm, ncomp, nghost, MFInfo(), factory);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+    Lp.normalize(amrlev, mglev, r);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+    MultiFab::Copy(rh,   r,  0,0,ncomp,nghost);
+
+    sol.setVal(0);
+
+    Vector<Real> rnorm0, rnorm;
+    norm_inf_comps(r, rnorm0);
+    rnorm = rnorm0;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_BiCGStab: Initial error (error0) =        "
+                       << *std::max_element(rnorm0.begin(), rnorm0.end()) << '\n';
+    }
+
+    // A component stops when it has converged or broken down.  Its
+    // scalars are then zero, so that it is no longer changed.  A
+    // component with a zero initial residual has nothing to solve.
+    Vector<int> status(ncomp, 0);
+    Vector<int> active(ncomp);
+    auto converged = [&] (int n) {
+        return rnorm0[n] == 0 || rnorm[n] < eps_rel*rnorm0[n] || rnorm[n] < eps_abs;
+    };
+    auto nactive = [&] () {
+        int m = 0;
+        for (int n = 0; n < ncomp; ++n) {
+            active[n] = (status[n] == 0 && !converged(n));
+            m += active[n];
+        }
+        return m;
+    };
+
+    Vector<Real> rho(ncomp,0), rho_1(ncomp,0), alpha(ncomp,0), omega(ncomp,0), beta(ncomp,0);
+    Vector<Real> sums(2*ncomp);
+    int nit = 1;
+
+    if (nactive() == 0)
+    {
+        if ( verbose > 0 )
+        {
+            amrex::Print() << "MLCGSolver_BiCGStab: niter = 0,"
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return 0;
+    }
+
+    for (; nit <= maxiter; ++nit)
+    {
+        dotxy_comps(rh, r, rho.data());
+        {
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            ParallelAllReduce::Sum(rho.data(), ncomp, Lp.BottomCommunicator());
+        }
+        for (int n = 0; n < ncomp; ++n) {
+            if (active[n] && rho[n] == 0) { status[n] = 1; active[n] = 0; }
+        }
+        if ( nit == 1 )
+        {
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+        }
+        else
+        {
+            for (int n = 0; n < ncomp; ++n) {
+                beta[n] = active[n] ? (rho[n]/rho_1[n])*(alpha[n]/omega[n]) : 0.0;
+                if (!active[n]) omega[n] = 0.0;
+            }
+            sxay(p, p, omega, v, nghost, -1.0);
+            sxay(p, r,  beta, p, nghost);
+        }
+        MultiFab::Copy(ph,p,0,0,ncomp,nghost);
+        Lp.apply(amrlev, mglev, v, ph, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        Lp.normalize(amrlev, mglev, v);
+
+        dotxy_comps(rh, v, sums.data());
+        {
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            ParallelAllReduce::Sum(sums.data(), ncomp, Lp.BottomCommunicator());
+        }
+        for (int n = 0; n < ncomp; ++n) {
+            if (active[n] && sums[n] == 0) { status[n] = 2; active[n] = 0; }
+            alpha[n] = active[n] ? rho[n]/sums[n] : 0.0;
+        }
+        sxay(sol, sol, alpha, ph, nghost);
+        sxay(s,     r, alpha,  v, nghost, -1.0);
+
+        norm_inf_comps(s, rnorm);
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_BiCGStab: Half Iter "
+                           << std::setw(11) << nit
+                           << " active " << nactive() << '\n';
+        }
+
+        if (nactive() == 0) break;
+
+        MultiFab::Copy(sh,s,0,0,ncomp,nghost);
+        Lp.apply(amrlev, mglev, t, sh, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+        Lp.normalize(amrlev, mglev, t);
+
+        dotxy_comps(t, t, sums.data());
+        dotxy_comps(t, s, sums.data()+ncomp);
+        {
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            ParallelAllReduce::Sum(sums.data(), 2*ncomp, Lp.BottomCommunicator());
+        }
+        for (int n = 0; n < ncomp; ++n) {
+            if (active[n] && sums[n] == 0) { status[n] = 3; active[n] = 0; }
+            omega[n] = active[n] ? sums[ncomp+n]/sums[n] : 0.0;
+        }
+        sxay(sol, sol, omega, sh, nghost);
+        sxay(r,     s, omega,  t, nghost, -1.0);
+
+        norm_inf_comps(r, rnorm);
+
+        for (int n = 0; n < ncomp; ++n) {
+            if (active[n] && !converged(n) && omega[n] == 0) status[n] = 4;
+        }
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_BiCGStab: Iteration "
+                           << std::setw(11) << nit
+                           << " active " << nactive() << '\n';
+        }
+
+        if (nactive() == 0) break;
+
+        rho_1 = rho;
+    }
+
+    int ret = 0;
+    Real relerr = 0;
+    for (int n = 0; n < ncomp; ++n) {
+        if (rnorm0[n] > 0) relerr = std::max(relerr, rnorm[n]/rnorm0[n]);
+        if (ret == 0) ret = status[n];
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_BiCGStab: Final: Iteration "
+                       << std::setw(4) << std::min(nit,maxiter)
+                       << " rel. err. "
+                       << relerr << '\n';
+    }
+
+    bool all_converged = true;
+    for (int n = 0; n < ncomp; ++n) {
+        all_converged = all_converged && converged(n);
+    }
+    if ( ret == 0 && !all_converged )
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_BiCGStab:: failed to converge!");
+        ret = 8;
+    }
+
+    for (int n = 0; n < ncomp; ++n) {
+        if (!( ( status[n] == 0 ) && (rnorm[n] < rnorm0[n]) )) {
+            sol.setVal(0.0, n, 1, nghost);
+        }
+    }
+    sol.plus(sorig, 0, ncomp, nghost);
+
+    return ret;
+}
+
+int
+MLCGSolver::solve_cg_batched (MultiFab&       sol,
+                              const MultiFab& rhs,
+                              Real            eps_rel,
+                              Real            eps_abs)
+{
+    BL_PROFILE("MLCGSolver::cg_batched");
+
+    const int ncomp = sol.nComp();
+
+    const BoxArray& ba = sol.boxArray();
+    const DistributionMapping& dm = sol.DistributionMap();
+    const auto& factory = sol.Factory();
+
+    MultiFab p(ba, dm, ncomp, sol.nGrow(), MFInfo(), factory);
+    p.setVal(0.0);
+
+    MultiFab sorig(ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab r    (ba, dm, ncomp, nghost, MFInfo(), factory);
+    MultiFab q    (ba, dm, ncomp, nghost, MFInfo(), factory);
+
+    MultiFab::Copy(sorig,sol,0,0,ncomp,nghost);
+
+    Lp.correctionResidual(amrlev, mglev, r, sol, rhs, MLLinOp::BCMode::Homogeneous);
+
+    sol.setVal(0);
+
+    Vector<Real> rnorm0, rnorm;
+    norm_inf_comps(r, rnorm0);
+    rnorm = rnorm0;
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_CG: Initial error (error0) :        "
+                       << *std::max_element(rnorm0.begin(), rnorm0.end()) << '\n';
+    }
+
+    Vector<int> status(ncomp, 0);
+    Vector<int> active(ncomp);
+    auto converged = [&] (int n) {
+        return rnorm0[n] == 0 || rnorm[n] < eps_rel*rnorm0[n] || rnorm[n] < eps_abs;
+    };
+    auto nactive = [&] () {
+        int m = 0;
+        for (int n = 0; n < ncomp; ++n) {
+            active[n] = (status[n] == 0 && !converged(n));
+            m += active[n];
+        }
+        return m;
+    };
+
+    Vector<Real> rho(ncomp,0), rho_1(ncomp,0), alpha(ncomp,0), beta(ncomp,0), pw(ncomp);
+    int nit = 1;
+
+    if (nactive() == 0)
+    {
+        if ( verbose > 0 ) {
+            amrex::Print() << "MLCGSolver_CG: niter = 0,"
+                           << ", eps_abs = " << eps_abs << std::endl;
+        }
+        return 0;
+    }
+
+    for (; nit <= maxiter; ++nit)
+    {
+        dotxy_comps(r, r, rho.data());
+        {
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            ParallelAllReduce::Sum(rho.data(), ncomp, Lp.BottomCommunicator());
+        }
+        for (int n = 0; n < ncomp; ++n) {
+            if (active[n] && rho[n] == 0) { status[n] = 1; active[n] = 0; }
+        }
+        if (nit == 1)
+        {
+            MultiFab::Copy(p,r,0,0,ncomp,nghost);
+        }
+        else
+        {
+            for (int n = 0; n < ncomp; ++n) {
+                beta[n] = active[n] ? rho[n]/rho_1[n] : 0.0;
+            }
+            sxay(p, r, beta, p, nghost);
+        }
+        Lp.apply(amrlev, mglev, q, p, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+
+        dotxy_comps(p, q, pw.data());
+        {
+            BL_PROFILE("MLCGSolver::ParallelAllReduce");
+            ParallelAllReduce::Sum(pw.data(), ncomp, Lp.BottomCommunicator());
+        }
+        for (int n = 0; n < ncomp; ++n) {
+            if (active[n] && pw[n] == 0) { status[n] = 1; active[n] = 0; }
+            alpha[n] = active[n] ? rho[n]/pw[n] : 0.0;
+        }
+
+        sxay(sol, sol, alpha, p, nghost);
+        sxay(  r,   r, alpha, q, nghost, -1.0);
+        norm_inf_comps(r, rnorm);
+
+        if ( verbose > 2 )
+        {
+            amrex::Print() << "MLCGSolver_cg:       Iteration"
+                           << std::setw(4) << nit
+                           << " active " << nactive() << '\n';
+        }
+
+        if (nactive() == 0) break;
+
+        rho_1 = rho;
+    }
+
+    int ret = 0;
+    Real relerr = 0;
+    bool all_converged = true;
+    for (int n = 0; n < ncomp; ++n) {
+        if (rnorm0[n] > 0) relerr = std::max(relerr, rnorm[n]/rnorm0[n]);
+        if (ret == 0) ret = status[n];
+        all_converged = all_converged && converged(n);
+    }
+
+    if ( verbose > 0 )
+    {
+        amrex::Print() << "MLCGSolver_cg: Final Iteration"
+                       << std::setw(4) << std::min(nit,maxiter)
+                       << " rel. err. "
+                       << relerr << '\n';
+    }
+
+    if ( ret == 0 && !all_converged )
+    {
+        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+            amrex::Warning("MLCGSolver_cg: failed to converge!");
+        ret = 8;
+    }
+
+    for (int n = 0; n < ncomp; ++n) {
+        if (!( ( status[n] == 0 ) && (rnorm[n] < rnorm0[n]) )) {
+            sol.setVal(0.0, n, 1, nghost);
+        }
+    }
+    sol.plus(sorig, 0, ncomp, nghost);
+
+    return ret;
+}
+
 Real
 MLCGSolver::dotxy (const MultiFab& r, const MultiFab& z, bool local)
 {
@@ -416,5 +1217,25 @@ MLCGSolver::norm_inf (const MultiFab& res, bool local)
     return result;
 }
 
+void
+MLCGSolver::dotxy_comps (const MultiFab& r, const MultiFab& z, Real* result)
+{
+    for (int n = 0; n < r.nComp(); ++n) {
+        result[n] = MultiFab::Dot(r, n, z, n, 1, 0, true);
+    }
+}
+
+void
+MLCGSolver::norm_inf_comps (const MultiFab& res, Vector<Real>& result)
+{
+    const int ncomp = res.nComp();
+    result.resize(ncomp);
+    for (int n = 0; n < ncomp; ++n) {
+        result[n] = res.norm0(n, 0, true);
+    }
+    BL_PROFILE("MLCGSolver::ParallelAllReduce");
+    ParallelAllReduce::Max(result.data(), ncomp, Lp.BottomCommunicator());
+}
+
 
 }
@@ -10,6 +10,7 @@
 
 namespace amrex {
 
+
 MLCellLinOp::MLCellLinOp ()
 {
     m_ixtype = IntVect::TheCellVector();
@@ -342,16 +343,600 @@ MLCellLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
                      bool skip_fillboundary) const
 {
     BL_PROFILE("MLCellLinOp::smooth()");
-    for (int redblack = 0; redblack < 2; ++redblack)
+    if (info.smoother == MLSmoother::l1_jacobi)
+    {
+        jacobiSmooth(amrlev, mglev, sol, rhs, skip_fillboundary);
+        return;
+    }
+    else if (info.smoother == MLSmoother::chebyshev)
     {
-        applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution,
+        chebyshevSmooth(amrlev, mglev, sol, rhs, skip_fillboundary);
+        return;
+    }
+
+    int nsweeps = 1;
+    if (info.smoother == MLSmoother::gsrb_blocked)
+    {
+        if (getBlockedSmootherData(amrlev, mglev).depth > 0) {
+            blockedSmooth(amrlev, mglev, sol, rhs);
+            return;
+        }
+        nsweeps = info.smoother_sweeps;
+    }
+
+    for (int sweep = 0; sweep < nsweeps; ++sweep)
+    {
+        for (int redblack = 0; redblack < 2; ++redblack)
+        {
+            applyBC(amrlev, mglev, sol, BCMode::Homogeneous, StateMode::Solution,
+                    nullptr, skip_fillboundary);
+#ifdef AMREX_SOFT_PERF_COUNTERS
+            perf_counters.smooth(sol);
+#endif
+            Fsmooth(amrlev, mglev, sol, rhs, redblack);
+            skip_fillboundary = false;
+        }
+    }
+}
+
+void
+MLCellLinOp::smootherApply (int amrlev, int mglev, MultiFab& out, MultiFab& in,
+                            bool skip_fillboundary) const
+{
+    if (isTensorOp()) {
+        // the cross terms of the tensor operators are added by apply
+        apply(amrlev, mglev, out, in, BCMode::Homogeneous, StateMode::Solution);
+    } else {
+        applyBC(amrlev, mglev, in, BCMode::Homogeneous, StateMode::Solution,
                 nullptr, skip_fillboundary);
+        Fapply(amrlev, mglev, out, in);
+    }
 #ifdef AMREX_SOFT_PERF_COUNTERS
-        perf_counters.smooth(sol);
+    perf_counters.smooth(in);
+#endif
+}
+
+const MLCellLinOp::SmootherData&
+MLCellLinOp::getSmootherData (int amrlev, int mglev) const
+{
+    if (m_smoother_data.size() < m_num_amr_levels) {
+        m_smoother_data.resize(m_num_amr_levels);
+    }
+    if (m_smoother_data[amrlev].size() < m_num_mg_levels[amrlev]) {
+        m_smoother_data[amrlev].resize(m_num_mg_levels[amrlev]);
+    }
+    SmootherData& sd = m_smoother_data[amrlev][mglev];
+    if (sd.dinv && sd.version == m_coeffs_version) return sd;
+
+    BL_PROFILE("MLCellLinOp::getSmootherData()");
+
+    const int ncomp = getNComp();
+    const BoxArray& ba = m_grids[amrlev][mglev];
+    const DistributionMapping& dm = m_dmap[amrlev][mglev];
+    const auto& factory = *Factory(amrlev,mglev);
+
+    MultiFab diag(ba, dm, ncomp, 0, MFInfo(), factory);
+    MultiFab l1(ba, dm, ncomp, 0, MFInfo(), factory);
+    MultiFab x(ba, dm, ncomp, std::max(1, getNGrow()), MFInfo(), factory);
+    MultiFab Ax(ba, dm, ncomp, 0, MFInfo(), factory);
+    diag.setVal(0.0);
+    l1.setVal(0.0);
+    x.setVal(0.0);
+
+    // The diagonal and the L1 row sums are found by applying the operator
+    // to indicator vectors of the cells of the same color, with no two
+    // cells of a color in a stencil.  The boundary conditions extend the
+    // stencil to cells two apart for maxorder > 1, and further for
+    // maxorder > 4.  For cross stencils reaching one cell, the color
+    // (i+2j+3k) mod 7 in 3D is different for the 7 cells of a stencil, and
+    // for those reaching two cells, (i+3j+4k) mod 13 for the 13 cells.
+    // Otherwise the colors repeat every 2*reach+1 cells in each direction.
+    // In a periodic direction the period has to divide the domain.
+    const Geometry& geom = m_geom[amrlev][mglev];
+    const Box& domain = geom.Domain();
+    const auto dlo = amrex::lbound(domain);
+    const int reach = (maxorder > 1) ? std::max(2, maxorder-2) : 1;
+    int nlinear = 0, ca = 0, cb = 0;
+    if (reach == 1) {
+        nlinear = AMREX_D_PICK(3, 5, 7);
+        ca = 2;
+        cb = 3;
+    } else if (reach == 2) {
+        nlinear = AMREX_D_PICK(5, 10, 13);
+        ca = 3;
+        cb = 4;
+    }
+    bool linear = isCrossStencil() && nlinear > 0;
+    int period[3] = {1, 1, 1};
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        const int n = domain.length(idim);
+        int m = 2*reach+1;
+        if (geom.isPeriodic(idim)) {
+            if (n % nlinear != 0) linear = false;
+            while (m < n && n % m != 0) ++m;
+            m = std::min(m, n);
+        }
+        period[idim] = m;
+    }
+    const Dim3 p{period[0], period[1], period[2]};
+    const int ncolors = linear ? nlinear : p.x*p.y*p.z;
+
+    // The components of the tensor operators are coupled.
+    const int nprobes = isTensorOp() ? ncomp : 1;
+
+    for (int probe = 0; probe < nprobes; ++probe) {
+    for (int color = 0; color < ncolors; ++color)
+    {
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(x, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            const auto& xfab = x.array(mfi);
+            const bool all_comps = (nprobes == 1);
+            AMREX_HOST_DEVICE_FOR_4D ( bx, ncomp, i, j, k, n,
+            {
+                const int ii = i-dlo.x;
+                const int jj = j-dlo.y;
+                const int kk = k-dlo.z;
+                const int c = linear ? (ii + ca*jj + cb*kk) % nlinear
+                    : ii%p.x + p.x*(jj%p.y + p.y*(kk%p.z));
+                const bool on = (all_comps || n == probe) && c == color;
+                xfab(i,j,k,n) = on ? 1.0 : 0.0;
+            });
+        }
+
+        smootherApply(amrlev, mglev, Ax, x, false);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(Ax, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            const auto& xfab = x.const_array(mfi);
+            const auto& axfab = Ax.const_array(mfi);
+            const auto& dfab = diag.array(mfi);
+            const auto& lfab = l1.array(mfi);
+            AMREX_HOST_DEVICE_FOR_4D ( bx, ncomp, i, j, k, n,
+            {
+                const Real ax = axfab(i,j,k,n);
+                if (xfab(i,j,k,n) != 0.0) dfab(i,j,k,n) += ax;
+                lfab(i,j,k,n) += std::abs(ax);
+            });
+        }
+    }}
+
+    // L1-Jacobi uses the row sums, with the sign of the diagonal, and
+    // Chebyshev the diagonal.  Cells with a zero row, e.g., covered cells,
+    // are not updated.
+    const bool use_l1 = (info.smoother == MLSmoother::l1_jacobi);
+    sd.dinv.reset(new MultiFab(ba, dm, ncomp, 0, MFInfo(), factory));
+    MultiFab& dinv = *sd.dinv;
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(dinv, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const auto& dfab = diag.const_array(mfi);
+        const auto& lfab = l1.const_array(mfi);
+        const auto& ifab = dinv.array(mfi);
+        AMREX_HOST_DEVICE_FOR_4D ( bx, ncomp, i, j, k, n,
+        {
+            Real d = dfab(i,j,k,n);
+            if (use_l1) d = (d < 0.0) ? -lfab(i,j,k,n) : lfab(i,j,k,n);
+            ifab(i,j,k,n) = (d != 0.0) ? 1.0/d : 0.0;
+        });
+    }
+
+    sd.lambda_max = 0.0;
+    if (info.smoother == MLSmoother::chebyshev)
+    {
+        // Power iterations for the largest eigenvalue of D^{-1}A from a
+        // fixed pseudo-random start, with the Rayleigh quotient
+        // (x,Ax)/(x,Dx).  The estimate is enlarged by 10 percent because
+        // it is always from below.
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(x, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            const auto& xfab = x.array(mfi);
+            const auto& ifab = dinv.const_array(mfi);
+            AMREX_HOST_DEVICE_FOR_4D ( bx, ncomp, i, j, k, n,
+            {
+                unsigned int h = (i-dlo.x) * 73856093u ^ (j-dlo.y) * 19349663u
+                    ^ (k-dlo.z) * 83492791u ^ n * 2654435761u;
+                h ^= h >> 13; h *= 0x5bd1e995u; h ^= h >> 15;
+                xfab(i,j,k,n) = (ifab(i,j,k,n) != 0.0) ? 0.5 + (h % 1024u) / 1024.0 : 0.0;
+            });
+        }
+
+        MultiFab Dx(ba, dm, ncomp, 0, MFInfo(), factory);
+        Real lambda = 0.0;
+        constexpr int niters = 10;
+        for (int it = 0; it < niters; ++it)
+        {
+            smootherApply(amrlev, mglev, Ax, x, false);
+            MultiFab::Copy(Dx, x, 0, 0, ncomp, 0);
+            MultiFab::Multiply(Dx, diag, 0, 0, ncomp, 0);
+            const Real xAx = xdoty(amrlev, mglev, x, Ax, false);
+            const Real xDx = xdoty(amrlev, mglev, x, Dx, false);
+            if (xDx == 0.0) break;
+            lambda = xAx / xDx;
+            if (lambda <= 0.0) break;
+            const Real scale = 1.0/lambda;
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+            for (MFIter mfi(x, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.tilebox();
+                const auto& xfab = x.array(mfi);
+                const auto& axfab = Ax.const_array(mfi);
+                const auto& ifab = dinv.const_array(mfi);
+                AMREX_HOST_DEVICE_FOR_4D ( bx, ncomp, i, j, k, n,
+                {
+                    xfab(i,j,k,n) = scale * ifab(i,j,k,n) * axfab(i,j,k,n);
+                });
+            }
+        }
+        sd.lambda_max = 1.1*lambda;
+    }
+
+    sd.version = m_coeffs_version;
+    return sd;
+}
+
+void
+MLCellLinOp::jacobiSmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                           bool skip_fillboundary) const
+{
+    BL_PROFILE("MLCellLinOp::jacobiSmooth()");
+
+    const int ncomp = getNComp();
+    const MultiFab& dinv = *getSmootherData(amrlev, mglev).dinv;
+    MultiFab Ax(sol.boxArray(), sol.DistributionMap(), ncomp, 0, MFInfo(),
+                *Factory(amrlev,mglev));
+
+    for (int sweep = 0; sweep < info.smoother_sweeps; ++sweep)
+    {
+        smootherApply(amrlev, mglev, Ax, sol, skip_fillboundary);
+        skip_fillboundary = false;
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-        Fsmooth(amrlev, mglev, sol, rhs, redblack);
+        for (MFIter mfi(sol, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            const auto& solfab = sol.array(mfi);
+            const auto& axfab = Ax.const_array(mfi);
+            const auto& rhsfab = rhs.const_array(mfi);
+            const auto& ifab = dinv.const_array(mfi);
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
+            {
+                mllinop_jacobi_update(tbx, solfab, axfab, rhsfab, ifab, ncomp);
+            });
+        }
+    }
+}
+
+void
+MLCellLinOp::chebyshevSmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                              bool skip_fillboundary) const
+{
+    BL_PROFILE("MLCellLinOp::chebyshevSmooth()");
+
+    const SmootherData& sd = getSmootherData(amrlev, mglev);
+    if (sd.lambda_max <= 0.0) {
+        // e.g., an operator that is zero on this level
+        return;
+    }
+
+    const int ncomp = getNComp();
+    const MultiFab& dinv = *sd.dinv;
+    MultiFab Ax(sol.boxArray(), sol.DistributionMap(), ncomp, 0, MFInfo(),
+                *Factory(amrlev,mglev));
+    MultiFab d(sol.boxArray(), sol.DistributionMap(), ncomp, 0, MFInfo(),
+               *Factory(amrlev,mglev));
+
+    // Chebyshev polynomial in D^{-1}A that damps the eigenvalues in
+    // [0.3*lambda_max, lambda_max], the upper part of the spectrum that
+    // the coarse grids do not correct.
+    const Real b = sd.lambda_max;
+    const Real a = 0.3*b;
+    const Real theta = 0.5*(b+a);
+    const Real delta = 0.5*(b-a);
+    const Real sigma = theta/delta;
+    Real rho = 1.0/sigma;
+
+    for (int step = 0; step < info.smoother_sweeps; ++step)
+    {
+        smootherApply(amrlev, mglev, Ax, sol, skip_fillboundary);
         skip_fillboundary = false;
+
+        Real c1, c2;
+        if (step == 0) {
+            c1 = 0.0;
+            c2 = 1.0/theta;
+        } else {
+            const Real rho_new = 1.0/(2.0*sigma - rho);
+            c1 = rho_new*rho;
+            c2 = 2.0*rho_new/delta;
+            rho = rho_new;
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(sol, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            const auto& solfab = sol.array(mfi);
+            const auto& dfab = d.array(mfi);
+            const auto& axfab = Ax.const_array(mfi);
+            const auto& rhsfab = rhs.const_array(mfi);
+            const auto& ifab = dinv.const_array(mfi);
+            AMREX_LAUNCH_HOST_DEVICE_LAMBDA ( bx, tbx,
+            {
+                mllinop_chebyshev_update(tbx, solfab, dfab, axfab, rhsfab, ifab,
+                                         c1, c2, ncomp);
+            });
+        }
+    }
+}
+
+MLCellLinOp::BlockedSmootherData&
+MLCellLinOp::getBlockedSmootherData (int amrlev, int mglev) const
+{
+    if (m_blocked_smoother_data.size() < m_num_amr_levels) {
+        m_blocked_smoother_data.resize(m_num_amr_levels);
+    }
+    if (m_blocked_smoother_data[amrlev].size() < m_num_mg_levels[amrlev]) {
+        m_blocked_smoother_data[amrlev].resize(m_num_mg_levels[amrlev]);
+    }
+    auto& bdp = m_blocked_smoother_data[amrlev][mglev];
+
+    const int ncomp = getNComp();
+    const Geometry& geom = m_geom[amrlev][mglev];
+    const Box& domain = geom.Domain();
+    const BoxArray& ba = m_grids[amrlev][mglev];
+    const DistributionMapping& dm = m_dmap[amrlev][mglev];
+
+    if (bdp == nullptr)
+    {
+        BL_PROFILE("MLCellLinOp::getBlockedSmootherData()");
+
+        bdp.reset(new BlockedSmootherData);
+        BlockedSmootherData& bd = *bdp;
+
+        // The boxes have to cover the domain, so that the only ghost cells
+        // not from other boxes are outside the physical boundaries, and
+        // they have to be large enough for the redundant work in the
+        // ghost cells to pay off.  The boundary conditions are applied
+        // plane by plane, which for maxorder > 3 would read interior
+        // cells ahead of the sweep.
+        const int depth = 2*info.smoother_sweeps;
+        bool ok = hasFsmoothBlocked() && Gpu::notInLaunchRegion() && maxorder <= 3
+            && depth > 0 && ba.numPts() == domain.numPts();
+        for (int i = 0, N = ba.size(); ok && i < N; ++i) {
+            if (ba[i].shortside() < 4*depth) ok = false;
+        }
+        if (!ok) return bd;
+
+        bd.depth = depth;
+        bd.vbox.define(ba, dm);
+        bd.bcond.define(ba, dm);
+        bd.bcloc.define(ba, dm);
+        bd.mask.define(ba, dm);
+        bd.coef.define(ba, dm);
+
+        Box pdomain = domain;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            if (geom.isPeriodic(idim)) pdomain.grow(idim, depth);
+        }
+        const Real* dx = m_geom[amrlev][0].CellSize();
+        const Real* dxinv = geom.InvCellSize();
+        const int imaxorder = maxorder;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(bd.vbox); mfi.isValid(); ++mfi)
+        {
+            const Box& vbx = amrex::grow(mfi.validbox(), depth) & pdomain;
+            bd.vbox[mfi] = vbx;
+
+            auto& bcond = bd.bcond[mfi];
+            auto& bcloc = bd.bcloc[mfi];
+            bcond.resize(ncomp);
+            bcloc.resize(ncomp);
+            for (int icomp = 0; icomp < ncomp; ++icomp) {
+                MLMGBndry::setBoxBC(bcloc[icomp], bcond[icomp], vbx, domain,
+                                    m_lobc[icomp], m_hibc[icomp], dx, 0, m_coarse_bc_loc,
+                                    m_domain_bloc_lo, m_domain_bloc_hi,
+                                    geom.isPeriodicArray());
+            }
+
+            for (OrientationIter oitr; oitr; ++oitr)
+            {
+                const Orientation ori = oitr();
+                const int idim = ori.coordDir();
+                const int side = ori.isLow() ? 0 : 1;
+                const bool wall = !geom.isPeriodic(idim) && vbx[ori] == domain[ori];
+                const Box& gbx = amrex::adjCell(vbx, ori);
+                auto& m = bd.mask[mfi][ori];
+                auto& f = bd.coef[mfi][ori];
+                m.resize(gbx);
+                m.setVal(wall ? BndryData::outside_domain : BndryData::covered);
+                f.resize(amrex::shift(gbx, idim, ori.isLow() ? 1 : -1), ncomp);
+                f.setVal(0.0);
+                if (!wall) continue;
+
+                const auto& marr = m.const_array();
+                const auto& farr = f.array();
+                const int blen = vbx.length(idim);
+                for (int icomp = 0; icomp < ncomp; ++icomp) {
+                    const BoundCond bct = bcond[icomp][ori];
+                    const Real bcl = bcloc[icomp][ori];
+                    if (idim == 0) {
+                        mllinop_comp_interp_coef0_x(side, gbx, blen, farr, marr, bct, bcl,
+                                                    imaxorder, dxinv[0], icomp);
+                    } else if (idim == 1) {
+                        mllinop_comp_interp_coef0_y(side, gbx, blen, farr, marr, bct, bcl,
+                                                    imaxorder, dxinv[1], icomp);
+                    } else {
+                        mllinop_comp_interp_coef0_z(side, gbx, blen, farr, marr, bct, bcl,
+                                                    imaxorder, dxinv[AMREX_SPACEDIM-1], icomp);
+                    }
+                }
+            }
+        }
+
+        bd.solrhs.reset(new MultiFab(ba, dm, 2*ncomp, depth, MFInfo(), *Factory(amrlev,mglev)));
+    }
+
+    BlockedSmootherData& bd = *bdp;
+    if (bd.depth > 0 && bd.version != m_coeffs_version)
+    {
+        bd.coeffs.clear();
+        for (const MultiFab* c : smootherCoeffs(amrlev, mglev)) {
+            bd.coeffs.emplace_back(new MultiFab(c->boxArray(), c->DistributionMap(), c->nComp(),
+                                                bd.depth, MFInfo(), c->Factory()));
+            MultiFab::Copy(*bd.coeffs.back(), *c, 0, 0, c->nComp(), 0);
+            bd.coeffs.back()->FillBoundary(geom.periodicity());
+        }
+        bd.version = m_coeffs_version;
+    }
+    return bd;
+}
+
+void
+MLCellLinOp::blockedSmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs) const
+{
+    BL_PROFILE("MLCellLinOp::blockedSmooth()");
+
+    const BlockedSmootherData& bd = getBlockedSmootherData(amrlev, mglev);
+    const int depth = bd.depth;
+    const int ncomp = getNComp();
+    const Geometry& geom = m_geom[amrlev][mglev];
+    const Box& domain = geom.Domain();
+    const Real* dxinv = geom.InvCellSize();
+    const int imaxorder = maxorder;
+
+    // sol and rhs go through one exchange of depth ghost cells.  A cell
+    // at a distance from the valid box is up to date for that many
+    // half-sweeps fewer, including the edges and corners.
+    MultiFab& solrhs = *bd.solrhs;
+    MultiFab::Copy(solrhs, sol, 0, 0, ncomp, 0);
+    MultiFab::Copy(solrhs, rhs, 0, ncomp, ncomp, 0);
+    {
+        MLMGStatsTimer stats_timer(m_stats, amrlev, mglev, MLMGStats::communication,
+            m_stats ? MLMGStats::fillBoundaryBytes(solrhs, 2*ncomp, geom.periodicity(), false,
+                                                   sizeof(Real)) : 0);
+        solrhs.FillBoundary(geom.periodicity());
+    }
+#ifdef AMREX_SOFT_PERF_COUNTERS
+    for (int h = 0; h < depth; ++h) perf_counters.smooth(sol);
+#endif
+
+    FArrayBox foofab(Box::TheUnitBox(),ncomp);
+    const auto& foo = foofab.const_array();
+
+    // The half-sweeps run as a wavefront through the planes normal to
+    // the last direction, half-sweep h on the plane behind that of h-1,
+    // so that the planes are reused from cache.  The boundary conditions
+    // of a plane are applied before each half-sweep on it, as applyBC
+    // would before each half-sweep on the whole level.
+    constexpr int D = AMREX_SPACEDIM-1;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(solrhs, MFItInfo().SetDynamic(true)); mfi.isValid(); ++mfi)
+    {
+        const Box& vbx = bd.vbox[mfi];
+        const auto& solfab = solrhs.array(mfi);
+        const Array4<Real const> rhsfab(solfab, ncomp);
+        Vector<Array4<Real const> > coeffs;
+        for (const auto& c : bd.coeffs) {
+            coeffs.push_back(c->const_array(mfi));
+        }
+        const auto& mk = bd.mask[mfi];
+        const auto& cf = bd.coef[mfi];
+        constexpr int hi = AMREX_SPACEDIM;
+        const Array<Array4<int const>,2*AMREX_SPACEDIM> m
+            {AMREX_D_DECL(mk[0].const_array(), mk[1].const_array(), mk[2].const_array()),
+             AMREX_D_DECL(mk[hi].const_array(), mk[hi+1].const_array(), mk[hi+2].const_array())};
+        const Array<Array4<Real const>,2*AMREX_SPACEDIM> f
+            {AMREX_D_DECL(cf[0].const_array(), cf[1].const_array(), cf[2].const_array()),
+             AMREX_D_DECL(cf[hi].const_array(), cf[hi+1].const_array(), cf[hi+2].const_array())};
+        bool wall[2*AMREX_SPACEDIM];
+        for (OrientationIter oitr; oitr; ++oitr) {
+            const Orientation ori = oitr();
+            wall[ori] = !geom.isPeriodic(ori.coordDir()) && vbx[ori] == domain[ori];
+        }
+        const auto& bcond = bd.bcond[mfi];
+        const auto& bcloc = bd.bcloc[mfi];
+
+        Vector<Box> region(depth);
+        for (int h = 0; h < depth; ++h) {
+            region[h] = amrex::grow(mfi.validbox(), depth-1-h) & vbx;
+        }
+
+        const int klo = region[0].smallEnd(D);
+        const int khi = region[0].bigEnd(D);
+        for (int kk = klo; kk <= khi+depth-1; ++kk)
+        {
+            for (int h = 0; h < depth; ++h)
+            {
+                const int k = kk-h;
+                if (k < region[h].smallEnd(D) || k > region[h].bigEnd(D)) continue;
+
+                for (OrientationIter oitr; oitr; ++oitr)
+                {
+                    const Orientation ori = oitr();
+                    if (!wall[ori]) continue;
+                    const int idim = ori.coordDir();
+                    Box gbx = amrex::adjCell(vbx, ori);
+                    if (idim == D) {
+                        if (k != vbx[ori]) continue;
+                    } else {
+                        gbx.setSmall(D, k);
+                        gbx.setBig(D, k);
+                    }
+                    const int side = ori.isLow() ? 0 : 1;
+                    const int blen = vbx.length(idim);
+                    for (int icomp = 0; icomp < ncomp; ++icomp) {
+                        const BoundCond bct = bcond[icomp][ori];
+                        const Real bcl = bcloc[icomp][ori];
+                        if (idim == 0) {
+                            mllinop_apply_bc_x(side, gbx, blen, solfab, m[ori], bct, bcl, foo,
+                                               imaxorder, dxinv[0], 0, icomp);
+                        } else if (idim == 1) {
+                            mllinop_apply_bc_y(side, gbx, blen, solfab, m[ori], bct, bcl, foo,
+                                               imaxorder, dxinv[1], 0, icomp);
+                        } else {
+                            mllinop_apply_bc_z(side, gbx, blen, solfab, m[ori], bct, bcl, foo,
+                                               imaxorder, dxinv[AMREX_SPACEDIM-1], 0, icomp);
+                        }
+                    }
+                }
+
+                Box plane = region[h];
+                plane.setSmall(D, k);
+                plane.setBig(D, k);
+                FsmoothBlocked(amrlev, mglev, plane, vbx, solfab, rhsfab, coeffs, m, f, h%2);
+            }
+        }
     }
+
+    MultiFab::Copy(sol, solrhs, 0, 0, ncomp, 0);
 }
 
 void
@@ -443,7 +1028,15 @@ MLCellLinOp::applyBC (int amrlev, int mglev, MultiFab& in, BCMode bc_mode, State
     const int cross = isCrossStencil();
     const int tensorop = isTensorOp();
     if (!skip_fillboundary) {
-        in.FillBoundary(0, ncomp, m_geom[amrlev][mglev].periodicity(),cross);
+        const bool low_precision = m_single_precision_halo && bc_mode == BCMode::Homogeneous;
+        MLMGStatsTimer stats_timer(m_stats, amrlev, mglev, MLMGStats::communication,
+            m_stats ? MLMGStats::fillBoundaryBytes(in, ncomp, m_geom[amrlev][mglev].periodicity(), cross,
+                                                   low_precision ? sizeof(float) : sizeof(Real)) : 0);
+        if (low_precision) {
+            in.FillBoundaryLowPrecision<float>(0, ncomp, m_geom[amrlev][mglev].periodicity(), cross);
+        } else {
+            in.FillBoundary(0, ncomp, m_geom[amrlev][mglev].periodicity(),cross);
+        }
     }
 
     int flagbc = bc_mode == BCMode::Inhomogeneous;
@@ -735,6 +1328,8 @@ MLCellLinOp::prepareForSolve ()
 {
     BL_PROFILE("MLCellLinOp::prepareForSolve()");
 
+    m_blocked_smoother_data.clear();
+
     const int imaxorder = maxorder;
     const int ncomp = getNComp();
     for (int amrlev = 0;  amrlev < m_num_amr_levels; ++amrlev)
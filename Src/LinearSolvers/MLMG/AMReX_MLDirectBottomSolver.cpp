@@ -0,0 +1,111 @@
+#include <AMReX_MLDirectBottomSolver.H>
+
+#include <algorithm>
+#include <cmath>
+
+namespace amrex {
+
+bool
+MLDirectBottomSolver::setup (long max_band_size)
+{
+    BL_PROFILE("MLDirectBottomSolver::setup()");
+
+    Vector<long> rows, cols;
+    Vector<Real> vals;
+    long bw;
+    if (!probe(rows, cols, vals, bw)) return false;
+    m_bw = bw;
+
+    const long band_size = m_n*(2*m_bw+1);
+    if (band_size > max_band_size)
+    {
+        if (verbose > 0) {
+            amrex::Print() << "MLDirectBottomSolver: band size " << band_size
+                           << " exceeds " << max_band_size << "\n";
+        }
+        return false;
+    }
+
+    gather(rows, cols, vals);
+
+    bool ok = true;
+    if (isLeader())
+    {
+        BL_PROFILE("MLDirectBottomSolver::factor");
+
+        const long w = 2*m_bw+1;
+        m_band.assign(band_size, 0.0);
+        for (long i = 0, N = rows.size(); i < N; ++i) {
+            m_band[rows[i]*w + cols[i]-rows[i] + m_bw] += vals[i];
+        }
+
+        ok = factor();
+    }
+
+    ok = leaderStatus(ok);
+
+    if (verbose > 0) {
+        amrex::Print() << "MLDirectBottomSolver: " << m_n << " unknowns, bandwidth "
+                       << m_bw << (ok ? "" : ", factorization failed") << "\n";
+    }
+
+    return ok;
+}
+
+bool
+MLDirectBottomSolver::factor ()
+{
+    // LU without pivoting, which keeps the factors within the band.
+    const long w = 2*m_bw+1;
+    for (long k = 0; k < m_n; ++k)
+    {
+        const Real piv = m_band[k*w + m_bw];
+        if (!(std::abs(piv) > 0.0)) return false;
+
+        const long iend = std::min(m_n-1, k+m_bw);
+        Real const* rowk = m_band.data() + k*w + m_bw - k;
+#ifdef _OPENMP
+#pragma omp parallel for if (iend-k > 64)
+#endif
+        for (long i = k+1; i <= iend; ++i)
+        {
+            Real* rowi = m_band.data() + i*w + m_bw - i;
+            if (rowi[k] != 0.0) {
+                const Real l = rowi[k] / piv;
+                rowi[k] = l;
+                for (long j = k+1; j <= iend; ++j) {
+                    rowi[j] -= l*rowk[j];
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void
+MLDirectBottomSolver::solveGathered (Vector<Real>& v)
+{
+    BL_PROFILE("MLDirectBottomSolver::solve()");
+
+    const long w = 2*m_bw+1;
+    for (long i = 0; i < m_n; ++i)
+    {
+        Real const* rowi = m_band.data() + i*w + m_bw - i;
+        Real s = v[i];
+        for (long j = std::max(long(0),i-m_bw); j < i; ++j) {
+            s -= rowi[j]*v[j];
+        }
+        v[i] = s;
+    }
+    for (long i = m_n-1; i >= 0; --i)
+    {
+        Real const* rowi = m_band.data() + i*w + m_bw - i;
+        Real s = v[i];
+        for (long j = i+1, jend = std::min(m_n-1,i+m_bw); j <= jend; ++j) {
+            s -= rowi[j]*v[j];
+        }
+        v[i] = s / rowi[i];
+    }
+}
+
+}
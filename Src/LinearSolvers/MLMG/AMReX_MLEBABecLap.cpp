@@ -126,6 +126,7 @@ MLEBABecLap::~MLEBABecLap ()
 void
 MLEBABecLap::setScalars (Real a, Real b)
 {
+    if (!coeffsChanged(m_a_scalar, a) && !coeffsChanged(m_b_scalar, b)) return;
     m_a_scalar = a;
     m_b_scalar = b;
     if (a == 0.0)
@@ -140,6 +141,7 @@ MLEBABecLap::setScalars (Real a, Real b)
 void
 MLEBABecLap::setACoeffs (int amrlev, const MultiFab& alpha)
 {
+    if (!coeffsChanged(m_a_coeffs[amrlev][0], 0, alpha, 0, 1)) return;
     MultiFab::Copy(m_a_coeffs[amrlev][0], alpha, 0, 0, 1, 0);
     m_needs_update = true;
 }
@@ -148,6 +150,13 @@ void
 MLEBABecLap::setBCoeffs (int amrlev, const Array<MultiFab const*,AMREX_SPACEDIM>& beta)
 {
     const int ncomp = getNComp();
+    bool changed = false;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        for (int icomp = 0; icomp < ncomp && !changed; ++icomp) {
+            changed = coeffsChanged(m_b_coeffs[amrlev][0][idim], icomp, *beta[idim], 0, 1);
+        }
+    }
+    if (!changed) return;
     for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
         for (int icomp = 0; icomp < ncomp; ++icomp) {
             MultiFab::Copy(m_b_coeffs[amrlev][0][idim], *beta[idim], 0, icomp, 1, 0);
@@ -162,6 +171,8 @@ MLEBABecLap::setEBDirichlet (int amrlev, const MultiFab& phi, const MultiFab& be
     // todo: gpu
     Gpu::LaunchSafeGuard lg(false);
 
+    ++m_coeffs_version;
+
     const int ncomp = getNComp();
     if (m_eb_phi[amrlev] == nullptr) {
         const int mglev = 0;
@@ -218,6 +229,8 @@ MLEBABecLap::setEBHomogDirichlet (int amrlev, const MultiFab& beta)
     // todo: gpu
     Gpu::LaunchSafeGuard lg(false);
 
+    ++m_coeffs_version;
+
     const int ncomp = getNComp();
     if (m_eb_phi[amrlev] == nullptr) {
         const int mglev = 0;
@@ -1073,6 +1086,9 @@ MLEBABecLap::applyBC (int amrlev, int mglev, MultiFab& in, BCMode bc_mode, State
     const int ncomp = getNComp();
     if (!skip_fillboundary) {
         const int cross = false;
+        MLMGStatsTimer stats_timer(m_stats, amrlev, mglev, MLMGStats::communication,
+            m_stats ? MLMGStats::fillBoundaryBytes(in, ncomp, m_geom[amrlev][mglev].periodicity(),
+                                                   cross, sizeof(Real)) : 0);
         in.FillBoundary(0, ncomp, m_geom[amrlev][mglev].periodicity(),cross);
     }
 
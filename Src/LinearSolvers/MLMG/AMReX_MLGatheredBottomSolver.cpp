@@ -0,0 +1,397 @@
+#include <AMReX_MLGatheredBottomSolver.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_BoxIterator.H>
+
+#include <algorithm>
+#include <cmath>
+
+namespace amrex {
+
+constexpr int MLGatheredBottomSolver::probe_radius;
+
+namespace {
+
+#ifdef BL_USE_MPI
+//
+// Gathers local from all ranks of group onto its rank 0, and then from
+// all leaders onto all leaders.  On the leaders, counts and displs are
+// those of the group members in the result.
+//
+template <class T>
+void
+gather_to_leaders (const Vector<T>& local, Vector<T>& result,
+                   MPI_Comm group, MPI_Comm leaders,
+                   Vector<int>& group_counts, Vector<int>& group_displs,
+                   Vector<int>& leader_counts, Vector<int>& leader_displs)
+{
+    const MPI_Datatype typ = ParallelDescriptor::Mpi_typemap<T>::type();
+
+    int gsize, grank;
+    MPI_Comm_size(group, &gsize);
+    MPI_Comm_rank(group, &grank);
+
+    int n = static_cast<int>(local.size());
+    group_counts.resize(gsize);
+    MPI_Gather(&n, 1, MPI_INT, group_counts.data(), 1, MPI_INT, 0, group);
+
+    Vector<T> group_data;
+    if (grank == 0) {
+        group_displs.resize(gsize);
+        int ntot = 0;
+        for (int i = 0; i < gsize; ++i) {
+            group_displs[i] = ntot;
+            ntot += group_counts[i];
+        }
+        group_data.resize(ntot);
+    }
+    MPI_Gatherv(local.data(), n, typ, group_data.data(), group_counts.data(),
+                group_displs.data(), typ, 0, group);
+
+    if (leaders != MPI_COMM_NULL)
+    {
+        int lsize, lrank;
+        MPI_Comm_size(leaders, &lsize);
+        MPI_Comm_rank(leaders, &lrank);
+
+        int ng = static_cast<int>(group_data.size());
+        leader_counts.resize(lsize);
+        MPI_Allgather(&ng, 1, MPI_INT, leader_counts.data(), 1, MPI_INT, leaders);
+
+        leader_displs.resize(lsize);
+        int ntot = 0;
+        for (int i = 0; i < lsize; ++i) {
+            leader_displs[i] = ntot;
+            ntot += leader_counts[i];
+        }
+        result.resize(ntot);
+        MPI_Allgatherv(group_data.data(), ng, typ, result.data(), leader_counts.data(),
+                       leader_displs.data(), typ, leaders);
+    }
+}
+#endif
+
+}
+
+MLGatheredBottomSolver::MLGatheredBottomSolver (MLLinOp& a_lp, bool a_per_node)
+    : Lp(a_lp),
+      amrlev(0),
+      mglev(a_lp.NMGLevels(0)-1),
+      per_node(a_per_node)
+{}
+
+MLGatheredBottomSolver::~MLGatheredBottomSolver ()
+{
+#ifdef BL_USE_MPI
+    if (m_group_comm != MPI_COMM_NULL) MPI_Comm_free(&m_group_comm);
+    if (m_leader_comm != MPI_COMM_NULL) MPI_Comm_free(&m_leader_comm);
+#endif
+}
+
+long
+MLGatheredBottomSolver::globalIndex (const IntVect& iv) const noexcept
+{
+    // In periodic directions the cells are ordered 0, n-1, 1, n-2, ...
+    // so that the periodic neighbors stay close to the diagonal.
+    long r = 0;
+    long stride = 1;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const int n = m_len[idim];
+        int i = iv[idim] - m_domain.smallEnd(idim);
+        if (m_fold[idim]) {
+            i = (2*i < n) ? 2*i : 2*(n-1-i)+1;
+        }
+        r += i*stride;
+        stride *= n;
+    }
+    return r;
+}
+
+bool
+MLGatheredBottomSolver::isLeader () const noexcept
+{
+#ifdef BL_USE_MPI
+    return m_leader_comm != MPI_COMM_NULL;
+#else
+    return true;
+#endif
+}
+
+bool
+MLGatheredBottomSolver::leaderStatus (bool flag) const
+{
+    int r = flag;
+#ifdef BL_USE_MPI
+    MPI_Bcast(&r, 1, MPI_INT, 0, m_group_comm);
+#endif
+    return r;
+}
+
+bool
+MLGatheredBottomSolver::probe (Vector<long>& rows, Vector<long>& cols, Vector<Real>& vals, long& bw)
+{
+    BL_PROFILE("MLGatheredBottomSolver::probe()");
+
+    if (Lp.getNComp() != 1 || !Lp.isCellCentered()) return false;
+
+#ifdef AMREX_USE_GPU
+    // The matrix, right-hand side and solution are accessed element by
+    // element on the host, and the fabs need not be accessible there.
+    if (verbose > 0) {
+        amrex::Print() << "MLGatheredBottomSolver: not available on gpus\n";
+    }
+    return false;
+#endif
+
+    const Geometry& geom = Lp.m_geom[amrlev][mglev];
+    const BoxArray& ba = Lp.m_grids[amrlev][mglev];
+    const DistributionMapping& dm = Lp.m_dmap[amrlev][mglev];
+
+    m_domain = geom.Domain();
+    m_len = m_domain.length();
+    m_n = m_domain.numPts();
+
+    // Each probe has ones on a lattice of cells with spacing stride.  The
+    // spacing is large enough that each cell sees at most one of them
+    // within probe_radius, also across periodic boundaries.
+    IntVect stride;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        m_fold[idim] = geom.isPeriodic(idim);
+        const int n = m_len[idim];
+        int s = 2*probe_radius+1;
+        if (m_fold[idim]) {
+            while (s < n && n % s != 0) ++s;
+            s = std::min(s, n);
+        }
+        stride[idim] = s;
+    }
+    const Box color_box(IntVect::TheZeroVector(), stride-1);
+
+    const int ng = std::max(1, Lp.getNGrow());
+    MultiFab in (ba, dm, 1, ng, MFInfo(), *Lp.Factory(amrlev,mglev));
+    MultiFab out(ba, dm, 1, 0 , MFInfo(), *Lp.Factory(amrlev,mglev));
+
+    m_local_index.clear();
+    for (MFIter mfi(out); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        for (BoxIterator bi(bx); bi.ok(); ++bi) {
+            m_local_index.push_back(globalIndex(bi()));
+        }
+    }
+
+    rows.clear();
+    cols.clear();
+    vals.clear();
+    bw = 0;
+
+    for (BoxIterator ci(color_box); ci.ok(); ++ci)
+    {
+        const IntVect color = ci();
+
+        in.setVal(0.0);
+        for (MFIter mfi(in); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            FArrayBox& fab = in[mfi];
+            for (BoxIterator bi(bx); bi.ok(); ++bi) {
+                const IntVect& iv = bi();
+                bool on = true;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    on = on && (iv[idim]-m_domain.smallEnd(idim)) % stride[idim] == color[idim];
+                }
+                if (on) fab(iv) = 1.0;
+            }
+        }
+
+        Lp.apply(amrlev, mglev, out, in, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
+
+        for (MFIter mfi(out); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            const FArrayBox& fab = out[mfi];
+            for (BoxIterator bi(bx); bi.ok(); ++bi)
+            {
+                const IntVect& p = bi();
+                const Real v = fab(p);
+                if (v == 0.0) continue;
+
+                // the probed cell this row sees
+                IntVect q;
+                bool found = true;
+                for (int idim = 0; idim < AMREX_SPACEDIM && found; ++idim) {
+                    const int lo = m_domain.smallEnd(idim);
+                    const int n = m_len[idim];
+                    found = false;
+                    for (int o = -probe_radius; o <= probe_radius && !found; ++o) {
+                        int qi = p[idim] + o - lo;
+                        if (m_fold[idim]) {
+                            qi = ((qi % n) + n) % n;
+                        } else if (qi < 0 || qi >= n) {
+                            continue;
+                        }
+                        if (qi % stride[idim] == color[idim]) {
+                            q[idim] = qi + lo;
+                            found = true;
+                        }
+                    }
+                }
+                AMREX_ALWAYS_ASSERT_WITH_MESSAGE(found,
+                    "MLGatheredBottomSolver: stencil is wider than the probe radius");
+
+                const long row = globalIndex(p);
+                const long col = globalIndex(q);
+                rows.push_back(row);
+                cols.push_back(col);
+                vals.push_back(v);
+                bw = std::max(bw, std::abs(row-col));
+            }
+        }
+    }
+
+#ifdef BL_USE_MPI
+    MPI_Allreduce(MPI_IN_PLACE, &bw, 1, ParallelDescriptor::Mpi_typemap<long>::type(), MPI_MAX,
+                  Lp.BottomCommunicator());
+#endif
+
+    return true;
+}
+
+void
+MLGatheredBottomSolver::gather (Vector<long>& rows, Vector<long>& cols, Vector<Real>& vals, bool pin)
+{
+    BL_PROFILE("MLGatheredBottomSolver::gather()");
+
+#ifdef BL_USE_MPI
+    const MPI_Comm comm = Lp.BottomCommunicator();
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    if (per_node) {
+        MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &m_group_comm);
+    } else {
+        MPI_Comm_dup(comm, &m_group_comm);
+    }
+    int grank;
+    MPI_Comm_rank(m_group_comm, &grank);
+    MPI_Comm_split(comm, (grank == 0) ? 0 : MPI_UNDEFINED, rank, &m_leader_comm);
+
+    Vector<long> all_rows, all_cols;
+    Vector<Real> all_vals;
+    Vector<int> gc, gd, lc, ld;
+    gather_to_leaders(rows, all_rows, m_group_comm, m_leader_comm, gc, gd, lc, ld);
+    gather_to_leaders(cols, all_cols, m_group_comm, m_leader_comm, gc, gd, lc, ld);
+    gather_to_leaders(vals, all_vals, m_group_comm, m_leader_comm, gc, gd, lc, ld);
+    gather_to_leaders(m_local_index, m_gathered_index, m_group_comm, m_leader_comm,
+                      m_group_counts, m_group_displs, m_leader_counts, m_leader_displs);
+    rows = std::move(all_rows);
+    cols = std::move(all_cols);
+    vals = std::move(all_vals);
+#else
+    m_gathered_index = m_local_index;
+#endif
+
+    if (!isLeader()) return;
+
+    Vector<char> covered(m_n, 0);
+    for (long i : m_gathered_index) covered[i] = 1;
+
+    if (pin && Lp.isBottomSingular())
+    {
+        m_pinned = std::find(covered.begin(), covered.end(), 1) - covered.begin();
+        long m = 0;
+        for (long i = 0, N = rows.size(); i < N; ++i) {
+            if (rows[i] != m_pinned && cols[i] != m_pinned) {
+                rows[m] = rows[i];
+                cols[m] = cols[i];
+                vals[m] = vals[i];
+                ++m;
+            }
+        }
+        rows.resize(m);
+        cols.resize(m);
+        vals.resize(m);
+        covered[m_pinned] = 0;
+    }
+
+    for (long i = 0; i < m_n; ++i) {
+        if (!covered[i]) {
+            rows.push_back(i);
+            cols.push_back(i);
+            vals.push_back(1.0);
+        }
+    }
+}
+
+void
+MLGatheredBottomSolver::solve (MultiFab& x, const MultiFab& b)
+{
+    Vector<Real> local;
+    local.reserve(m_local_index.size());
+    for (MFIter mfi(b); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const FArrayBox& fab = b[mfi];
+        for (BoxIterator bi(bx); bi.ok(); ++bi) {
+            local.push_back(fab(bi()));
+        }
+    }
+
+    Vector<Real> gathered;
+#ifdef BL_USE_MPI
+    const MPI_Datatype typ = ParallelDescriptor::Mpi_typemap<Real>::type();
+    Vector<Real> group_data;
+    int lrank = 0;
+    if (isLeader()) {
+        MPI_Comm_rank(m_leader_comm, &lrank);
+        group_data.resize(m_leader_counts[lrank]);
+    }
+    MPI_Gatherv(local.data(), static_cast<int>(local.size()), typ, group_data.data(), m_group_counts.data(),
+                m_group_displs.data(), typ, 0, m_group_comm);
+    if (isLeader()) {
+        gathered.resize(m_gathered_index.size());
+        MPI_Allgatherv(group_data.data(), static_cast<int>(group_data.size()), typ, gathered.data(),
+                       m_leader_counts.data(), m_leader_displs.data(), typ, m_leader_comm);
+    }
+#else
+    gathered = std::move(local);
+#endif
+
+    if (isLeader())
+    {
+        Vector<Real> v(m_n, 0.0);
+        for (long i = 0, N = m_gathered_index.size(); i < N; ++i) {
+            v[m_gathered_index[i]] = gathered[i];
+        }
+        if (m_pinned >= 0) v[m_pinned] = 0.0;
+
+        solveGathered(v);
+
+#ifdef BL_USE_MPI
+        const int offset = m_leader_displs[lrank];
+        for (int i = 0, N = group_data.size(); i < N; ++i) {
+            group_data[i] = v[m_gathered_index[offset+i]];
+        }
+#else
+        for (long i = 0, N = m_gathered_index.size(); i < N; ++i) {
+            gathered[i] = v[m_gathered_index[i]];
+        }
+        local = std::move(gathered);
+#endif
+    }
+
+#ifdef BL_USE_MPI
+    MPI_Scatterv(group_data.data(), m_group_counts.data(), m_group_displs.data(), typ,
+                 local.data(), static_cast<int>(local.size()), typ, 0, m_group_comm);
+#endif
+
+    long i = 0;
+    for (MFIter mfi(x); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        FArrayBox& fab = x[mfi];
+        for (BoxIterator bi(bx); bi.ok(); ++bi) {
+            fab(bi()) = local[i++];
+        }
+    }
+}
+
+}
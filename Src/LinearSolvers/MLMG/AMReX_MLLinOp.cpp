@@ -8,6 +8,7 @@
 #include <AMReX_MLCellLinOp.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_Machine.H>
+#include <AMReX_Reduce.H>
 
 #ifdef AMREX_USE_EB
 #include <AMReX_EB2.H>
@@ -462,6 +463,72 @@ MLLinOp::make (Vector<Vector<MultiFab> >& mf, int nc, int ng) const
     }
 }
 
+bool
+MLLinOp::coeffsChanged (const MultiFab& dst, int dcomp, const MultiFab& src, int scomp, int ncomp)
+{
+    if (m_frozen)
+    {
+        BL_PROFILE("MLLinOp::coeffsChanged()");
+
+        int ndiff = 0;
+        if (Gpu::notInLaunchRegion())
+        {
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:ndiff)
+#endif
+            for (MFIter mfi(dst,true); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.tilebox();
+                auto const& d = dst.const_array(mfi);
+                auto const& s = src.const_array(mfi);
+                amrex::LoopOnCpu(bx, ncomp,
+                [=,&ndiff] (int i, int j, int k, int n) noexcept
+                {
+                    ndiff += (d(i,j,k,dcomp+n) != s(i,j,k,scomp+n));
+                });
+            }
+        }
+        else
+        {
+            ReduceOps<ReduceOpSum> reduce_op;
+            ReduceData<int> reduce_data(reduce_op);
+            using ReduceTuple = typename decltype(reduce_data)::Type;
+
+            for (MFIter mfi(dst); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.validbox();
+                auto const& d = dst.const_array(mfi);
+                auto const& s = src.const_array(mfi);
+                reduce_op.eval(bx, reduce_data,
+                [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+                {
+                    int r = 0;
+                    for (int n = 0; n < ncomp; ++n) {
+                        r += (d(i,j,k,dcomp+n) != s(i,j,k,scomp+n));
+                    }
+                    return {r};
+                });
+            }
+            ReduceTuple rv = reduce_data.value();
+            ndiff = amrex::get<0>(rv);
+        }
+
+        ParallelAllReduce::Sum(ndiff, m_default_comm);
+        if (ndiff == 0) return false;
+    }
+
+    ++m_coeffs_version;
+    return true;
+}
+
+bool
+MLLinOp::coeffsChanged (Real old_val, Real new_val) noexcept
+{
+    if (m_frozen && old_val == new_val) return false;
+    ++m_coeffs_version;
+    return true;
+}
+
 void
 MLLinOp::setDomainBC (const Array<BCType,AMREX_SPACEDIM>& a_lobc,
                       const Array<BCType,AMREX_SPACEDIM>& a_hibc) noexcept
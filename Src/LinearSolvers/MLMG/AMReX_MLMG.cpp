@@ -40,6 +40,14 @@
 
 namespace amrex {
 
+namespace {
+    // Bytes of n MultiFabs laid out like mf, if statistics are collected.
+    long stats_bytes (const MLMGStats* s, const MultiFab& mf, int ncomp, int n = 1)
+    {
+        return s ? n*MLMGStats::bytesOf(mf, ncomp) : 0;
+    }
+}
+
 MLMG::MLMG (MLLinOp& a_lp)
     : linop(a_lp),
       namrlevs(a_lp.NAMRLevels()),
@@ -74,8 +82,15 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
 
     Real composite_norminf;
 
+    linop.m_single_precision_halo = single_precision_halo && linop.isCellCentered();
+
     prepareForSolve(a_sol, a_rhs);
 
+    if (collect_stats) {
+        stats.define(linop.m_num_mg_levels);
+    }
+    linop.m_stats = statsPtr();
+
     computeMLResidual(finest_amr_lev);
 
     int ncomp = linop.getNComp();
@@ -86,6 +101,10 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
     if (!is_nsolve) {
         ParallelAllReduce::Max<Real>({resnorm0, rhsnorm0}, ParallelContext::CommunicatorSub());
 
+        if (collect_stats) {
+            stats.residual.push_back(resnorm0);
+        }
+
         if (verbose >= 1)
         {
             amrex::Print() << "MLMG: Initial rhs               = " << rhsnorm0 << "\n"
@@ -127,6 +146,11 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
 
             Real fine_norminf = ResNormInf(finest_amr_lev);
             composite_norminf = fine_norminf;
+            if (collect_stats) {
+                const Real prev = stats.residual.back();
+                stats.convergence_factor.push_back(prev > 0.0 ? fine_norminf/prev : 0.0);
+                stats.residual.push_back(fine_norminf);
+            }
             if (verbose >= 2) {
                 amrex::Print() << "MLMG: Iteration " << std::setw(3) << iter+1 << " Fine resid/"
                                << norm_name << " = " << fine_norminf/max_norm << "\n";
@@ -182,6 +206,13 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
     }
 
     timer[solve_time] = amrex::second() - solve_start_time;
+    if (collect_stats) {
+        stats.solve_time = timer[solve_time];
+        stats.iter_time = timer[iter_time];
+        stats.bottom_time = timer[bottom_time];
+        stats.reduce(ParallelContext::CommunicatorSub());
+    }
+    linop.m_stats = nullptr;
     if (verbose >= 1) {
         ParallelReduce::Max<Real>(timer.data(), timer.size(), 0,
                                   ParallelContext::CommunicatorSub());
@@ -272,7 +303,10 @@ MLMG::computeMLResidual (int amrlevmax)
     BL_PROFILE("MLMG::computeMLResidual()");
 
     const int mglev = 0;
+    const int ncomp = linop.getNComp();
     for (int alev = amrlevmax; alev >= 0; --alev) {
+        MLMGStatsTimer stats_timer(statsPtr(), alev, mglev, MLMGStats::apply,
+                                   stats_bytes(statsPtr(), *sol[alev], ncomp, 3));
         const MultiFab* crse_bcdata = (alev > 0) ? sol[alev-1] : nullptr;
         linop.solutionResidual(alev, res[alev][mglev], *sol[alev], rhs[alev], crse_bcdata);
         if (alev < finest_amr_lev) {
@@ -292,6 +326,9 @@ MLMG::computeResidual (int alev)
     const MultiFab& b = rhs[alev];
     MultiFab& r = res[alev][0];
 
+    MLMGStatsTimer stats_timer(statsPtr(), alev, 0, MLMGStats::apply,
+                               stats_bytes(statsPtr(), x, linop.getNComp(), 3));
+
     const MultiFab* crse_bcdata = nullptr;
     if (alev > 0) {
         crse_bcdata = sol[alev-1];
@@ -319,18 +356,29 @@ MLMG::computeResWithCrseSolFineCor (int calev, int falev)
     MultiFab& fine_res = res[falev][0];
     MultiFab& fine_rescor = rescor[falev][0];
     
-    const MultiFab* crse_bcdata = nullptr;
-    if (calev > 0) {
-        crse_bcdata = sol[calev-1];
+    {
+        MLMGStatsTimer stats_timer(statsPtr(), calev, 0, MLMGStats::apply,
+                                   stats_bytes(statsPtr(), crse_sol, ncomp, 3));
+        const MultiFab* crse_bcdata = nullptr;
+        if (calev > 0) {
+            crse_bcdata = sol[calev-1];
+        }
+        linop.solutionResidual(calev, crse_res, crse_sol, crse_rhs, crse_bcdata);
     }
-    linop.solutionResidual(calev, crse_res, crse_sol, crse_rhs, crse_bcdata);
 
-    linop.correctionResidual(falev, 0, fine_rescor, fine_cor, fine_res, BCMode::Homogeneous);
-    MultiFab::Copy(fine_res, fine_rescor, 0, 0, ncomp, nghost);
+    {
+        MLMGStatsTimer stats_timer(statsPtr(), falev, 0, MLMGStats::apply,
+                                   stats_bytes(statsPtr(), fine_cor, ncomp, 3));
+        linop.correctionResidual(falev, 0, fine_rescor, fine_cor, fine_res, BCMode::Homogeneous);
+        MultiFab::Copy(fine_res, fine_rescor, 0, 0, ncomp, nghost);
 
-    linop.reflux(calev, crse_res, crse_sol, crse_rhs, fine_res, fine_sol, fine_rhs);
+        linop.reflux(calev, crse_res, crse_sol, crse_rhs, fine_res, fine_sol, fine_rhs);
+    }
 
     if (linop.isCellCentered()) {
+        MLMGStatsTimer stats_timer(statsPtr(), falev, 0, MLMGStats::restriction,
+                                   stats_bytes(statsPtr(), fine_res, ncomp)
+                                   + stats_bytes(statsPtr(), crse_res, ncomp));
         const int amrrr = linop.AMRRefRatio(calev);
 #ifdef AMREX_USE_EB
         amrex::EB_average_down(fine_res, crse_res, 0, ncomp, amrrr);
@@ -356,6 +404,9 @@ MLMG::computeResWithCrseCorFineCor (int falev)
     MultiFab& fine_res = res[falev][0];
     MultiFab& fine_rescor = rescor[falev][0];
 
+    MLMGStatsTimer stats_timer(statsPtr(), falev, 0, MLMGStats::apply,
+                               stats_bytes(statsPtr(), fine_cor, ncomp, 3));
+
     // fine_rescor = fine_res - L(fine_cor)
     linop.correctionResidual(falev, 0, fine_rescor, fine_cor, fine_res,
                              BCMode::Inhomogeneous, &crse_cor);
@@ -397,6 +448,7 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
     BL_PROFILE("MLMG::mgVcycle()");
 
     const int mglev_bottom = linop.NMGLevels(amrlev) - 1;
+    const int ncomp = linop.getNComp();
 
     for (int mglev = mglev_top; mglev < mglev_bottom; ++mglev)
     {
@@ -411,11 +463,15 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
         }
 
         cor[amrlev][mglev]->setVal(0.0);
-        bool skip_fillboundary = true;
-        for (int i = 0; i < nu1; ++i) {
-            linop.smooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev],
-                         skip_fillboundary);
-            skip_fillboundary = false;
+        {
+            MLMGStatsTimer stats_timer(statsPtr(), amrlev, mglev, MLMGStats::smooth,
+                                       stats_bytes(statsPtr(), res[amrlev][mglev], ncomp, 3*nu1));
+            bool skip_fillboundary = true;
+            for (int i = 0; i < nu1; ++i) {
+                linop.smooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev],
+                             skip_fillboundary);
+                skip_fillboundary = false;
+            }
         }
 
         // rescor = res - L(cor)
@@ -429,7 +485,12 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
         }
 
         // res_crse = R(rescor_fine); this provides res/b to the level below
-        linop.restriction(amrlev, mglev+1, res[amrlev][mglev+1], rescor[amrlev][mglev]);
+        {
+            MLMGStatsTimer stats_timer(statsPtr(), amrlev, mglev, MLMGStats::restriction,
+                                       stats_bytes(statsPtr(), rescor[amrlev][mglev], ncomp)
+                                       + stats_bytes(statsPtr(), res[amrlev][mglev+1], ncomp));
+            linop.restriction(amrlev, mglev+1, res[amrlev][mglev+1], rescor[amrlev][mglev]);
+        }
 
     }
 
@@ -460,11 +521,15 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
                            << "       Norm before smooth " << norm << "\n";
         }
         cor[amrlev][mglev_bottom]->setVal(0.0);
-        bool skip_fillboundary = true;
-        for (int i = 0; i < nu1; ++i) {
-            linop.smooth(amrlev, mglev_bottom, *cor[amrlev][mglev_bottom], res[amrlev][mglev_bottom],
-                         skip_fillboundary);
-            skip_fillboundary = false;
+        {
+            MLMGStatsTimer stats_timer(statsPtr(), amrlev, mglev_bottom, MLMGStats::smooth,
+                                       stats_bytes(statsPtr(), res[amrlev][mglev_bottom], ncomp, 3*nu1));
+            bool skip_fillboundary = true;
+            for (int i = 0; i < nu1; ++i) {
+                linop.smooth(amrlev, mglev_bottom, *cor[amrlev][mglev_bottom], res[amrlev][mglev_bottom],
+                             skip_fillboundary);
+                skip_fillboundary = false;
+            }
         }
         if (verbose >= 4)
         {
@@ -489,8 +554,12 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
             amrex::Print() << "AT LEVEL "  << amrlev << " " << mglev
                            << "   UP: Norm before smooth " << norm << "\n";
         }
-        for (int i = 0; i < nu2; ++i) {
-            linop.smooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev]);
+        {
+            MLMGStatsTimer stats_timer(statsPtr(), amrlev, mglev, MLMGStats::smooth,
+                                       stats_bytes(statsPtr(), res[amrlev][mglev], ncomp, 3*nu2));
+            for (int i = 0; i < nu2; ++i) {
+                linop.smooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev]);
+            }
         }
 
 	if (cf_strategy == CFStrategy::ghostnodes) computeResOfCorrection(amrlev, mglev);
@@ -522,6 +591,9 @@ MLMG::mgFcycle ()
 
     for (int mglev = 1; mglev <= mg_bottom_lev; ++mglev)
     {
+        MLMGStatsTimer stats_timer(statsPtr(), amrlev, mglev-1, MLMGStats::restriction,
+                                   stats_bytes(statsPtr(), res[amrlev][mglev-1], ncomp)
+                                   + stats_bytes(statsPtr(), res[amrlev][mglev], ncomp));
         // TODO: for EB cell-centered, we need to use EB_average_down
         amrex::average_down(res[amrlev][mglev-1], res[amrlev][mglev], 0, ncomp, ratio);
     }
@@ -559,6 +631,10 @@ MLMG::interpCorrection (int alev)
     const MultiFab& crse_cor = *cor[alev-1][0];
     MultiFab& fine_cor = *cor[alev][0];
 
+    MLMGStatsTimer stats_timer(statsPtr(), alev, 0, MLMGStats::interpolation,
+                               stats_bytes(statsPtr(), fine_cor, ncomp)
+                               + stats_bytes(statsPtr(), crse_cor, ncomp));
+
     BoxArray ba = fine_cor.boxArray();
     const int amrrr = linop.AMRRefRatio(alev-1);
     IntVect refratio{amrrr};
@@ -703,6 +779,10 @@ MLMG::interpCorrection (int alev, int mglev)
     int nghost = 0;
     if (cf_strategy == CFStrategy::ghostnodes) nghost = linop.getNGrow();
 
+    MLMGStatsTimer stats_timer(statsPtr(), alev, mglev, MLMGStats::interpolation,
+                               stats_bytes(statsPtr(), fine_cor, ncomp)
+                               + stats_bytes(statsPtr(), crse_cor, ncomp));
+
     const Geometry& crse_geom = linop.Geom(alev,mglev+1);
     const int refratio = 2;
 
@@ -825,6 +905,10 @@ MLMG::addInterpCorrection (int alev, int mglev)
     const MultiFab& crse_cor = *cor[alev][mglev+1];
     MultiFab&       fine_cor = *cor[alev][mglev  ];
 
+    MLMGStatsTimer stats_timer(statsPtr(), alev, mglev, MLMGStats::interpolation,
+                               stats_bytes(statsPtr(), fine_cor, ncomp, 2)
+                               + stats_bytes(statsPtr(), crse_cor, ncomp));
+
     const int refratio = 2;
     MultiFab cfine;
     const MultiFab* cmf;
@@ -857,6 +941,8 @@ MLMG::computeResOfCorrection (int amrlev, int mglev)
     MultiFab& x = *cor[amrlev][mglev];
     const MultiFab& b = res[amrlev][mglev];
     MultiFab& r = rescor[amrlev][mglev];
+    MLMGStatsTimer stats_timer(statsPtr(), amrlev, mglev, MLMGStats::apply,
+                               stats_bytes(statsPtr(), r, linop.getNComp(), 3));
     linop.correctionResidual(amrlev, mglev, r, x, b, BCMode::Homogeneous);
 }
 
@@ -866,6 +952,10 @@ MLMG::computeResOfCorrection (int amrlev, int mglev)
 void
 MLMG::bottomSolve ()
 {
+    const int mglev_bottom = linop.NMGLevels(0) - 1;
+    MLMGStatsTimer stats_timer(statsPtr(), 0, mglev_bottom, MLMGStats::bottom,
+                               stats_bytes(statsPtr(), res[0][mglev_bottom], linop.getNComp(), 2));
+
     if (do_nsolve)
     {
         NSolve(*ns_mlmg, *ns_sol, *ns_rhs);
@@ -934,6 +1024,28 @@ MLMG::actualBottomSolve ()
             makeSolvable(amrlev,mglev,*bottom_b);
         }
 
+        if (bottom_solver == BottomSolver::direct && direct_solver == nullptr)
+        {
+            direct_solver.reset(new MLDirectBottomSolver(linop, direct_per_node));
+            direct_solver->setVerbose(bottom_verbose);
+            if (!direct_solver->setup(direct_max_size)) {
+                // switch permanently
+                direct_solver.reset();
+                bottom_solver = BottomSolver::bicgstab;
+            }
+        }
+
+        if (bottom_solver == BottomSolver::amg && amg_solver == nullptr)
+        {
+            amg_solver.reset(new MLAMGBottomSolver(linop, direct_per_node));
+            amg_solver->setVerbose(bottom_verbose);
+            if (!amg_solver->setup()) {
+                // switch permanently
+                amg_solver.reset();
+                bottom_solver = BottomSolver::bicgstab;
+            }
+        }
+
         if (bottom_solver == BottomSolver::hypre)
         {
             bottomSolveWithHypre(x, *bottom_b);
@@ -942,12 +1054,24 @@ MLMG::actualBottomSolve ()
         {
             bottomSolveWithPETSc(x, *bottom_b);
         }
+        else if (bottom_solver == BottomSolver::direct)
+        {
+            bottomSolveWithDirect(x, *bottom_b);
+        }
+        else if (bottom_solver == BottomSolver::amg)
+        {
+            bottomSolveWithAMG(x, *bottom_b);
+        }
         else
         {
             MLCGSolver::Type cg_type;
             if (bottom_solver == BottomSolver::cg ||
                 bottom_solver == BottomSolver::cgbicg) {
                 cg_type = MLCGSolver::Type::CG;
+            } else if (bottom_solver == BottomSolver::pipelined_cg) {
+                cg_type = MLCGSolver::Type::PipelinedCG;
+            } else if (bottom_solver == BottomSolver::pipelined_bicgstab) {
+                cg_type = MLCGSolver::Type::PipelinedBiCGStab;
             } else {
                 cg_type = MLCGSolver::Type::BiCGStab;
             }
@@ -1126,6 +1250,23 @@ MLMG::buildFineMask ()
     }
 }
 
+void
+MLMG::prepareLinOp ()
+{
+    if (!linop_prepared) {
+        if (linop.isFrozen() && linop.m_prepared) {
+            // A frozen operator is shared with earlier MLMG objects.
+            if (linop.needsUpdate()) linop.update();
+        } else {
+            linop.prepareForSolve();
+            linop.m_prepared = true;
+        }
+        linop_prepared = true;
+    } else if (linop.needsUpdate()) {
+        linop.update();
+    }
+}
+
 void
 MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rhs)
 {
@@ -1140,22 +1281,34 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
     int nghost = 0;
     if (cf_strategy == CFStrategy::ghostnodes) nghost = linop.getNGrow();
 
-    if (!linop_prepared) {
-        linop.prepareForSolve();
-        linop_prepared = true;
-    } else if (linop.needsUpdate()) {
-        linop.update();
+    prepareLinOp();
+
+#if defined(AMREX_USE_HYPRE) || defined(AMREX_USE_PETSC)
+    // The setup of hypre and PETSc is kept for the next solve only if the
+    // operator is frozen and its coefficients have not changed.
+    const bool keep_bottom = linop.isFrozen() && linop.coeffsVersion() == bottom_coeffs_version;
+#endif
+
+    // The direct and AMG bottom solvers are kept until the coefficients change.
+    if (linop.coeffsVersion() != bottom_coeffs_version) {
+        direct_solver.reset();
+        amg_solver.reset();
+        bottom_coeffs_version = linop.coeffsVersion();
     }
 
 #ifdef AMREX_USE_HYPRE
-    hypre_solver.reset();
-    hypre_bndry.reset();
-    hypre_node_solver.reset();
+    if (!keep_bottom) {
+        hypre_solver.reset();
+        hypre_bndry.reset();
+        hypre_node_solver.reset();
+    }
 #endif
 
 #ifdef AMREX_USE_PETSC
-    petsc_solver.reset(); 
-    petsc_bndry.reset(); 
+    if (!keep_bottom) {
+        petsc_solver.reset();
+        petsc_bndry.reset();
+    }
 #endif
 
     sol.resize(namrlevs);
@@ -1457,12 +1610,7 @@ MLMG::compResidual (const Vector<MultiFab*>& a_res, const Vector<MultiFab*>& a_s
         }
     }
 
-    if (!linop_prepared) {
-        linop.prepareForSolve();
-        linop_prepared = true;
-    } else if (linop.needsUpdate()) {
-        linop.update();
-    }
+    prepareLinOp();
     
     const auto& amrrr = linop.AMRRefRatio();
 
@@ -1537,12 +1685,7 @@ MLMG::apply (const Vector<MultiFab*>& out, const Vector<MultiFab*>& a_in)
         rh[alev].setVal(0.0);
     }
 
-    if (!linop_prepared) {
-        linop.prepareForSolve();
-        linop_prepared = true;
-    } else if (linop.needsUpdate()) {
-        linop.update();
-    }
+    prepareLinOp();
 
     const auto& amrrr = linop.AMRRefRatio();
 
@@ -1775,6 +1918,22 @@ MLMG::getNodalSum (int amrlev, int mglev, MultiFab& mf) const
     return s1/s2;
 }
 
+void
+MLMG::bottomSolveWithDirect (MultiFab& x, const MultiFab& b)
+{
+    BL_PROFILE("MLMG::bottomSolveWithDirect()");
+    direct_solver->solve(x, b);
+}
+
+void
+MLMG::bottomSolveWithAMG (MultiFab& x, const MultiFab& b)
+{
+    BL_PROFILE("MLMG::bottomSolveWithAMG()");
+    amg_solver->setMaxIter(bottom_maxiter);
+    amg_solver->setTolerance(bottom_reltol, bottom_abstol);
+    amg_solver->solve(x, b);
+}
+
 void
 MLMG::bottomSolveWithHypre (MultiFab& x, const MultiFab& b)
 {
@@ -0,0 +1,201 @@
+#include <AMReX_MLMGStats.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Periodicity.H>
+#include <AMReX_ParallelReduce.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Gpu.H>
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace amrex {
+
+void
+MLMGStats::define (const Vector<int>& num_mg_levels)
+{
+    level.clear();
+    level.resize(num_mg_levels.size());
+    for (int alev = 0; alev < num_mg_levels.size(); ++alev) {
+        level[alev].resize(num_mg_levels[alev]);
+    }
+    residual.clear();
+    convergence_factor.clear();
+    solve_time = 0.0;
+    iter_time = 0.0;
+    bottom_time = 0.0;
+}
+
+Real
+MLMGStats::averageConvergenceFactor () const noexcept
+{
+    if (residual.size() < 2 || !(residual[0] > 0.0)) return 0.0;
+    const int n = residual.size() - 1;
+    return std::pow(residual[n]/residual[0], Real(1.0)/n);
+}
+
+MLMGStats::Counter
+MLMGStats::total (Kernel k) const noexcept
+{
+    Counter r;
+    for (const auto& amrlev : level) {
+        for (const auto& mglev : amrlev) {
+            r.time  += mglev[k].time;
+            r.calls += mglev[k].calls;
+            r.bytes += mglev[k].bytes;
+        }
+    }
+    return r;
+}
+
+void
+MLMGStats::reduce (MPI_Comm comm)
+{
+    Vector<Real> times;
+    Vector<long> bytes;
+    for (const auto& amrlev : level) {
+        for (const auto& mglev : amrlev) {
+            for (const auto& c : mglev) {
+                times.push_back(c.time);
+                bytes.push_back(c.bytes);
+            }
+        }
+    }
+    times.push_back(solve_time);
+    times.push_back(iter_time);
+    times.push_back(bottom_time);
+
+    ParallelAllReduce::Max(times.data(), times.size(), comm);
+    ParallelAllReduce::Sum(bytes.data(), bytes.size(), comm);
+
+    int i = 0;
+    for (auto& amrlev : level) {
+        for (auto& mglev : amrlev) {
+            for (auto& c : mglev) {
+                c.time = times[i];
+                c.bytes = bytes[i];
+                ++i;
+            }
+        }
+    }
+    solve_time  = times[i++];
+    iter_time   = times[i++];
+    bottom_time = times[i++];
+}
+
+namespace {
+    void write_real (std::ostream& os, Real x)
+    {
+        if (std::isfinite(x)) {
+            os << x;
+        } else {
+            os << "null";
+        }
+    }
+
+    void write_reals (std::ostream& os, const Vector<Real>& v)
+    {
+        os << "[";
+        for (int i = 0; i < v.size(); ++i) {
+            if (i > 0) os << ", ";
+            write_real(os, v[i]);
+        }
+        os << "]";
+    }
+}
+
+std::string
+MLMGStats::toJSON () const
+{
+    std::ostringstream os;
+    os << std::setprecision(8);
+
+    os << "{\n";
+    os << "  \"solve_time\": ";
+    write_real(os, solve_time);
+    os << ",\n  \"iter_time\": ";
+    write_real(os, iter_time);
+    os << ",\n  \"bottom_time\": ";
+    write_real(os, bottom_time);
+    os << ",\n  \"num_iters\": " << numIters();
+    os << ",\n  \"residual\": ";
+    write_reals(os, residual);
+    os << ",\n  \"convergence_factor\": ";
+    write_reals(os, convergence_factor);
+    os << ",\n  \"average_convergence_factor\": ";
+    write_real(os, averageConvergenceFactor());
+    os << ",\n  \"levels\": [";
+
+    bool first = true;
+    for (int alev = 0; alev < level.size(); ++alev) {
+        for (int mglev = 0; mglev < level[alev].size(); ++mglev) {
+            os << (first ? "\n" : ",\n");
+            first = false;
+            os << "    {\"amrlev\": " << alev << ", \"mglev\": " << mglev;
+            for (int k = 0; k < nkernels; ++k) {
+                const Counter& c = level[alev][mglev][k];
+                os << ",\n     \"" << kernelName(k) << "\": {\"time\": ";
+                write_real(os, c.time);
+                os << ", \"calls\": " << c.calls << ", \"bytes\": " << c.bytes << "}";
+            }
+            os << "}";
+        }
+    }
+    os << "\n  ]\n}\n";
+
+    return os.str();
+}
+
+const char*
+MLMGStats::kernelName (int k) noexcept
+{
+    switch (k) {
+    case smooth:        return "smooth";
+    case apply:         return "apply";
+    case restriction:   return "restriction";
+    case interpolation: return "interpolation";
+    case communication: return "communication";
+    case bottom:        return "bottom";
+    default:            return "unknown";
+    }
+}
+
+long
+MLMGStats::bytesOf (const MultiFab& mf, int ncomp) noexcept
+{
+    long npts = 0;
+    for (int i : mf.IndexArray()) {
+        npts += mf.box(i).numPts();
+    }
+    return npts * ncomp * sizeof(Real);
+}
+
+long
+MLMGStats::fillBoundaryBytes (const MultiFab& mf, int ncomp, const Periodicity& period,
+                              bool cross, int elem_size)
+{
+    const long npts = mf.numFillBoundarySendPoints(mf.nGrowVect(), period, cross);
+    return npts * ncomp * elem_size;
+}
+
+MLMGStatsTimer::MLMGStatsTimer (MLMGStats* stats, int amrlev, int mglev,
+                                MLMGStats::Kernel k, long bytes) noexcept
+{
+    if (stats) {
+        m_counter = &(stats->get(amrlev, mglev, k));
+        m_counter->calls += 1;
+        m_counter->bytes += bytes;
+        Gpu::synchronize();
+        m_start = amrex::second();
+    }
+}
+
+MLMGStatsTimer::~MLMGStatsTimer ()
+{
+    if (m_counter) {
+        Gpu::synchronize();
+        m_counter->time += amrex::second() - m_start;
+    }
+}
+
+}
@@ -3,6 +3,7 @@
 #include <AMReX_MLMG.H>
 #include <AMReX_MLNodeLaplacian.H>
 #include <AMReX_MLNodeLap_F.H>
+#include <AMReX_MLNodeLap_K.H>
 #include <AMReX_MultiFabUtil.H>
 
 #ifdef AMREX_USE_EB
@@ -115,7 +116,9 @@ MLNodeLaplacian::define (const Vector<Geometry>& a_geom,
 void
 MLNodeLaplacian::setSigma (int amrlev, const MultiFab& a_sigma)
 {
+    if (!coeffsChanged(*m_sigma[amrlev][0][0], 0, a_sigma, 0, 1)) return;
     MultiFab::Copy(*m_sigma[amrlev][0][0], a_sigma, 0, 0, 1, 0);
+    m_needs_update = true;
 }
 
 void
@@ -188,11 +191,16 @@ MLNodeLaplacian::compDivergence (const Vector<MultiFab*>& rhs, const Vector<Mult
             if (regular)
 #endif
             {
+#if (AMREX_SPACEDIM == 3)
+                mlndlap_divu(bx, rhs[ilev]->array(mfi), vel[ilev]->const_array(mfi),
+                             dmsk.const_array(mfi), geom.InvCellSizeArray());
+#else
                 amrex_mlndlap_divu(BL_TO_FORTRAN_BOX(bx),
                                    BL_TO_FORTRAN_ANYD((*rhs[ilev])[mfi]),
                                    BL_TO_FORTRAN_ANYD((*vel[ilev])[mfi]),
                                    BL_TO_FORTRAN_ANYD(dmsk[mfi]),
                                    dxinv);
+#endif
             }
 
             if (m_coarsening_strategy == CoarseningStrategy::Sigma) {
@@ -438,11 +446,16 @@ MLNodeLaplacian::compRHS (const Vector<MultiFab*>& rhs, const Vector<MultiFab*>&
             if (regular)
 #endif
             {
+#if (AMREX_SPACEDIM == 3)
+                mlndlap_divu(bx, rhs[ilev]->array(mfi), vel[ilev]->const_array(mfi),
+                             dmsk.const_array(mfi), geom.InvCellSizeArray());
+#else
                 amrex_mlndlap_divu(BL_TO_FORTRAN_BOX(bx),
                                    BL_TO_FORTRAN_ANYD((*rhs[ilev])[mfi]),
                                    BL_TO_FORTRAN_ANYD((*vel[ilev])[mfi]),
                                    BL_TO_FORTRAN_ANYD(dmsk[mfi]),
                                    dxinv);
+#endif
             }
 
             if (m_coarsening_strategy == CoarseningStrategy::Sigma) {
@@ -1192,10 +1205,15 @@ MLNodeLaplacian::buildStencil ()
                         sgfab.setVal(0.0);
                         bx2 &= sgfab_orig.box();
                         sgfab.copy(sgfab_orig, bx2, 0, bx2, 0, 1);
+#if (AMREX_SPACEDIM == 3)
+                        mlndlap_set_stencil(bx, stfab.array(), sgfab.const_array(),
+                                            geom.InvCellSizeArray());
+#else
                         amrex_mlndlap_set_stencil(BL_TO_FORTRAN_BOX(bx),
                                                   BL_TO_FORTRAN_ANYD(stfab),
                                                   BL_TO_FORTRAN_ANYD(sgfab),
                                                   dxinv);
+#endif
                     }
                 }
             }
@@ -1208,8 +1226,12 @@ MLNodeLaplacian::buildStencil ()
                 const Box& bx = mfi.tilebox();
                 FArrayBox& stfab = (*m_stencil[amrlev][0])[mfi];
                     
+#if (AMREX_SPACEDIM == 3)
+                mlndlap_set_stencil_s0(bx, stfab.array());
+#else
                 amrex_mlndlap_set_stencil_s0(BL_TO_FORTRAN_BOX(bx),
                                              BL_TO_FORTRAN_ANYD(stfab));
+#endif
             }
 
             m_stencil[amrlev][0]->FillBoundary(geom.periodicity());
@@ -1232,15 +1254,29 @@ MLNodeLaplacian::buildStencil ()
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
-            for (MFIter mfi(*pcrse, true); mfi.isValid(); ++mfi)
             {
-                Box vbx = mfi.validbox();
-                AMREX_D_TERM(vbx.growLo(0,1);, vbx.growLo(1,1);, vbx.growLo(2,1));
-                Box bx = mfi.growntilebox(1);
-                bx &= vbx;
-                amrex_mlndlap_stencil_rap(BL_TO_FORTRAN_BOX(bx),
-                                          BL_TO_FORTRAN_ANYD((*pcrse)[mfi]),
-                                          BL_TO_FORTRAN_ANYD(fine[mfi]));
+#if (AMREX_SPACEDIM == 3)
+                FArrayBox wfab;
+#endif
+                for (MFIter mfi(*pcrse, true); mfi.isValid(); ++mfi)
+                {
+                    Box vbx = mfi.validbox();
+                    AMREX_D_TERM(vbx.growLo(0,1);, vbx.growLo(1,1);, vbx.growLo(2,1));
+                    Box bx = mfi.growntilebox(1);
+                    bx &= vbx;
+#if (AMREX_SPACEDIM == 3)
+                    Box wbx = bx;
+                    wbx.growHi(0,1).growHi(1,1).growHi(2,1);
+                    wfab.resize(wbx, 27);
+                    mlndlap_rap_weights(wbx, wfab.array(), fine.const_array(mfi));
+                    mlndlap_stencil_rap(bx, pcrse->array(mfi), fine.const_array(mfi),
+                                        wfab.const_array());
+#else
+                    amrex_mlndlap_stencil_rap(BL_TO_FORTRAN_BOX(bx),
+                                              BL_TO_FORTRAN_ANYD((*pcrse)[mfi]),
+                                              BL_TO_FORTRAN_ANYD(fine[mfi]));
+#endif
+                }
             }
 
 #ifdef _OPENMP
@@ -1250,8 +1286,12 @@ MLNodeLaplacian::buildStencil ()
             {
                 const Box& bx = mfi.tilebox();
                 FArrayBox& stfab = (*pcrse)[mfi];
+#if (AMREX_SPACEDIM == 3)
+                mlndlap_set_stencil_s0(bx, stfab.array());
+#else
                 amrex_mlndlap_set_stencil_s0(BL_TO_FORTRAN_BOX(bx),
                                              BL_TO_FORTRAN_ANYD(stfab));
+#endif
             }
 
             if (need_parallel_copy) {
@@ -1307,6 +1347,20 @@ MLNodeLaplacian::prepareForSolve ()
 #endif
 
     buildStencil();
+
+    m_needs_update = false;
+}
+
+void
+MLNodeLaplacian::update ()
+{
+    BL_PROFILE("MLNodeLaplacian::update()");
+
+    averageDownCoeffs();
+
+    buildStencil();
+
+    m_needs_update = false;
 }
 
 void
@@ -1337,10 +1391,15 @@ MLNodeLaplacian::restriction (int amrlev, int cmglev, MultiFab& crse, MultiFab&
         const Box& bx = mfi.tilebox();
         if (m_coarsening_strategy == CoarseningStrategy::Sigma)
         {
+#if (AMREX_SPACEDIM == 3)
+            mlndlap_restriction(bx, (*pcrse)[mfi].array(), fine.const_array(mfi),
+                                dmsk.const_array(mfi));
+#else
             amrex_mlndlap_restriction(BL_TO_FORTRAN_BOX(bx),
                                       BL_TO_FORTRAN_ANYD((*pcrse)[mfi]),
                                       BL_TO_FORTRAN_ANYD(fine[mfi]),
                                       BL_TO_FORTRAN_ANYD(dmsk[mfi]));
+#endif
         }
         else
         {
@@ -1376,7 +1435,9 @@ MLNodeLaplacian::interpolation (int amrlev, int fmglev, MultiFab& fine, const Mu
         cmf = &cfine;
     }
 
+#if (AMREX_SPACEDIM != 3)
     const Box& nd_domain = amrex::surroundingNodes(m_geom[amrlev][fmglev].Domain());
+#endif
 
     const iMultiFab& dmsk = *m_dirichlet_mask[amrlev][fmglev];
 
@@ -1400,6 +1461,20 @@ MLNodeLaplacian::interpolation (int amrlev, int fmglev, MultiFab& fine, const Mu
                                                 BL_TO_FORTRAN_ANYD((*stencil)[mfi]),
                                                 BL_TO_FORTRAN_ANYD(dmsk[mfi]));
             }
+#if (AMREX_SPACEDIM == 3)
+            else if (m_use_harmonic_average && fmglev > 0)
+            {
+                mlndlap_interpolation_ha(cbx, tmpfab.array(), cmf->const_array(mfi),
+                                         sigma[0]->const_array(mfi),
+                                         sigma[1]->const_array(mfi),
+                                         sigma[2]->const_array(mfi), dmsk.const_array(mfi));
+            }
+            else
+            {
+                mlndlap_interpolation_aa(cbx, tmpfab.array(), cmf->const_array(mfi),
+                                         sigma[0]->const_array(mfi), dmsk.const_array(mfi));
+            }
+#else
             else if (m_use_harmonic_average && fmglev > 0)
             {
                 AMREX_D_TERM(const FArrayBox& sxfab = (*sigma[0])[mfi];,
@@ -1426,6 +1501,7 @@ MLNodeLaplacian::interpolation (int amrlev, int fmglev, MultiFab& fine, const Mu
                                                BL_TO_FORTRAN_BOX(nd_domain),
                                                m_lobc[0].data(), m_hibc[0].data());
             }
+#endif
             fine[mfi].plus(tmpfab,fbx,fbx,0,0,1);
         }
     }
@@ -1482,10 +1558,15 @@ MLNodeLaplacian::restrictInteriorNodes (int camrlev, MultiFab& crhs, MultiFab& a
     {
         const Box& bx = mfi.tilebox();
         if (m_coarsening_strategy == CoarseningStrategy::Sigma) {
+#if (AMREX_SPACEDIM == 3)
+            mlndlap_restriction(bx, cfine.array(mfi), frhs->const_array(mfi),
+                                fdmsk.const_array(mfi));
+#else
             amrex_mlndlap_restriction(BL_TO_FORTRAN_BOX(bx),
                                       BL_TO_FORTRAN_ANYD(cfine[mfi]),
                                       BL_TO_FORTRAN_ANYD((*frhs)[mfi]),
                                       BL_TO_FORTRAN_ANYD(fdmsk[mfi]));
+#endif
         } else {
             amrex_mlndlap_restriction_rap(BL_TO_FORTRAN_BOX(bx),
                                           BL_TO_FORTRAN_ANYD(cfine[mfi]),
@@ -1533,6 +1614,9 @@ MLNodeLaplacian::applyBC (int amrlev, int mglev, MultiFab& phi, BCMode/* bc_mode
     const Box& nd_domain = amrex::surroundingNodes(geom.Domain());
 
     if (!skip_fillboundary) {
+        MLMGStatsTimer stats_timer(m_stats, amrlev, mglev, MLMGStats::communication,
+            m_stats ? MLMGStats::fillBoundaryBytes(phi, phi.nComp(), geom.periodicity(),
+                                                   false, sizeof(Real)) : 0);
         phi.FillBoundary(geom.periodicity());
     }
 
@@ -1561,10 +1645,39 @@ MLNodeLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& i
 
     const auto& sigma = m_sigma[amrlev][mglev];
     const auto& stencil = m_stencil[amrlev][mglev];
+    const iMultiFab& dmsk = *m_dirichlet_mask[amrlev][mglev];
+
+#if (AMREX_SPACEDIM == 3)
+    const auto dxinv = m_geom[amrlev][mglev].InvCellSizeArray();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(out,true); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const auto& yarr = out.array(mfi);
+        const auto& xarr = in.const_array(mfi);
+        const auto& mskarr = dmsk.const_array(mfi);
+        if (m_coarsening_strategy == CoarseningStrategy::RAP)
+        {
+            mlndlap_adotx_sten(bx, yarr, xarr, stencil->const_array(mfi), mskarr);
+        }
+        else if (m_use_harmonic_average && mglev > 0)
+        {
+            mlndlap_adotx_ha(bx, yarr, xarr, sigma[0]->const_array(mfi),
+                             sigma[1]->const_array(mfi), sigma[2]->const_array(mfi),
+                             mskarr, dxinv);
+        }
+        else
+        {
+            mlndlap_adotx_aa(bx, yarr, xarr, sigma[0]->const_array(mfi), mskarr, dxinv);
+        }
+    }
+#else
     const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
 
     const Box& domain_box = amrex::surroundingNodes(m_geom[amrlev][mglev].Domain());
-    const iMultiFab& dmsk = *m_dirichlet_mask[amrlev][mglev];
 
 #ifdef _OPENMP
 #pragma omp parallel
@@ -1612,6 +1725,7 @@ MLNodeLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& i
                                    m_lobc[0].data(), m_hibc[0].data());
         }
     }
+#endif
 }
 
 void
@@ -1622,6 +1736,74 @@ MLNodeLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
 
     const iMultiFab& dmsk = *m_dirichlet_mask[amrlev][mglev];
 
+#if (AMREX_SPACEDIM == 3)
+    const auto& sigma = m_sigma[amrlev][mglev];
+    const auto& stencil = m_stencil[amrlev][mglev];
+    const auto dxinv = m_geom[amrlev][mglev].InvCellSizeArray();
+
+    if (m_use_gauss_seidel)
+    {
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(sol); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            const auto& solarr = sol.array(mfi);
+            const auto& rhsarr = rhs.const_array(mfi);
+            const auto& mskarr = dmsk.const_array(mfi);
+            if (m_coarsening_strategy == CoarseningStrategy::RAP)
+            {
+                mlndlap_gauss_seidel_sten(bx, solarr, rhsarr, stencil->const_array(mfi), mskarr);
+            }
+            else if (m_use_harmonic_average && mglev > 0)
+            {
+                mlndlap_gauss_seidel_ha(bx, solarr, rhsarr, sigma[0]->const_array(mfi),
+                                        sigma[1]->const_array(mfi), sigma[2]->const_array(mfi),
+                                        mskarr, dxinv);
+            }
+            else
+            {
+                mlndlap_gauss_seidel_aa(bx, solarr, rhsarr, sigma[0]->const_array(mfi),
+                                        mskarr, dxinv);
+            }
+        }
+
+        nodalSync(amrlev, mglev, sol);
+    }
+    else
+    {
+        MultiFab Ax(sol.boxArray(), sol.DistributionMap(), 1, 0);
+        Fapply(amrlev, mglev, Ax, sol);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(sol,true); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.tilebox();
+            const auto& solarr = sol.array(mfi);
+            const auto& Axarr = Ax.const_array(mfi);
+            const auto& rhsarr = rhs.const_array(mfi);
+            const auto& mskarr = dmsk.const_array(mfi);
+            if (m_coarsening_strategy == CoarseningStrategy::RAP)
+            {
+                mlndlap_jacobi_sten(bx, solarr, Axarr, rhsarr, stencil->const_array(mfi), mskarr);
+            }
+            else if (m_use_harmonic_average && mglev > 0)
+            {
+                mlndlap_jacobi_ha(bx, solarr, Axarr, rhsarr, sigma[0]->const_array(mfi),
+                                  sigma[1]->const_array(mfi), sigma[2]->const_array(mfi),
+                                  mskarr, dxinv);
+            }
+            else
+            {
+                mlndlap_jacobi_aa(bx, solarr, Axarr, rhsarr, sigma[0]->const_array(mfi),
+                                  mskarr, dxinv);
+            }
+        }
+    }
+#else
     if (m_use_gauss_seidel)
     {
         const auto& sigma = m_sigma[amrlev][mglev];
@@ -1762,6 +1944,7 @@ MLNodeLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
             }
         }
     }
+#endif
 }
 
 void
@@ -1772,10 +1955,37 @@ MLNodeLaplacian::normalize (int amrlev, int mglev, MultiFab& mf) const
 
     const auto& sigma = m_sigma[amrlev][mglev];
     const auto& stencil = m_stencil[amrlev][mglev];
-    const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
     const iMultiFab& dmsk = *m_dirichlet_mask[amrlev][mglev];
     const Real s0_norm0 = m_s0_norm0[amrlev][mglev];
 
+#if (AMREX_SPACEDIM == 3)
+    const auto dxinv = m_geom[amrlev][mglev].InvCellSizeArray();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(mf,true); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        const auto& arr = mf.array(mfi);
+        const auto& mskarr = dmsk.const_array(mfi);
+        if (m_coarsening_strategy == CoarseningStrategy::RAP)
+        {
+            mlndlap_normalize_sten(bx, arr, stencil->const_array(mfi), mskarr, s0_norm0);
+        }
+        else if (m_use_harmonic_average && mglev > 0)
+        {
+            mlndlap_normalize_ha(bx, arr, sigma[0]->const_array(mfi), sigma[1]->const_array(mfi),
+                                 sigma[2]->const_array(mfi), mskarr, dxinv);
+        }
+        else
+        {
+            mlndlap_normalize_aa(bx, arr, sigma[0]->const_array(mfi), mskarr, dxinv);
+        }
+    }
+#else
+    const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
+
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -1816,6 +2026,7 @@ MLNodeLaplacian::normalize (int amrlev, int mglev, MultiFab& mf) const
                                        dxinv);
         }
     }
+#endif
 }
 
 void
@@ -1953,11 +2164,16 @@ MLNodeLaplacian::compSyncResidualCoarse (MultiFab& sync_resid, const MultiFab& a
                 u.setValIfNot(0.0, ccbxg1, crse_cc_mask[mfi], 0, AMREX_SPACEDIM);
 
                 rhs.resize(bx);
+#if (AMREX_SPACEDIM == 3)
+                mlndlap_divu(bx, rhs.array(), u.array(), dmsk.const_array(mfi),
+                             geom.InvCellSizeArray());
+#else
                 amrex_mlndlap_divu(BL_TO_FORTRAN_BOX(bx),
                                    BL_TO_FORTRAN_ANYD(rhs),
                                    BL_TO_FORTRAN_ANYD(u),
                                    BL_TO_FORTRAN_ANYD(dmsk[mfi]),
                                    dxinv);
+#endif
 
                 if (rhcc)
                 {
@@ -2064,11 +2280,16 @@ MLNodeLaplacian::compSyncResidualFine (MultiFab& sync_resid, const MultiFab& phi
             tmpmask *= -1;  //  0 in dmsk --> 1 in tmpmask, and 1 in dmsk --> 0 in tmpmask
 
             rhs.resize(bx);
+#if (AMREX_SPACEDIM == 3)
+            mlndlap_divu(bx, rhs.array(), u.array(), tmpmask.array(),
+                         geom.InvCellSizeArray());
+#else
             amrex_mlndlap_divu(BL_TO_FORTRAN_BOX(bx),
                                BL_TO_FORTRAN_ANYD(rhs),
                                BL_TO_FORTRAN_ANYD(u),
                                BL_TO_FORTRAN_ANYD(tmpmask),
                                dxinv);
+#endif
 
             if (rhcc)
             {
@@ -2141,10 +2362,15 @@ MLNodeLaplacian::reflux (int crse_amrlev,
     {
         const Box& bx = mfi.tilebox();
         if (m_coarsening_strategy == CoarseningStrategy::Sigma) {
+#if (AMREX_SPACEDIM == 3)
+            mlndlap_restriction(bx, fine_res_for_coarse.array(mfi), fine_res.const_array(mfi),
+                                fdmsk.const_array(mfi));
+#else
             amrex_mlndlap_restriction(BL_TO_FORTRAN_BOX(bx),
                                       BL_TO_FORTRAN_ANYD(fine_res_for_coarse[mfi]),
                                       BL_TO_FORTRAN_ANYD(fine_res[mfi]),
                                       BL_TO_FORTRAN_ANYD(fdmsk[mfi]));
+#endif
         } else {
             amrex_mlndlap_restriction_rap(BL_TO_FORTRAN_BOX(bx),
                                           BL_TO_FORTRAN_ANYD(fine_res_for_coarse[mfi]),
@@ -286,6 +286,70 @@ MLPoisson::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs, i
     }
 }
 
+void
+MLPoisson::FsmoothBlocked (int amrlev, int mglev, const Box& bx, const Box& vbx,
+                           Array4<Real> const& sol, Array4<Real const> const& rhs,
+                           const Vector<Array4<Real const> >& /*coeffs*/,
+                           const Array<Array4<int const>,2*AMREX_SPACEDIM>& m,
+                           const Array<Array4<Real const>,2*AMREX_SPACEDIM>& f,
+                           int redblack) const
+{
+    const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
+    AMREX_D_TERM(const Real dhx = dxinv[0]*dxinv[0];,
+                 const Real dhy = dxinv[1]*dxinv[1];,
+                 const Real dhz = dxinv[2]*dxinv[2];);
+
+#if (AMREX_SPACEDIM < 3)
+    const Real dx = m_geom[amrlev][mglev].CellSize(0);
+    const Real probxlo = m_geom[amrlev][mglev].ProbLo(0);
+#endif
+
+#if (AMREX_SPACEDIM == 1)
+    if (m_has_metric_term) {
+        mlpoisson_gsrb_m(bx, sol, rhs, dhx,
+                         f[0], m[0],
+                         f[1], m[1],
+                         vbx, redblack,
+                         dx, probxlo);
+    } else {
+        mlpoisson_gsrb(bx, sol, rhs, dhx,
+                       f[0], m[0],
+                       f[1], m[1],
+                       vbx, redblack);
+    }
+#endif
+
+#if (AMREX_SPACEDIM == 2)
+    if (m_has_metric_term) {
+        mlpoisson_gsrb_m(bx, sol, rhs, dhx, dhy,
+                         f[0], m[0],
+                         f[1], m[1],
+                         f[2], m[2],
+                         f[3], m[3],
+                         vbx, redblack,
+                         dx, probxlo);
+    } else {
+        mlpoisson_gsrb(bx, sol, rhs, dhx, dhy,
+                       f[0], m[0],
+                       f[1], m[1],
+                       f[2], m[2],
+                       f[3], m[3],
+                       vbx, redblack);
+    }
+#endif
+
+#if (AMREX_SPACEDIM == 3)
+    mlpoisson_gsrb(bx, sol, rhs, dhx, dhy, dhz,
+                   f[0], m[0],
+                   f[1], m[1],
+                   f[2], m[2],
+                   f[3], m[3],
+                   f[4], m[4],
+                   f[5], m[5],
+                   vbx, redblack);
+#endif
+}
+
 void
 MLPoisson::FFlux (int amrlev, const MFIter& mfi,
                   const Array<FArrayBox*,AMREX_SPACEDIM>& flux,
@@ -1,5 +1,8 @@
 #include "AMReX_LoadBalanceKD.H"
 
+#include <algorithm>
+#include <limits>
+
 namespace amrex {
 
 int KDTree::min_box_size = 4;
@@ -60,13 +63,21 @@ bool KDTree::partitionNode(KDNode* node, const FArrayBox& cost) {
     const Box& box = node->box;
     BL_ASSERT(cost.box().contains(box));
     
+    // With an odd number of processes, the left box gets the smaller half
+    // of them and of the cost.  amrex_compute_best_partition splits at half
+    // the cost it is given, and the costs of the two boxes are then summed
+    // again by amrex_set_box_cost.
+    const int num_procs_left  = node->num_procs_left/2;
+    const int num_procs_right = node->num_procs_left - num_procs_left;
+    const Real split_cost = 2.0*node->cost*num_procs_left/node->num_procs_left;
+
     int split;
     Real cost_left, cost_right;
     Box left, right;
     int dir = getLongestDir(box);
     for (int i = 0; i < AMREX_SPACEDIM; ++i) {
         amrex_compute_best_partition(cost.dataPtr(), cost.loVect(), cost.hiVect(),
-                                     box.loVect(), box.hiVect(), node->cost, dir,
+                                     box.loVect(), box.hiVect(), split_cost, dir,
                                      &cost_left, &cost_right, &split);    
     
         bool success = splitBox(split, dir, box, left, right);        
@@ -89,8 +100,8 @@ bool KDTree::partitionNode(KDNode* node, const FArrayBox& cost) {
         }
     }
 
-    node->left  = new KDNode(left,  cost_left,  node->num_procs_left/2);
-    node->right = new KDNode(right, cost_right, node->num_procs_left/2);
+    node->left  = new KDNode(left,  cost_left,  num_procs_left);
+    node->right = new KDNode(right, cost_right, num_procs_right);
 
     return true;
 }
@@ -134,4 +145,106 @@ bool KDTree::splitBox(int split, int dir,
     return true;
 }
 
+namespace loadBalanceKD {
+
+void CostModel::addSample(Real time, long nparticles, long ncells) {
+    const Real p = nparticles;
+    const Real c = ncells;
+#ifdef _OPENMP
+#pragma omp critical (amrex_loadbalancekd_costmodel)
+#endif
+    {
+        m_pp += p*p;
+        m_pc += p*c;
+        m_cc += c*c;
+        m_pt += p*time;
+        m_ct += c*time;
+        m_tt += time*time;
+        ++m_num_samples;
+    }
+}
+
+void CostModel::fit() {
+    BL_PROFILE("loadBalanceKD::CostModel::fit()");
+
+    Real sums[7] = {m_pp, m_pc, m_cc, m_pt, m_ct, m_tt, Real(m_num_samples)};
+    ParallelDescriptor::ReduceRealSum(sums, 7);
+    const Real pp = sums[0], pc = sums[1], cc = sums[2];
+    const Real pt = sums[3], ct = sums[4], tt = sums[5];
+    clearSamples();
+
+    if (sums[6] == 0.0) return;
+
+    // The costs must not be negative, so the least squares fit with both
+    // costs is compared with those with only one of them.
+    auto residual = [=] (Real a, Real b) {
+        return tt - 2.0*(a*pt + b*ct) + a*a*pp + 2.0*a*b*pc + b*b*cc;
+    };
+
+    Real best_a = 0.0, best_b = 0.0;
+    Real best_r = std::numeric_limits<Real>::max();
+    auto consider = [&] (Real a, Real b) {
+        if (a < 0.0 || b < 0.0) return;
+        const Real r = residual(a, b);
+        if (r < best_r) {
+            best_r = r;
+            best_a = a;
+            best_b = b;
+        }
+    };
+
+    const Real det = pp*cc - pc*pc;
+    if (det > 1.e-12*pp*cc) {
+        consider((pt*cc - ct*pc)/det, (ct*pp - pt*pc)/det);
+    }
+    if (pp > 0.0) consider(pt/pp, 0.0);
+    if (cc > 0.0) consider(0.0, ct/cc);
+
+    if (best_a > 0.0 || best_b > 0.0) {
+        m_particle_cost = best_a;
+        m_cell_cost = best_b;
+    }
+}
+
+void CostModel::clearSamples() {
+    m_pp = m_pc = m_cc = m_pt = m_ct = m_tt = 0.0;
+    m_num_samples = 0;
+}
+
+void gatherCost(const MultiFab& local_cost, MultiFab& global_cost, const Box& domain) {
+
+    BoxList global_bl;
+    Vector<int> procs_map;
+    for (int i = 0; i < ParallelDescriptor::NProcs(); ++i) {
+        global_bl.push_back(domain);
+        procs_map.push_back(i);
+    }
+
+    BoxArray global_ba(global_bl);
+    DistributionMapping global_dm(procs_map);
+
+    global_cost.define(global_ba, global_dm, 1, 0);
+    global_cost.copy(local_cost, 0, 0, 1);
+}
+
+Real efficiency(const Vector<Real>& box_costs, const DistributionMapping& dm) {
+
+    BL_ASSERT(box_costs.size() == dm.size());
+
+    const int nprocs = ParallelDescriptor::NProcs();
+    Vector<Real> proc_costs(nprocs, 0.0);
+    for (int i = 0; i < box_costs.size(); ++i) {
+        proc_costs[dm[i]] += box_costs[i];
+    }
+
+    Real total = 0.0, max = 0.0;
+    for (int i = 0; i < nprocs; ++i) {
+        total += proc_costs[i];
+        max = std::max(max, proc_costs[i]);
+    }
+    return (max > 0.0) ? total/(nprocs*max) : 1.0;
+}
+
+}
+
 }
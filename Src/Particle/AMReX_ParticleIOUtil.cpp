@@ -0,0 +1,352 @@
+#include <AMReX_ParticleIOUtil.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_NFiles.H>
+
+#include <sstream>
+
+namespace amrex {
+
+bool ParticleFileSinglePrecision (bool is_checkpoint, const RealDescriptor& particle_rd)
+{
+    bool single_precision = particle_rd.numBytes() == 4;
+    if ( ! is_checkpoint)
+    {
+        ParmParse pp("particles");
+        bool plotfile_single_precision = false;
+        pp.query("plotfile_single_precision", plotfile_single_precision);
+        single_precision = single_precision || plotfile_single_precision;
+    }
+    return single_precision;
+}
+
+int ParticleFileNOutFiles ()
+{
+    // We want to write the data out in parallel.
+    // We'll allow up to nOutFiles active writers at a time.
+    const int NProcs = ParallelDescriptor::NProcs();
+    int nOutFiles(256);
+    ParmParse pp("particles");
+    pp.query("particles_nfiles",nOutFiles);
+    if(nOutFiles == -1) nOutFiles = NProcs;
+    return std::max(1, std::min(nOutFiles,NProcs));
+}
+
+void WriteParticleFileHeader (std::ostream& os, const std::string& version, bool single_precision,
+                              const Vector<int>& write_real_comp,
+                              const Vector<std::string>& real_comp_names,
+                              const Vector<int>& write_int_comp,
+                              const Vector<std::string>& int_comp_names,
+                              long nparticles, int maxnextid, const Vector<int>& ngrids)
+{
+    //
+    // First thing written is our Checkpoint/Restart version string.
+    // We append "_single" or "_double" to the version string indicating
+    // whether we're using "float" or "double" floating point data in the
+    // particles so that we can Restart from the checkpoint files.
+    //
+    if (single_precision)
+    {
+        os << version << "_single" << '\n';
+    }
+    else
+    {
+        os << version << "_double" << '\n';
+    }
+
+    // AMREX_SPACEDIM and N for sanity checking.
+    os << AMREX_SPACEDIM << '\n';
+
+    const int nreal = write_real_comp.size();
+    const int nint  = write_int_comp.size();
+
+    int num_output_real = 0;
+    for (int i = 0; i < nreal; ++i)
+        if (write_real_comp[i]) ++num_output_real;
+
+    int num_output_int = 0;
+    for (int i = 0; i < nint; ++i)
+        if (write_int_comp[i]) ++num_output_int;
+
+    // The number of extra real parameters
+    os << num_output_real << '\n';
+
+    // Real component names
+    for (int i = 0; i < nreal; ++i)
+        if (write_real_comp[i]) os << real_comp_names[i] << '\n';
+
+    // The number of extra int parameters
+    os << num_output_int << '\n';
+
+    // int component names
+    for (int i = 0; i < nint; ++i)
+        if (write_int_comp[i]) os << int_comp_names[i] << '\n';
+
+    bool is_checkpoint = true; // legacy
+    os << is_checkpoint << '\n';
+
+    // The total number of particles.
+    os << nparticles << '\n';
+
+    // The value of nextid that we need to restore on restart.
+    os << maxnextid << '\n';
+
+    // Then the finest level of the AMR hierarchy.
+    os << static_cast<int>(ngrids.size())-1 << '\n';
+
+    // Then the number of grids at each level.
+    for (int n : ngrids)
+        os << n << '\n';
+}
+
+void WriteParticleFileIndex (std::ostream& os, const Vector<int>& which,
+                             const Vector<int>& count, const Vector<long>& where)
+{
+    for (int j = 0, N = which.size(); j < N; j++)
+    {
+        //
+        // We now write the which file, the particle count, and the
+        // file offset into which the data for each grid was written,
+        // to the header file.
+        //
+        os << which[j] << ' ' << count[j] << ' ' << where[j] << '\n';
+    }
+}
+
+void UnlinkEmptyParticleFiles (const std::string& filePrefix, int nOutFiles,
+                               const Vector<int>& which, const Vector<int>& count)
+{
+    Vector<long> cnt(nOutFiles,0);
+
+    for (int i = 0, N = count.size(); i < N; i++) {
+        cnt[which[i]] += count[i];
+    }
+
+    for (int i = 0; i < nOutFiles; i++)
+    {
+        if (cnt[i] == 0)
+        {
+            std::string FullFileName = NFilesIter::FileName(i, filePrefix);
+            amrex::UnlinkFile(FullFileName.c_str());
+        }
+    }
+}
+
+constexpr int ParticleChunkWriter::max_chunk;
+
+ParticleChunkWriter::ParticleChunkWriter (std::ofstream& ofs, int iChunkSize, int rChunkSize,
+                                          bool single_precision, const RealDescriptor& particle_rd)
+    : m_ofs(ofs), m_iChunkSize(iChunkSize), m_rChunkSize(rChunkSize),
+      m_single_precision(single_precision)
+{
+    // The format of the real data in the file.
+    const bool downcast = single_precision and particle_rd.numBytes() == 8;
+    m_rd = downcast ? &FPC::Native32RealDescriptor() : &particle_rd;
+    m_native_real = single_precision ? *m_rd == FPC::Native32RealDescriptor()
+                                     : *m_rd == FPC::Native64RealDescriptor();
+}
+
+void ParticleChunkWriter::start (int count)
+{
+    m_chunk = std::min(count, max_chunk);
+    m_n = 0;
+    m_istuff.resize(m_chunk*m_iChunkSize);
+    if (m_single_precision) m_fstuff.resize(m_chunk*m_rChunkSize);
+    else                    m_dstuff.resize(m_chunk*m_rChunkSize);
+}
+
+void ParticleChunkWriter::writeInts ()
+{
+    writeIntData(m_istuff.dataPtr(), m_n*m_iChunkSize, m_ofs);
+    m_n = 0;
+}
+
+void ParticleChunkWriter::writeReals ()
+{
+    const int n = m_n*m_rChunkSize;
+    if (m_single_precision) {
+        if (m_native_real) m_ofs.write((char*) m_fstuff.dataPtr(), n*sizeof(float));
+        else writeFloatData(m_fstuff.dataPtr(), n, m_ofs, *m_rd);
+    } else {
+        if (m_native_real) m_ofs.write((char*) m_dstuff.dataPtr(), n*sizeof(double));
+        else writeDoubleData(m_dstuff.dataPtr(), n, m_ofs, *m_rd);
+    }
+    m_n = 0;
+}
+
+void ParticleChunkWriter::finishInts ()
+{
+    if (m_n > 0) writeInts();
+    m_ofs.flush();  // Some systems require this flush() (probably due to a bug)
+}
+
+void ParticleChunkWriter::finishReals ()
+{
+    if (m_n > 0) writeReals();
+    m_ofs.flush();  // Some systems require this flush() (probably due to a bug)
+}
+
+ParticleFileHeader ReadParticleFileHeader (const std::string& fullname)
+{
+    std::string HdrFileName = fullname;
+    if (!HdrFileName.empty() && HdrFileName[HdrFileName.size()-1] != '/')
+        HdrFileName += '/';
+    HdrFileName += "Header";
+
+    Vector<char> fileCharPtr;
+    ParallelDescriptor::ReadAndBcastFile(HdrFileName, fileCharPtr);
+    std::string fileCharPtrString(fileCharPtr.dataPtr());
+    std::istringstream HdrFile(fileCharPtrString, std::istringstream::in);
+
+    ParticleFileHeader hdr;
+
+    std::string version;
+    HdrFile >> version;
+    BL_ASSERT(!version.empty());
+
+    // What do our version strings mean?
+    // "Version_One_Dot_Zero" -- hard-wired to write out in double precision.
+    // "Version_One_Dot_One" -- can write out either as either single or double precision.
+    // Appended to the latter version string are either "_single" or "_double" to
+    // indicate how the particles were written.
+    // "Version_Two_Dot_Zero" -- this is the AMReX particle file format
+    if (version.find("Version_One_Dot_Zero") != std::string::npos) {
+        hdr.how = "double";
+    }
+    else if (version.find("Version_One_Dot_One")  != std::string::npos or
+             version.find("Version_Two_Dot_Zero") != std::string::npos) {
+        if (version.find("_single") != std::string::npos) {
+            hdr.how = "single";
+        }
+        else if (version.find("_double") != std::string::npos) {
+            hdr.how = "double";
+        }
+        else {
+            std::string msg("ReadParticleFileHeader(): bad version string: ");
+            msg += version;
+            amrex::Error(msg.c_str());
+        }
+    }
+    else {
+        std::string msg("ReadParticleFileHeader(): unknown version string: ");
+        msg += version;
+        amrex::Abort(msg.c_str());
+    }
+
+    int dm;
+    HdrFile >> dm;
+    if (dm != AMREX_SPACEDIM)
+        amrex::Abort("ReadParticleFileHeader(): dm != AMREX_SPACEDIM");
+
+    std::string comp_name;
+    HdrFile >> hdr.num_real;
+    for (int i = 0; i < hdr.num_real; ++i)
+        HdrFile >> comp_name;
+
+    HdrFile >> hdr.num_int;
+    for (int i = 0; i < hdr.num_int; ++i)
+        HdrFile >> comp_name;
+
+    HdrFile >> hdr.is_checkpoint;
+
+    HdrFile >> hdr.nparticles;
+    BL_ASSERT(hdr.nparticles >= 0);
+
+    HdrFile >> hdr.maxnextid;
+    BL_ASSERT(hdr.maxnextid > 0);
+
+    HdrFile >> hdr.finest_level;
+    BL_ASSERT(hdr.finest_level >= 0);
+
+    const int nlevs = hdr.finest_level + 1;
+    Vector<int> ngrids(nlevs);
+    for (int lev = 0; lev < nlevs; lev++) {
+        HdrFile >> ngrids[lev];
+        BL_ASSERT(ngrids[lev] > 0);
+    }
+
+    hdr.which.resize(nlevs);
+    hdr.count.resize(nlevs);
+    hdr.where.resize(nlevs);
+    for (int lev = 0; lev < nlevs; lev++) {
+        hdr.which[lev].resize(ngrids[lev]);
+        hdr.count[lev].resize(ngrids[lev]);
+        hdr.where[lev].resize(ngrids[lev]);
+        for (int i = 0; i < ngrids[lev]; i++) {
+            HdrFile >> hdr.which[lev][i] >> hdr.count[lev][i] >> hdr.where[lev][i];
+        }
+    }
+
+    return hdr;
+}
+
+Vector<BoxArray> ReadParticleFileBoxArrays (const std::string& fullname, int finest_level)
+{
+    Vector<BoxArray> particle_box_arrays(finest_level + 1);
+    for (int lev = 0; lev <= finest_level; lev++)
+    {
+        std::string phdr_name = fullname;
+        phdr_name = amrex::Concatenate(phdr_name + "/Level_", lev, 1);
+        phdr_name += "/Particle_H";
+
+        if (not amrex::FileExists(phdr_name)) continue;
+
+        Vector<char> phdr_chars;
+        ParallelDescriptor::ReadAndBcastFile(phdr_name, phdr_chars);
+        std::string phdr_string(phdr_chars.dataPtr());
+        std::istringstream phdr_file(phdr_string, std::istringstream::in);
+
+        particle_box_arrays[lev].readFrom(phdr_file);
+    }
+    return particle_box_arrays;
+}
+
+void ParticleFileGridsOntoNewGrids (const BoxArray& file_ba, const Vector<int>& count,
+                                    const BoxArray& ba, const DistributionMapping& dm,
+                                    Vector<int>& grids_to_read, Vector<int>& dst_grids)
+{
+    const int MyProc = ParallelDescriptor::MyProc();
+    grids_to_read.clear();
+    dst_grids.clear();
+    for (int i = 0, N = count.size(); i < N; i++) {
+        if (count[i] <= 0) continue;
+        if (i >= file_ba.size())
+            amrex::Abort("ParticleFileGridsOntoNewGrids(): no particle BoxArray in the checkpoint");
+        int dst = i % ba.size();
+        long max_overlap = 0;
+        for (const auto& isect : ba.intersections(file_ba[i])) {
+            const long overlap = isect.second.numPts();
+            if (overlap > max_overlap) {
+                max_overlap = overlap;
+                dst = isect.first;
+            }
+        }
+        if (dm[dst] == MyProc) {
+            grids_to_read.push_back(i);
+            dst_grids.push_back(dst);
+        }
+    }
+}
+
+std::string ParticleDataFileName (const std::string& fullname, int lev,
+                                  const std::string& prefix, int fnum)
+{
+    int DATA_Digits_Read(5);
+    ParmParse pp("particles");
+    pp.query("datadigits_read",DATA_Digits_Read);
+
+    // The file names in the header file are relative.
+    std::string name = fullname;
+
+    if (!name.empty() && name[name.size()-1] != '/')
+        name += '/';
+
+    name += "Level_";
+    name += amrex::Concatenate("", lev, 1);
+    name += '/';
+    name += prefix;
+    name += amrex::Concatenate("", fnum, DATA_Digits_Read);
+    return name;
+}
+
+}
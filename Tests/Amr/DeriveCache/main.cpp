@@ -0,0 +1,236 @@
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Amr.H>
+#include <AMReX_AmrLevel.H>
+#include <AMReX_LevelBld.H>
+
+using namespace amrex;
+
+namespace {
+    // the number of boxes derive_twophi has been called on
+    int num_derive_calls = 0;
+}
+
+void derive_twophi (const Box& bx, FArrayBox& derfab, int dcomp, int /*ncomp*/,
+                    const FArrayBox& datafab, const Geometry& /*geomdata*/,
+                    Real /*time*/, const int* /*bcrec*/, int /*level*/)
+{
+    ++num_derive_calls;
+    const auto der = derfab.array();
+    const auto dat = datafab.const_array();
+    amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+    {
+        der(i,j,k,dcomp) = 2.0*dat(i,j,k);
+    });
+}
+
+void nullfill (Box const& /*bx*/, FArrayBox& /*data*/,
+               const int /*dcomp*/, const int /*numcomp*/,
+               Geometry const& /*geom*/, const Real /*time*/,
+               const Vector<BCRec>& /*bcr*/, const int /*bcomp*/,
+               const int /*scomp*/)
+{}
+
+// A level with a single state component phi, which each step increments
+// by one, and the derived quantity twophi.
+class DeriveLevel
+    :
+    public AmrLevel
+{
+public:
+
+    DeriveLevel () noexcept {}
+
+    DeriveLevel (Amr& papa, int lev, const Geometry& level_geom, const BoxArray& ba,
+                 const DistributionMapping& dm, Real time)
+        : AmrLevel(papa, lev, level_geom, ba, dm, time) {}
+
+    static void variableSetUp ()
+    {
+        desc_lst.addDescriptor(0, IndexType::TheCellType(), StateDescriptor::Point,
+                               0, 1, &cell_cons_interp);
+        int lo_bc[BL_SPACEDIM];
+        int hi_bc[BL_SPACEDIM];
+        for (int i = 0; i < BL_SPACEDIM; ++i) {
+            lo_bc[i] = hi_bc[i] = BCType::int_dir;
+        }
+        BCRec bc(lo_bc, hi_bc);
+        desc_lst.setComponent(0, 0, "phi", bc, StateDescriptor::BndryFunc(nullfill));
+
+        derive_lst.add("twophi", IndexType::TheCellType(), 1, derive_twophi,
+                       DeriveRec::TheSameBox);
+        derive_lst.addComponent("twophi", desc_lst, 0, 0, 1);
+    }
+
+    static void variableCleanUp ()
+    {
+        desc_lst.clear();
+        derive_lst.clear();
+    }
+
+    virtual void computeInitialDt (int, int, Vector<int>& n_cycle, const Vector<IntVect>&,
+                                   Vector<Real>& dt_level, Real) override
+    {
+        n_cycle[0] = 1;
+        dt_level[0] = 0.1;
+    }
+
+    virtual void computeNewDt (int, int, Vector<int>& n_cycle, const Vector<IntVect>&,
+                               Vector<Real>&, Vector<Real>& dt_level, Real, int) override
+    {
+        n_cycle[0] = 1;
+        dt_level[0] = 0.1;
+    }
+
+    virtual Real advance (Real /*time*/, Real dt, int /*iteration*/, int /*ncycle*/) override
+    {
+        state[0].allocOldData();
+        state[0].swapTimeLevels(dt);
+        MultiFab& S_new = get_new_data(0);
+        MultiFab::Copy(S_new, get_old_data(0), 0, 0, 1, 0);
+        S_new.plus(1.0, 0, 1, 0);
+        return dt;
+    }
+
+    virtual void post_timestep (int) override {}
+    virtual void post_regrid (int, int) override {}
+    virtual void post_init (Real) override {}
+    virtual void errorEst (TagBoxArray&, int, int, Real, int, int) override {}
+
+    virtual void initData () override { get_new_data(0).setVal(1.0); }
+
+    virtual void init (AmrLevel& old) override
+    {
+        const Real cur_time = old.get_state_data(0).curTime();
+        const Real prev_time = old.get_state_data(0).prevTime();
+        setTimeLevel(cur_time, cur_time-prev_time, parent->dtLevel(level));
+        FillPatch(old, get_new_data(0), 0, cur_time, 0, 0, 1);
+    }
+
+    virtual void init () override
+    {
+        amrex::Abort("DeriveLevel has no fine levels");
+    }
+};
+
+extern "C" {
+    void amrex_probinit (const int* /*init*/, const int* /*name*/, const int* /*namelen*/,
+                         const amrex_real* /*problo*/, const amrex_real* /*probhi*/)
+    {}
+}
+
+class DeriveLevelBld
+    :
+    public LevelBld
+{
+    virtual void variableSetUp () override { DeriveLevel::variableSetUp(); }
+    virtual void variableCleanUp () override { DeriveLevel::variableCleanUp(); }
+    virtual AmrLevel* operator() () override { return new DeriveLevel; }
+    virtual AmrLevel* operator() (Amr& papa, int lev, const Geometry& level_geom,
+                                  const BoxArray& ba, const DistributionMapping& dm,
+                                  Real time) override
+    {
+        return new DeriveLevel(papa, lev, level_geom, ba, dm, time);
+    }
+};
+
+DeriveLevelBld derive_level_bld;
+
+LevelBld*
+getLevelBld ()
+{
+    return &derive_level_bld;
+}
+
+// The cached result of derive() must never be stale: the data derived
+// after the state has changed, in place, through a new time level or on
+// other grids, has to reflect the change.
+void testDeriveCache ()
+{
+    Amr amr;
+    amr.init(0.0, -1.0);
+
+    AmrLevel& level = amr.getLevel(0);
+    int nerr = 0;
+
+    auto check = [&] (const MultiFab& mf, Real expected, const char* what)
+    {
+        const Real lo = mf.min(0);
+        const Real hi = mf.max(0);
+        if (lo != expected || hi != expected) {
+            amrex::Print() << what << ": derived data in [" << lo << ", " << hi
+                           << "], expected " << expected << "\n";
+            ++nerr;
+        }
+    };
+
+    const Real t = level.get_state_data(0).curTime();
+
+    // A repeated request is served from the cache ...
+    {
+        check(*level.derive("twophi", t, 0), 2.0, "first derive");
+        const int ncalls = num_derive_calls;
+        check(*level.derive("twophi", t, 0), 2.0, "second derive");
+        if (num_derive_calls != ncalls) {
+            amrex::Print() << "second derive was not served from the cache\n";
+            ++nerr;
+        }
+    }
+
+    // ... until the state is changed in place through its accessors, ...
+    level.get_new_data(0).plus(1.0, 0, 1, 0);
+    check(*level.derive("twophi", t, 0), 4.0, "after a change in place");
+
+    // ... or moves to a new time level, even one with the same time, ...
+    MultiFab& phi = level.get_new_data(0);
+    check(*level.derive("twophi", t, 0), 4.0, "before a new time level");
+    phi.plus(1.0, 0, 1, 0);
+    level.get_state_data(0).setNewTimeLevel(t);
+    check(*level.derive("twophi", t, 0), 6.0, "after a new time level");
+
+    // ... or the cache is invalidated explicitly.
+    phi.plus(1.0, 0, 1, 0);
+    AmrLevel::InvalidateDeriveCache();
+    check(*level.derive("twophi", t, 0), 8.0, "after InvalidateDeriveCache");
+
+    // Data derived on other grids are not handed out for the level's grids.
+    {
+        BoxArray ba = level.boxArray();
+        ba.maxSize(8);
+        MultiFab mf(ba, DistributionMapping(ba), 1, 0);
+        level.derive("phi", t, mf, 0);
+        check(mf, 4.0, "phi on other grids");
+        std::unique_ptr<MultiFab> dmf = level.derive("phi", t, 0);
+        if (dmf->boxArray() != level.boxArray()) {
+            amrex::Print() << "phi derived on the wrong grids\n";
+            ++nerr;
+        }
+        check(*dmf, 4.0, "phi on the level's grids");
+    }
+
+    // Time steps and plot files.
+    for (int step = 0; step < 2; ++step) {
+        const Real phimax = level.get_new_data(0).max(0);
+        amr.coarseTimeStep(-1.0);
+        amr.writePlotFile();
+        const Real tnew = level.get_state_data(0).curTime();
+        check(*level.derive("twophi", tnew, 0), 2.0*(phimax+1.0), "after a step");
+    }
+
+    ParallelDescriptor::ReduceIntMax(nerr);
+    if (nerr > 0) {
+        amrex::Abort("DeriveCache test failed");
+    }
+    amrex::Print() << "DeriveCache test passed\n";
+}
+
+int main(int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    testDeriveCache();
+
+    amrex::Finalize();
+}
@@ -0,0 +1,122 @@
+//
+// Refluxes the same registers onto the same coarse data with the all-face
+// FluxRegister::Reflux, which sums the registers of all faces with a single
+// parallel add, and with the per-face Reflux called for every face.  The
+// fine grids touch each other and the boundaries of the periodic domain,
+// and the results must agree to round-off.
+//
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_FluxRegister.H>
+#include <AMReX_Utility.H>
+
+#include <algorithm>
+
+using namespace amrex;
+
+namespace {
+
+void fill_random (FArrayBox& fab, int scomp, int ncomp, Real lo, Real hi)
+{
+    const auto a = fab.array();
+    amrex::LoopOnCpu(fab.box(), ncomp, [&] (int i, int j, int k, int n)
+    {
+        a(i,j,k,n+scomp) = lo + (hi-lo)*amrex::Random();
+    });
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        ParmParse pp;
+        int n_cell = 32;
+        int max_grid_size = 8;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+
+        const int ref = 2;
+        const int nvar = 3;
+        const int scomp = 1;
+        const int dcomp = 2;
+        const int nc = 2;
+        const Real scale = 0.7;
+
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(1,1,1)};
+        Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        // Fine grids, in the index space of the refined domain.  The first
+        // two share a face, and the others touch the high ends of the domain.
+        const int nf = ref*n_cell;
+        BoxList fine_bl;
+        fine_bl.push_back(Box(IntVect(AMREX_D_DECL(0,0,0)),
+                              IntVect(AMREX_D_DECL(nf/4-1,nf/4-1,nf/4-1))));
+        fine_bl.push_back(Box(IntVect(AMREX_D_DECL(nf/4,0,0)),
+                              IntVect(AMREX_D_DECL(nf/2-1,nf/4-1,nf/4-1))));
+        fine_bl.push_back(Box(IntVect(AMREX_D_DECL(3*nf/4,5*nf/8,nf/8)),
+                              IntVect(AMREX_D_DECL(nf-1,nf-1,nf/2-1))));
+        fine_bl.push_back(Box(IntVect(AMREX_D_DECL(5*nf/16,nf/2,5*nf/8)),
+                              IntVect(AMREX_D_DECL(9*nf/16-1,3*nf/4-1,nf-1))));
+        BoxArray fine_ba(fine_bl);
+        fine_ba.maxSize(ref*max_grid_size);
+        DistributionMapping fine_dm(fine_ba);
+
+        FluxRegister fr(fine_ba, fine_dm, IntVect(AMREX_D_DECL(ref,ref,ref)), 1, nvar);
+        for (OrientationIter fi; fi; ++fi)
+        {
+            FabSet& fs = fr[fi()];
+            for (FabSetIter fsi(fs); fsi.isValid(); ++fsi) {
+                fill_random(fs[fsi], 0, nvar, -1.0, 1.0);
+            }
+        }
+
+        MultiFab volume(ba, dm, 1, 0);
+        MultiFab mf_all(ba, dm, nvar+1, 0);
+        for (MFIter mfi(mf_all); mfi.isValid(); ++mfi) {
+            fill_random(volume[mfi], 0, 1, 0.5, 2.0);
+            fill_random(mf_all[mfi], 0, nvar+1, -1.0, 1.0);
+        }
+        MultiFab mf_face(ba, dm, nvar+1, 0);
+        MultiFab::Copy(mf_face, mf_all, 0, 0, nvar+1, 0);
+        MultiFab mf_orig(ba, dm, nvar+1, 0);
+        MultiFab::Copy(mf_orig, mf_all, 0, 0, nvar+1, 0);
+
+        fr.Reflux(mf_all, volume, scale, scomp, dcomp, nc, geom);
+        for (OrientationIter fi; fi; ++fi) {
+            fr.Reflux(mf_face, volume, fi(), scale, scomp, dcomp, nc, geom);
+        }
+
+        // The size of the correction, to make sure there is one.
+        MultiFab::Subtract(mf_orig, mf_face, 0, 0, nvar+1, 0);
+        Real corr = 0.0;
+        for (int n = dcomp; n < dcomp+nc; ++n) {
+            corr = std::max(corr, mf_orig.norm0(n, 0));
+        }
+
+        MultiFab::Subtract(mf_all, mf_face, 0, 0, nvar+1, 0);
+        Real diff = 0.0;
+        for (int n = 0; n <= nvar; ++n) {
+            diff = std::max(diff, mf_all.norm0(n, 0));
+        }
+
+        amrex::Print() << "largest correction : " << corr << "\n"
+                       << "largest difference of the two refluxes : " << diff << "\n";
+
+        if (corr == 0.0 || diff > 1.e-13*corr) {
+            amrex::Abort("FluxRegisterReflux test failed");
+        }
+        amrex::Print() << "FluxRegisterReflux test passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,166 @@
+//
+// Adds the same coarse and fine fluxes to two YAFluxRegisters, once with
+// CrseAdd and FineAdd on all components, and once with the versions taking
+// srccomp, destcomp and numcomp, called on component ranges of fluxes that
+// store the components at other positions.  The component range version
+// is run on tiles that are not aligned with the coarse cells.  Refluxing
+// either register must give the same result.
+//
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_YAFluxRegister.H>
+#include <AMReX_Utility.H>
+
+#include <algorithm>
+
+using namespace amrex;
+
+namespace {
+
+constexpr int ncomp = 3;
+
+// The fluxes of the component range version have an extra component in
+// front of the others.
+constexpr int ioff = 1;
+
+void fill_random (MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        const auto a = mf.array(mfi);
+        amrex::LoopOnCpu(mfi.fabbox(), mf.nComp(), [&] (int i, int j, int k, int n)
+        {
+            a(i,j,k,n) = amrex::Random() - 0.5;
+        });
+    }
+}
+
+void define_fluxes (const BoxArray& ba, const DistributionMapping& dm,
+                    Array<MultiFab,AMREX_SPACEDIM>& flux,
+                    Array<MultiFab,AMREX_SPACEDIM>& flux_off)
+{
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        const BoxArray& fba = amrex::convert(ba, IntVect::TheDimensionVector(idim));
+        flux[idim].define(fba, dm, ncomp, 0);
+        fill_random(flux[idim]);
+        flux_off[idim].define(fba, dm, ncomp+ioff, 0);
+        fill_random(flux_off[idim]);
+        MultiFab::Copy(flux_off[idim], flux[idim], 0, ioff, ncomp, 0);
+    }
+}
+
+std::array<FArrayBox const*,AMREX_SPACEDIM>
+fab_ptrs (const Array<MultiFab,AMREX_SPACEDIM>& flux, const MFIter& mfi)
+{
+    return {AMREX_D_DECL(&flux[0][mfi], &flux[1][mfi], &flux[2][mfi])};
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        ParmParse pp;
+        int n_cell = 32;
+        int max_grid_size = 16;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+
+        const int ref = 2;
+        const Real dt = 0.3;
+
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+        Box cdomain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+        Geometry cgeom(cdomain, rb, CoordSys::cartesian, is_periodic);
+        Geometry fgeom(amrex::refine(cdomain, ref), rb, CoordSys::cartesian, is_periodic);
+
+        BoxArray cba(cdomain);
+        cba.maxSize(max_grid_size);
+        DistributionMapping cdm(cba);
+
+        // Two fine grids sharing a face, one of them at the domain boundary.
+        const int nf = ref*n_cell;
+        BoxList fine_bl;
+        fine_bl.push_back(Box(IntVect(AMREX_D_DECL(nf/4,nf/4,nf/4)),
+                              IntVect(AMREX_D_DECL(nf/2-1,3*nf/4-1,nf/2-1))));
+        fine_bl.push_back(Box(IntVect(AMREX_D_DECL(nf/2,nf/8,0)),
+                              IntVect(AMREX_D_DECL(3*nf/4-1,nf/2-1,nf/2-1))));
+        BoxArray fba(fine_bl);
+        fba.maxSize(ref*max_grid_size);
+        DistributionMapping fdm(fba);
+
+        Array<MultiFab,AMREX_SPACEDIM> cflux, cflux_off, fflux, fflux_off;
+        define_fluxes(cba, cdm, cflux, cflux_off);
+        define_fluxes(fba, fdm, fflux, fflux_off);
+
+        const IntVect ratio(AMREX_D_DECL(ref,ref,ref));
+        YAFluxRegister fr_all(fba, cba, fdm, cdm, fgeom, cgeom, ratio, 1, ncomp);
+        YAFluxRegister fr_part(fba, cba, fdm, cdm, fgeom, cgeom, ratio, 1, ncomp);
+
+        const Real* cdx = cgeom.CellSize();
+        const Real* fdx = fgeom.CellSize();
+
+        for (MFIter mfi(cflux[0].boxArray(), cdm); mfi.isValid(); ++mfi)
+        {
+            const auto flux = fab_ptrs(cflux, mfi);
+            const auto flux_off = fab_ptrs(cflux_off, mfi);
+            fr_all.CrseAdd(mfi, flux, cdx, dt, RunOn::Cpu);
+            fr_part.CrseAdd(mfi, flux_off, cdx, dt, ioff, 0, 2, RunOn::Cpu);
+            fr_part.CrseAdd(mfi, flux_off, cdx, dt, ioff+2, 2, ncomp-2, RunOn::Cpu);
+        }
+
+        for (MFIter mfi(fba, fdm); mfi.isValid(); ++mfi)
+        {
+            fr_all.FineAdd(mfi, fab_ptrs(fflux, mfi), fdx, dt, RunOn::Cpu);
+        }
+
+        // Odd tile sizes, so that tiles split coarse cells.  As in a tiled
+        // time step, the fluxes passed are those of the faces of the tile.
+        const IntVect tile_size(AMREX_D_DECL(1024,5,3));
+        for (MFIter mfi(fba, fdm, MFItInfo().EnableTiling(tile_size)); mfi.isValid(); ++mfi)
+        {
+            Array<FArrayBox,AMREX_SPACEDIM> tile_flux;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                tile_flux[idim].resize(mfi.nodaltilebox(idim), ncomp+ioff);
+                tile_flux[idim].copy(fflux_off[idim][mfi]);
+            }
+            const std::array<FArrayBox const*,AMREX_SPACEDIM> flux_off
+                {AMREX_D_DECL(&tile_flux[0], &tile_flux[1], &tile_flux[2])};
+            fr_part.FineAdd(mfi, flux_off, fdx, dt, ioff, 0, 2, RunOn::Cpu);
+            fr_part.FineAdd(mfi, flux_off, fdx, dt, ioff+2, 2, ncomp-2, RunOn::Cpu);
+        }
+
+        MultiFab state_all(cba, cdm, ncomp, 0);
+        MultiFab state_part(cba, cdm, ncomp, 0);
+        state_all.setVal(0.0);
+        state_part.setVal(0.0);
+        fr_all.Reflux(state_all);
+        fr_part.Reflux(state_part);
+
+        Real corr = 0.0;
+        for (int n = 0; n < ncomp; ++n) {
+            corr = std::max(corr, state_all.norm0(n));
+        }
+
+        MultiFab::Subtract(state_part, state_all, 0, 0, ncomp, 0);
+        Real diff = 0.0;
+        for (int n = 0; n < ncomp; ++n) {
+            diff = std::max(diff, state_part.norm0(n));
+        }
+
+        amrex::Print() << "largest correction : " << corr << "\n"
+                       << "largest difference of the two refluxes : " << diff << "\n";
+
+        if (corr == 0.0 || diff > 1.e-13*corr) {
+            amrex::Abort("YAFluxRegisterComponents test failed");
+        }
+        amrex::Print() << "YAFluxRegisterComponents test passed\n";
+    }
+    amrex::Finalize();
+}
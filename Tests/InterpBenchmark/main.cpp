@@ -0,0 +1,358 @@
+//
+// Compares the cache-blocked cpu interpolation kernels against the
+// whole-box C++ kernels and the Fortran routines they replace.  The PPM
+// interpolater has no reference; it is timed against CellConservativeLinear
+// and checked for conservation.
+//
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_Interpolater.H>
+#include <AMReX_Interp_C.H>
+#include <AMReX_INTERP_F.H>
+
+using namespace amrex;
+
+namespace {
+
+void init_crse (FArrayBox& fab, const Geometry& geom)
+{
+    const Box& bx = fab.box();
+    const auto dx = geom.CellSizeArray();
+    const auto lo = amrex::lbound(bx);
+    const auto hi = amrex::ubound(bx);
+    Array4<Real> const& a = fab.array();
+    for (int n = 0; n < fab.nComp(); ++n) {
+        for         (int k = lo.z; k <= hi.z; ++k) {
+            for     (int j = lo.y; j <= hi.y; ++j) {
+                for (int i = lo.x; i <= hi.x; ++i) {
+                    const Real x = (i+0.5)*dx[0];
+                    AMREX_D_TERM(,const Real y = (j+0.5)*dx[1];,const Real z = (k+0.5)*dx[2];)
+                    Real r = std::sin(6.28*(n+1)*x) AMREX_D_TERM(,*std::cos(3.14*y),+std::tanh(8.*(z-0.5)));
+                    if (n > 0 && amrex::Random() < 0.05) r = -r;
+                    a(i,j,k,n) = r;
+                }
+            }
+        }
+    }
+}
+
+Real max_diff (const FArrayBox& a, const FArrayBox& b, const Box& bx, int ncomp)
+{
+    FArrayBox d(bx, ncomp);
+    d.copy(a, bx, 0, bx, 0, ncomp);
+    d.minus(b, bx, 0, 0, ncomp);
+    Real r = 0.0;
+    for (int n = 0; n < ncomp; ++n) {
+        r = std::max(r, d.norm(bx, 0, n, 1));
+    }
+    return r;
+}
+
+// Max difference between crse and the average of fine over each coarse cell.
+Real conservation_error (const FArrayBox& crse, const FArrayBox& fine, const Box& crse_region,
+                         const IntVect& ratio, int ncomp)
+{
+    const auto lo = amrex::lbound(crse_region);
+    const auto hi = amrex::ubound(crse_region);
+    Array4<Real const> const& c = crse.const_array();
+    Array4<Real const> const& f = fine.const_array();
+    const int rx = ratio[0];
+    const int ry = (AMREX_SPACEDIM > 1) ? ratio[1] : 1;
+    const int rz = (AMREX_SPACEDIM > 2) ? ratio[2] : 1;
+    const Real volinv = 1.0/(rx*ry*rz);
+    Real r = 0.0;
+    for (int n = 0; n < ncomp; ++n) {
+        for         (int k = lo.z; k <= hi.z; ++k) {
+            for     (int j = lo.y; j <= hi.y; ++j) {
+                for (int i = lo.x; i <= hi.x; ++i) {
+                    Real avg = 0.0;
+                    for         (int kk = 0; kk < rz; ++kk) {
+                        for     (int jj = 0; jj < ry; ++jj) {
+                            for (int ii = 0; ii < rx; ++ii) {
+                                avg += f(i*rx+ii,j*ry+jj,k*rz+kk,n);
+                            }
+                        }
+                    }
+                    r = std::max(r, std::abs(avg*volinv - c(i,j,k,n)));
+                }
+            }
+        }
+    }
+    return r;
+}
+
+void report (const std::string& name, double t_new, double t_ref, Real err)
+{
+    amrex::Print() << std::left << std::setw(36) << name
+                   << " new: " << std::setw(12) << t_new
+                   << " reference: " << std::setw(12) << t_ref
+                   << " speedup: " << std::setw(8) << t_ref/t_new
+                   << " max diff: " << err << "\n";
+}
+
+// CellConservativeLinear with the whole-box kernels.
+void ref_cellconslin (const FArrayBox& crse, FArrayBox& fine, int ncomp, const Box& fine_region,
+                      const IntVect& ratio, const Geometry& cgeom, const Geometry& fgeom,
+                      Vector<BCRec> const& bcr, bool linlim)
+{
+    const Box& cslope_bx = amrex::coarsen(fine_region,ratio);
+    const int ntmp = linlim ? (ncomp+1)*AMREX_SPACEDIM : ncomp*(AMREX_SPACEDIM+2);
+    FArrayBox ccfab(cslope_bx, ntmp);
+    Array4<Real> const& ccarr = ccfab.array();
+    Array4<Real const> const& crsearr = crse.const_array();
+    Array4<Real> const& finearr = fine.array();
+    const Vector<Real>& voff = amrex::ccinterp_compute_voff(cslope_bx, ratio, cgeom, fgeom);
+    if (linlim) {
+        amrex::cellconslin_slopes_linlim(cslope_bx, ccarr, crsearr, 0, ncomp, bcr.data(), cslope_bx);
+    } else {
+        const Box& fslope_bx = amrex::refine(cslope_bx,ratio);
+        FArrayBox fafab(fslope_bx, ncomp);
+        Array4<Real> const& faarr = fafab.array();
+        amrex::cellconslin_slopes_mclim(cslope_bx, ccarr, crsearr, 0, ncomp, bcr.data(), cslope_bx);
+        amrex::cellconslin_fine_alpha(fslope_bx, faarr, ccarr, ncomp, voff.data(), ratio);
+        amrex::cellconslin_slopes_mmlim(cslope_bx, ccarr, faarr, ncomp, ratio);
+    }
+    amrex::cellconslin_interp(fine_region, finearr, 0, ncomp, ccarr, crsearr, 0, voff.data(), ratio);
+}
+
+// NodeBilinear with the whole-box kernels.
+void ref_nodebilin (const FArrayBox& crse, FArrayBox& fine, int ncomp, const Box& fine_region,
+                    const IntVect& ratio)
+{
+    const Box& cslope_bx = amrex::enclosedCells(node_bilinear_interp.CoarseBox(fine_region,ratio));
+    FArrayBox slopefab(cslope_bx, ncomp*(AMREX_D_TERM(2,*2,*2)-1));
+    Array4<Real> const& slopearr = slopefab.array();
+    amrex::nodebilin_slopes(cslope_bx, slopearr, crse.const_array(), 0, ncomp, ratio);
+    amrex::nodebilin_interp(fine_region, fine.array(), 0, ncomp, slopearr, crse.const_array(), 0, ratio);
+}
+
+#if (AMREX_SPACEDIM == 2)
+// CellQuadratic with the Fortran routine.
+void ref_cellquad (FArrayBox& crse, FArrayBox& fine, int ncomp, const Box& fine_region,
+                   const IntVect& ratio, const Geometry& cgeom, const Geometry& fgeom,
+                   Vector<BCRec> const& bcr)
+{
+    Box target_fine_region = fine_region & fine.box();
+    Box crse_bx(amrex::coarsen(target_fine_region,ratio));
+    Box fslope_bx(amrex::refine(crse_bx,ratio));
+    Box cslope_bx(crse_bx);
+    cslope_bx.grow(1);
+    int c_len = cslope_bx.numPts();
+    Vector<Real> cslope(5*c_len);
+    int loslp = cslope_bx.index(crse_bx.smallEnd());
+    int hislp = cslope_bx.index(crse_bx.bigEnd());
+    int clo = 1 - loslp;
+    int chi = clo + cslope_bx.numPts() - 1;
+    c_len = hislp - loslp + 1;
+    int dir;
+    int f_len = fslope_bx.longside(dir);
+    Vector<Real> strip((5+2)*f_len);
+    Real* fstrip = strip.dataPtr();
+    Real* foff   = fstrip + f_len;
+    Real* fslope = foff + f_len;
+    Vector<Real> fvc[AMREX_SPACEDIM];
+    Vector<Real> cvc[AMREX_SPACEDIM];
+    for (dir = 0; dir < AMREX_SPACEDIM; dir++) {
+        fgeom.GetEdgeVolCoord(fvc[dir],target_fine_region,dir);
+        cgeom.GetEdgeVolCoord(cvc[dir],crse_bx,dir);
+    }
+    int slope_flag = 1;
+    int actual_comp = 0, actual_state = 0;
+    Vector<int> bc = Interpolater::GetBCArray(bcr);
+    amrex_cqinterp(fine.dataPtr(), AMREX_ARLIM(fine.loVect()), AMREX_ARLIM(fine.hiVect()),
+                   AMREX_ARLIM(target_fine_region.loVect()), AMREX_ARLIM(target_fine_region.hiVect()),
+                   &ncomp, AMREX_D_DECL(&ratio[0],&ratio[1],&ratio[2]),
+                   crse.dataPtr(), &clo, &chi,
+                   AMREX_ARLIM(crse_bx.loVect()), AMREX_ARLIM(crse_bx.hiVect()),
+                   fslope_bx.loVect(), fslope_bx.hiVect(),
+                   cslope.dataPtr(), &c_len, fslope, fstrip, &f_len, foff,
+                   bc.dataPtr(), &slope_flag,
+                   AMREX_D_DECL(fvc[0].dataPtr(),fvc[1].dataPtr(),fvc[2].dataPtr()),
+                   AMREX_D_DECL(cvc[0].dataPtr(),cvc[1].dataPtr(),cvc[2].dataPtr()),
+                   &actual_comp, &actual_state);
+}
+#endif
+
+#if (AMREX_SPACEDIM > 1)
+// CellConservativeProtected::protect with the Fortran routine.
+void ref_protect (const FArrayBox& crse, FArrayBox& fine, FArrayBox& fine_state, int ncomp,
+                  const Box& fine_region, const IntVect& ratio,
+                  const Geometry& cgeom, const Geometry& fgeom, Vector<BCRec> const& bcr)
+{
+    Box target_fine_region = fine_region & fine.box();
+    Box crse_bx = protected_interp.CoarseBox(target_fine_region,ratio);
+    Box cs_bx(crse_bx);
+    cs_bx.grow(-1);
+#if (AMREX_SPACEDIM == 2)
+    Vector<Real> fvc[AMREX_SPACEDIM];
+    Vector<Real> cvc[AMREX_SPACEDIM];
+    int cvcbhi[AMREX_SPACEDIM];
+    int fvcbhi[AMREX_SPACEDIM];
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+        fgeom.GetEdgeVolCoord(fvc[dir],target_fine_region,dir);
+        cgeom.GetEdgeVolCoord(cvc[dir],crse_bx,dir);
+        cvcbhi[dir] = crse_bx.smallEnd(dir) + cvc[dir].size() - 1;
+        fvcbhi[dir] = target_fine_region.smallEnd(dir) + fvc[dir].size() - 1;
+    }
+#endif
+    Vector<int> bc = Interpolater::GetBCArray(bcr);
+    amrex_protect_interp(fine.dataPtr(), AMREX_ARLIM(fine.loVect()), AMREX_ARLIM(fine.hiVect()),
+                         target_fine_region.loVect(), target_fine_region.hiVect(),
+                         crse.dataPtr(), AMREX_ARLIM(crse.loVect()), AMREX_ARLIM(crse.hiVect()),
+                         cs_bx.loVect(), cs_bx.hiVect(),
+#if (AMREX_SPACEDIM == 2)
+                         fvc[0].dataPtr(), fvc[1].dataPtr(),
+                         AMREX_ARLIM(target_fine_region.loVect()), AMREX_ARLIM(fvcbhi),
+                         cvc[0].dataPtr(), cvc[1].dataPtr(),
+                         AMREX_ARLIM(crse_bx.loVect()), AMREX_ARLIM(cvcbhi),
+#endif
+                         fine_state.dataPtr(), AMREX_ARLIM(fine_state.loVect()), AMREX_ARLIM(fine_state.hiVect()),
+                         &ncomp, AMREX_D_DECL(&ratio[0],&ratio[1],&ratio[2]), bc.dataPtr());
+}
+#endif
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 128;
+        int ncomp = 4;
+        int rr = 2;
+        int nrep = 10;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("ncomp", ncomp);
+            pp.query("ratio", rr);
+            pp.query("nrep", nrep);
+        }
+
+        const IntVect ratio(AMREX_D_DECL(rr,rr,rr));
+        const Box fine_domain(IntVect(0), IntVect(n_cell-1));
+        const Box crse_domain = amrex::coarsen(fine_domain, ratio);
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+        const Geometry cgeom(crse_domain, rb, CoordSys::cartesian, is_periodic);
+        const Geometry fgeom(fine_domain, rb, CoordSys::cartesian, is_periodic);
+
+        Vector<BCRec> bcr(ncomp, BCRec(AMREX_D_DECL(BCType::int_dir,BCType::int_dir,BCType::int_dir),
+                                       AMREX_D_DECL(BCType::int_dir,BCType::int_dir,BCType::int_dir)));
+
+        FArrayBox crse(amrex::grow(crse_domain,2), ncomp);
+        init_crse(crse, cgeom);
+
+        amrex::Print() << "n_cell = " << n_cell << ", ncomp = " << ncomp << ", ratio = " << rr
+                       << ", nrep = " << nrep << "\n\n";
+
+        FArrayBox fnew(fine_domain, ncomp), fref(fine_domain, ncomp);
+
+        for (int linlim = 1; linlim >= 0; --linlim)
+        {
+            CellConservativeLinear& interp = linlim ? lincc_interp : cell_cons_interp;
+            double t0 = amrex::second();
+            for (int irep = 0; irep < nrep; ++irep) {
+                interp.interp(crse, 0, fnew, 0, ncomp, fine_domain, ratio, cgeom, fgeom, bcr,
+                              0, 0, RunOn::Cpu);
+            }
+            double t1 = amrex::second();
+            for (int irep = 0; irep < nrep; ++irep) {
+                ref_cellconslin(crse, fref, ncomp, fine_domain, ratio, cgeom, fgeom, bcr, linlim);
+            }
+            double t2 = amrex::second();
+            report(linlim ? "CellConservativeLinear (lin lim)" : "CellConservativeLinear (mc lim)",
+                   t1-t0, t2-t1, max_diff(fnew, fref, fine_domain, ncomp));
+        }
+
+        {
+            const Box& fine_nd = amrex::surroundingNodes(fine_domain);
+            FArrayBox crse_nd(amrex::surroundingNodes(crse_domain), ncomp);
+            init_crse(crse_nd, cgeom);
+            FArrayBox fnew_nd(fine_nd, ncomp), fref_nd(fine_nd, ncomp);
+            double t0 = amrex::second();
+            for (int irep = 0; irep < nrep; ++irep) {
+                node_bilinear_interp.interp(crse_nd, 0, fnew_nd, 0, ncomp, fine_nd, ratio, cgeom, fgeom,
+                                            bcr, 0, 0, RunOn::Cpu);
+            }
+            double t1 = amrex::second();
+            for (int irep = 0; irep < nrep; ++irep) {
+                ref_nodebilin(crse_nd, fref_nd, ncomp, fine_nd, ratio);
+            }
+            double t2 = amrex::second();
+            report("NodeBilinear", t1-t0, t2-t1, max_diff(fnew_nd, fref_nd, fine_nd, ncomp));
+        }
+
+#if (AMREX_SPACEDIM == 2)
+        {
+            // the Fortran routine expects crse to be exactly the slope box
+            FArrayBox crse_copy(quadratic_interp.CoarseBox(fine_domain,ratio), ncomp);
+            crse_copy.copy(crse, crse_copy.box());
+            double t0 = amrex::second();
+            for (int irep = 0; irep < nrep; ++irep) {
+                quadratic_interp.interp(crse, 0, fnew, 0, ncomp, fine_domain, ratio, cgeom, fgeom, bcr,
+                                        0, 0, RunOn::Cpu);
+            }
+            double t1 = amrex::second();
+            for (int irep = 0; irep < nrep; ++irep) {
+                ref_cellquad(crse_copy, fref, ncomp, fine_domain, ratio, cgeom, fgeom, bcr);
+            }
+            double t2 = amrex::second();
+            report("CellQuadratic", t1-t0, t2-t1, max_diff(fnew, fref, fine_domain, ncomp));
+        }
+#endif
+
+#if (AMREX_SPACEDIM > 1)
+        {
+            FArrayBox state(fine_domain, ncomp);
+            lincc_interp.interp(crse, 0, state, 0, ncomp, fine_domain, ratio, cgeom, fgeom, bcr,
+                                0, 0, RunOn::Cpu);
+            FArrayBox corr(fine_domain, ncomp);
+            lincc_interp.interp(crse, 0, corr, 0, ncomp, fine_domain, ratio, cgeom, fgeom, bcr,
+                                0, 0, RunOn::Cpu);
+            corr.mult(-0.9);
+            state.plus(0.05);
+            double t_new = 0., t_ref = 0.;
+            for (int irep = 0; irep < nrep; ++irep) {
+                fnew.copy(corr);
+                fref.copy(corr);
+                double t0 = amrex::second();
+                protected_interp.protect(crse, 0, fnew, 0, state, 0, ncomp, fine_domain, ratio,
+                                         cgeom, fgeom, bcr, RunOn::Cpu);
+                double t1 = amrex::second();
+                ref_protect(crse, fref, state, ncomp, fine_domain, ratio, cgeom, fgeom, bcr);
+                double t2 = amrex::second();
+                t_new += t1-t0;
+                t_ref += t2-t1;
+            }
+            report("CellConservativeProtected::protect", t_new, t_ref,
+                   max_diff(fnew, fref, fine_domain, ncomp));
+        }
+#endif
+
+        {
+            double t0 = amrex::second();
+            for (int irep = 0; irep < nrep; ++irep) {
+                ppm_interp.interp(crse, 0, fnew, 0, ncomp, fine_domain, ratio, cgeom, fgeom, bcr,
+                                  0, 0, RunOn::Cpu);
+            }
+            double t1 = amrex::second();
+            for (int irep = 0; irep < nrep; ++irep) {
+                lincc_interp.interp(crse, 0, fref, 0, ncomp, fine_domain, ratio, cgeom, fgeom, bcr,
+                                    0, 0, RunOn::Cpu);
+            }
+            double t2 = amrex::second();
+            amrex::Print() << std::left << std::setw(36) << "CellConservativePPM"
+                           << " new: " << std::setw(12) << t1-t0
+                           << " lincc: " << std::setw(12) << t2-t1
+                           << " conservation error: "
+                           << conservation_error(crse, fnew, crse_domain, ratio, ncomp) << "\n";
+        }
+    }
+    amrex::Finalize();
+}
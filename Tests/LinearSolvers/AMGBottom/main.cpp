@@ -0,0 +1,185 @@
+//
+// Compares the AMG bottom solver with the default bottom solver on a
+// problem whose coefficient jumps by 1e4 between blocks of cells.
+//
+// The problem is solved once without coarsening, so that the bottom solver
+// solves the whole problem.  AMG is given a tight bottom tolerance and few
+// bottom iterations, within which bicgstab stalls on this problem, and
+// must still converge in fewer MLMG iterations than the default bottom
+// solver with its default settings.  This also shows that it did not fall
+// back to bicgstab.  The problem is solved again with the default
+// multigrid hierarchy.  All solves must reach the tolerance, checked with
+// a residual computed independently of the solver, and give the same
+// solution as the default bottom solver.
+//
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+namespace {
+
+struct Problem
+{
+    Geometry geom;
+    BoxArray ba;
+    DistributionMapping dm;
+    MultiFab rhs;
+    MultiFab acoef;
+    Array<MultiFab,AMREX_SPACEDIM> bcoef;
+};
+
+// (a - div b grad) phi = rhs on the unit cube with phi = 0 on the
+// boundary, a small and b either 1 or 1e4 on a checkerboard of blocks of
+// 4^3 cells.
+void init_problem (int n_cell, int max_grid_size, Problem& prob)
+{
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+    Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+    prob.geom.define(domain, rb, CoordSys::cartesian, is_periodic);
+
+    prob.ba.define(domain);
+    prob.ba.maxSize(max_grid_size);
+    prob.dm.define(prob.ba);
+
+    prob.rhs.define(prob.ba, prob.dm, 1, 0);
+    prob.acoef.define(prob.ba, prob.dm, 1, 0);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        prob.bcoef[idim].define(amrex::convert(prob.ba, IntVect::TheDimensionVector(idim)),
+                                prob.dm, 1, 0);
+    }
+
+    const auto dx = prob.geom.CellSizeArray();
+    const Real pi = 4.0*std::atan(1.0);
+    for (MFIter mfi(prob.rhs); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto rhs = prob.rhs.array(mfi);
+        const auto a = prob.acoef.array(mfi);
+        amrex::LoopOnCpu(bx, [&] (int i, int j, int k)
+        {
+            const Real x = (i+0.5)*dx[0];
+            const Real y = (j+0.5)*dx[1];
+            const Real z = (k+0.5)*dx[2];
+            rhs(i,j,k) = std::sin(pi*x)*std::sin(2.*pi*y)*std::sin(3.*pi*z) + (x-0.5)*y;
+            a(i,j,k) = 1.e-3;
+        });
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const Box& fbx = amrex::surroundingNodes(bx, idim);
+            const auto b = prob.bcoef[idim].array(mfi);
+            amrex::LoopOnCpu(fbx, [&] (int i, int j, int k)
+            {
+                // The block of the cell on the high side of the face.
+                const int block = i/4 + j/4 + k/4;
+                b(i,j,k) = (block % 2 == 0) ? 1.0 : 1.e4;
+            });
+        }
+    }
+}
+
+// Returns the number of iterations, and in resid the residual of phi
+// relative to the right-hand side.
+int solve (const Problem& prob, MLMG::BottomSolver bottom_solver, int max_coarsening_level,
+           Real bottom_tol_rel, int bottom_max_iter, Real tol_rel, MultiFab& phi, Real& resid)
+{
+    LPInfo info;
+    if (max_coarsening_level >= 0) info.setMaxCoarseningLevel(max_coarsening_level);
+
+    MLABecLaplacian mlabec({prob.geom}, {prob.ba}, {prob.dm}, info);
+    mlabec.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)},
+                       {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)});
+    phi.setVal(0.0);
+    mlabec.setLevelBC(0, &phi);
+    mlabec.setScalars(1.0, 1.0);
+    mlabec.setACoeffs(0, prob.acoef);
+    mlabec.setBCoeffs(0, amrex::GetArrOfConstPtrs(prob.bcoef));
+
+    MLMG mlmg(mlabec);
+    mlmg.setVerbose(0);
+    mlmg.setCollectStats(1);
+    mlmg.setMaxIter(200);
+    mlmg.setBottomSolver(bottom_solver);
+    if (bottom_tol_rel > 0.0) mlmg.setBottomTolerance(bottom_tol_rel);
+    if (bottom_max_iter > 0) mlmg.setBottomMaxIter(bottom_max_iter);
+    mlmg.solve({&phi}, {&prob.rhs}, tol_rel, 0.0);
+
+    MultiFab res(prob.ba, prob.dm, 1, 0);
+    mlmg.compResidual({&res}, {&phi}, {&prob.rhs});
+    resid = res.norm0() / prob.rhs.norm0();
+
+    return mlmg.getStats().numIters();
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        ParmParse pp;
+        int n_cell = 32;
+        int max_grid_size = 8;
+        Real tol_rel = 1.e-10;
+        Real bottom_tol_rel = 1.e-6;
+        int bottom_max_iter = 50;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("tol_rel", tol_rel);
+        pp.query("bottom_tol_rel", bottom_tol_rel);
+        pp.query("bottom_max_iter", bottom_max_iter);
+
+        Problem prob;
+        init_problem(n_cell, max_grid_size, prob);
+
+        int nerr = 0;
+        // Without coarsening and with the default number of levels.
+        for (int max_coarsening_level : {0, -1})
+        {
+            const Real btol = (max_coarsening_level == 0) ? bottom_tol_rel : -1.0;
+            const int bmaxiter = (max_coarsening_level == 0) ? bottom_max_iter : -1;
+
+            MultiFab phi_ref(prob.ba, prob.dm, 1, 1);
+            MultiFab phi(prob.ba, prob.dm, 1, 1);
+            Real resid_ref, resid;
+            const int iters_ref = solve(prob, MLMG::BottomSolver::Default, max_coarsening_level,
+                                        -1.0, -1, tol_rel, phi_ref, resid_ref);
+            const int iters = solve(prob, MLMG::BottomSolver::amg, max_coarsening_level,
+                                    btol, bmaxiter, tol_rel, phi, resid);
+
+            MultiFab::Subtract(phi, phi_ref, 0, 0, 1, 0);
+            const Real diff = phi.norm0() / phi_ref.norm0();
+
+            amrex::Print() << "max_coarsening_level " << max_coarsening_level << "\n"
+                           << "  default bottom : " << iters_ref << " iterations, residual "
+                           << resid_ref << "\n"
+                           << "  amg bottom     : " << iters << " iterations, residual "
+                           << resid << "\n"
+                           << "  relative difference of the solutions : " << diff << "\n";
+
+            if (resid_ref > tol_rel || resid > tol_rel) ++nerr;
+            if (iters > iters_ref) ++nerr;
+            if (max_coarsening_level == 0 && iters >= iters_ref) ++nerr;
+            if (diff > 100.*tol_rel) ++nerr;
+        }
+
+        if (nerr > 0) {
+            amrex::Abort("AMGBottom test failed");
+        }
+        amrex::Print() << "AMGBottom test passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,194 @@
+//
+// Solves a variable coefficient problem with MLABecLaplacian and a
+// constant coefficient one with MLPoisson, with the gsrb_blocked smoother
+// doing several red-black Gauss-Seidel sweeps per ghost cell exchange, and
+// with the default gsrb smoother doing the same sweeps one by one.  The
+// domain has Dirichlet, Neumann and periodic boundaries, and the boundary
+// conditions are extrapolated with maxorder 2 and 3.  The two smoothers
+// must give the same iterations and the same solution to the last bit,
+// which also holds on the coarse levels where gsrb_blocked falls back to
+// plain sweeps.
+//
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLPoisson.H>
+#include <AMReX_MLMG.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+namespace {
+
+struct Problem
+{
+    Geometry geom;
+    BoxArray ba;
+    DistributionMapping dm;
+    MultiFab rhs;
+    MultiFab acoef;
+    Array<MultiFab,AMREX_SPACEDIM> bcoef;
+};
+
+// (a - div b grad) phi = rhs on the unit cube, periodic in y, with b
+// varying by a factor of 20 and a small.
+void init_problem (int n_cell, int max_grid_size, Problem& prob)
+{
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,1,0)};
+    Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+    prob.geom.define(domain, rb, CoordSys::cartesian, is_periodic);
+
+    prob.ba.define(domain);
+    prob.ba.maxSize(max_grid_size);
+    prob.dm.define(prob.ba);
+
+    prob.rhs.define(prob.ba, prob.dm, 1, 0);
+    prob.acoef.define(prob.ba, prob.dm, 1, 0);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        prob.bcoef[idim].define(amrex::convert(prob.ba, IntVect::TheDimensionVector(idim)),
+                                prob.dm, 1, 0);
+    }
+
+    const auto dx = prob.geom.CellSizeArray();
+    const Real pi = 4.0*std::atan(1.0);
+    for (MFIter mfi(prob.rhs); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto rhs = prob.rhs.array(mfi);
+        const auto a = prob.acoef.array(mfi);
+        amrex::LoopOnCpu(bx, [&] (int i, int j, int k)
+        {
+            const Real x = (i+0.5)*dx[0];
+            const Real y = (j+0.5)*dx[1];
+            const Real z = (k+0.5)*dx[2];
+            rhs(i,j,k) = std::sin(pi*x)*std::cos(2.*pi*y)*std::cos(pi*z) + x*(z-0.5);
+            a(i,j,k) = 1.e-3;
+        });
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const Box& fbx = amrex::surroundingNodes(bx, idim);
+            const auto b = prob.bcoef[idim].array(mfi);
+            amrex::LoopOnCpu(fbx, [&] (int i, int j, int k)
+            {
+                const Real x = (i + (idim == 0 ? 0.0 : 0.5))*dx[0];
+                const Real y = (j + (idim == 1 ? 0.0 : 0.5))*dx[1];
+                const Real z = (k + (idim == 2 ? 0.0 : 0.5))*dx[2];
+                b(i,j,k) = 1.0 + 9.5*(1.0 + std::sin(4.*pi*x)*std::cos(2.*pi*y)*std::sin(5.*pi*z));
+            });
+        }
+    }
+}
+
+// Solves with MLABecLaplacian, or MLPoisson if poisson, and returns the
+// number of iterations and the time of the solve.  With blocked, the
+// smoother does sweeps sweeps per smooth, and otherwise MLMG smooths sweeps
+// times with one sweep each.
+int solve (const Problem& prob, bool poisson, bool blocked, int sweeps, int maxorder,
+           Real tol_rel, MultiFab& phi, Real& time)
+{
+    LPInfo info;
+    if (blocked) {
+        info.setSmoother(MLSmoother::gsrb_blocked).setSmootherSweeps(sweeps);
+    }
+
+    const Array<LinOpBCType,AMREX_SPACEDIM> lobc
+        {AMREX_D_DECL(LinOpBCType::Dirichlet, LinOpBCType::Periodic, LinOpBCType::Neumann)};
+    const Array<LinOpBCType,AMREX_SPACEDIM> hibc
+        {AMREX_D_DECL(LinOpBCType::Dirichlet, LinOpBCType::Periodic, LinOpBCType::Dirichlet)};
+
+    std::unique_ptr<MLLinOp> linop;
+    if (poisson) {
+        auto* mlpoisson = new MLPoisson({prob.geom}, {prob.ba}, {prob.dm}, info);
+        mlpoisson->setDomainBC(lobc, hibc);
+        mlpoisson->setMaxOrder(maxorder);
+        phi.setVal(0.0);
+        mlpoisson->setLevelBC(0, &phi);
+        linop.reset(mlpoisson);
+    } else {
+        auto* mlabec = new MLABecLaplacian({prob.geom}, {prob.ba}, {prob.dm}, info);
+        mlabec->setDomainBC(lobc, hibc);
+        mlabec->setMaxOrder(maxorder);
+        phi.setVal(0.0);
+        mlabec->setLevelBC(0, &phi);
+        mlabec->setScalars(1.0, 1.0);
+        mlabec->setACoeffs(0, prob.acoef);
+        mlabec->setBCoeffs(0, amrex::GetArrOfConstPtrs(prob.bcoef));
+        linop.reset(mlabec);
+    }
+
+    MLMG mlmg(*linop);
+    mlmg.setVerbose(0);
+    mlmg.setCollectStats(1);
+    const int nu = blocked ? 1 : sweeps;
+    mlmg.setPreSmooth(nu);
+    mlmg.setPostSmooth(nu);
+    mlmg.setFinalSmooth(nu);
+    mlmg.setBottomSmooth(nu);
+
+    ParallelDescriptor::Barrier();
+    const Real t0 = amrex::second();
+    mlmg.solve({&phi}, {&prob.rhs}, tol_rel, 0.0);
+    time = amrex::second() - t0;
+    ParallelDescriptor::ReduceRealMax(time);
+
+    return mlmg.getStats().numIters();
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        ParmParse pp;
+        int n_cell = 64;
+        int max_grid_size = 32;
+        int sweeps = 2;
+        Real tol_rel = 1.e-10;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("sweeps", sweeps);
+        pp.query("tol_rel", tol_rel);
+
+        Problem prob;
+        init_problem(n_cell, max_grid_size, prob);
+
+        int nerr = 0;
+        for (int poisson = 0; poisson < 2; ++poisson)
+        for (int maxorder = 2; maxorder <= 3; ++maxorder)
+        {
+            MultiFab phi(prob.ba, prob.dm, 1, 1);
+            MultiFab phi_blocked(prob.ba, prob.dm, 1, 1);
+            Real time, time_blocked;
+            const int niters = solve(prob, poisson, false, sweeps, maxorder, tol_rel,
+                                     phi, time);
+            const int niters_blocked = solve(prob, poisson, true, sweeps, maxorder, tol_rel,
+                                             phi_blocked, time_blocked);
+
+            MultiFab::Subtract(phi_blocked, phi, 0, 0, 1, 0);
+            const Real diff = phi_blocked.norm0();
+
+            amrex::Print() << (poisson ? "MLPoisson" : "MLABecLaplacian")
+                           << ", maxorder " << maxorder << "\n"
+                           << "  gsrb         : " << niters << " iterations, "
+                           << time << " seconds\n"
+                           << "  gsrb_blocked : " << niters_blocked << " iterations, "
+                           << time_blocked << " seconds\n"
+                           << "  largest difference of the solutions : " << diff << "\n";
+
+            if (niters != niters_blocked || diff != 0.0) ++nerr;
+        }
+
+        if (nerr > 0) {
+            amrex::Abort("BlockedSmoother test failed");
+        }
+        amrex::Print() << "BlockedSmoother test passed\n";
+    }
+    amrex::Finalize();
+}
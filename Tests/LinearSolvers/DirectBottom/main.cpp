@@ -0,0 +1,225 @@
+//
+// Compares the direct bottom solver with the default bottom solver.
+//
+// A Dirichlet problem is solved without coarsening, so that the bottom
+// solver solves the whole problem.  The direct solver must then converge
+// in a single iteration, which also shows that it did not fall back to
+// bicgstab.  A periodic problem, whose bottom level is singular, is solved
+// with the default multigrid hierarchy and with one copy of the
+// factorization per node and in total.  All solves must reach the
+// tolerance, checked with a residual computed independently of the solver,
+// and give the same solution as the default bottom solver, up to a
+// constant for the periodic problem.
+//
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+namespace {
+
+struct Problem
+{
+    bool periodic;
+    Geometry geom;
+    BoxArray ba;
+    DistributionMapping dm;
+    MultiFab rhs;
+    MultiFab acoef;
+    Array<MultiFab,AMREX_SPACEDIM> bcoef;
+};
+
+// (a - div b grad) phi = rhs on the unit cube, b varying by a factor of 20.
+// With Dirichlet boundaries a is small, and in the periodic case it is zero.
+void init_problem (bool periodic, int n_cell, int max_grid_size, Problem& prob)
+{
+    prob.periodic = periodic;
+
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    const int p = periodic ? 1 : 0;
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(p,p,p)};
+    Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+    prob.geom.define(domain, rb, CoordSys::cartesian, is_periodic);
+
+    prob.ba.define(domain);
+    prob.ba.maxSize(max_grid_size);
+    prob.dm.define(prob.ba);
+
+    prob.rhs.define(prob.ba, prob.dm, 1, 0);
+    prob.acoef.define(prob.ba, prob.dm, 1, 0);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        prob.bcoef[idim].define(amrex::convert(prob.ba, IntVect::TheDimensionVector(idim)),
+                                prob.dm, 1, 0);
+    }
+
+    const auto dx = prob.geom.CellSizeArray();
+    const Real pi = 4.0*std::atan(1.0);
+    for (MFIter mfi(prob.rhs); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto rhs = prob.rhs.array(mfi);
+        const auto a = prob.acoef.array(mfi);
+        amrex::LoopOnCpu(bx, [&] (int i, int j, int k)
+        {
+            const Real x = (i+0.5)*dx[0];
+            const Real y = (j+0.5)*dx[1];
+            const Real z = (k+0.5)*dx[2];
+            if (periodic) {
+                rhs(i,j,k) = std::sin(2.*pi*x)*std::sin(4.*pi*y)*std::sin(2.*pi*z)
+                    + std::cos(2.*pi*x);
+                a(i,j,k) = 0.0;
+            } else {
+                rhs(i,j,k) = std::sin(pi*x)*std::sin(2.*pi*y)*std::sin(3.*pi*z) + (x-0.5)*y;
+                a(i,j,k) = 1.e-3;
+            }
+        });
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const Box& fbx = amrex::surroundingNodes(bx, idim);
+            const auto b = prob.bcoef[idim].array(mfi);
+            amrex::LoopOnCpu(fbx, [&] (int i, int j, int k)
+            {
+                const Real x = (i + (idim == 0 ? 0.0 : 0.5))*dx[0];
+                const Real y = (j + (idim == 1 ? 0.0 : 0.5))*dx[1];
+                const Real z = (k + (idim == 2 ? 0.0 : 0.5))*dx[2];
+                b(i,j,k) = 1.0 + 9.5*(1.0 + std::sin(4.*pi*x)*std::cos(3.*pi*y)*std::sin(5.*pi*z));
+            });
+        }
+    }
+}
+
+// Returns the number of iterations, and in resid the residual of phi
+// relative to the right-hand side.
+int solve (const Problem& prob, MLMG::BottomSolver bottom_solver, int max_coarsening_level,
+           int per_node, Real tol_rel, MultiFab& phi, Real& resid)
+{
+    LPInfo info;
+    if (max_coarsening_level >= 0) info.setMaxCoarseningLevel(max_coarsening_level);
+
+    const LinOpBCType bc = prob.periodic ? LinOpBCType::Periodic : LinOpBCType::Dirichlet;
+    MLABecLaplacian mlabec({prob.geom}, {prob.ba}, {prob.dm}, info);
+    mlabec.setDomainBC({AMREX_D_DECL(bc,bc,bc)}, {AMREX_D_DECL(bc,bc,bc)});
+    phi.setVal(0.0);
+    mlabec.setLevelBC(0, &phi);
+    mlabec.setScalars(1.0, 1.0);
+    mlabec.setACoeffs(0, prob.acoef);
+    mlabec.setBCoeffs(0, amrex::GetArrOfConstPtrs(prob.bcoef));
+
+    MLMG mlmg(mlabec);
+    mlmg.setVerbose(0);
+    mlmg.setCollectStats(1);
+    mlmg.setBottomSolver(bottom_solver);
+    mlmg.setBottomMaxIter(1000);
+    mlmg.setDirectBottomPerNode(per_node);
+    mlmg.solve({&phi}, {&prob.rhs}, tol_rel, 0.0);
+
+    MultiFab res(prob.ba, prob.dm, 1, 0);
+    mlmg.compResidual({&res}, {&phi}, {&prob.rhs});
+    resid = res.norm0() / prob.rhs.norm0();
+
+    return mlmg.getStats().numIters();
+}
+
+// The relative difference of two solutions, up to a constant if the
+// problem is periodic.
+Real solution_diff (const Problem& prob, MultiFab& phi, const MultiFab& phi_ref)
+{
+    MultiFab::Subtract(phi, phi_ref, 0, 0, 1, 0);
+    if (prob.periodic) {
+        const Real mean = phi.sum(0) / prob.geom.Domain().d_numPts();
+        phi.plus(-mean, 0, 1, 0);
+    }
+    return phi.norm0() / phi_ref.norm0();
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        ParmParse pp;
+        int n_cell_bottom = 16;
+        int n_cell = 32;
+        int max_grid_size = 8;
+        Real tol_rel = 1.e-10;
+        int max_iter_diff = 1;
+        pp.query("n_cell_bottom", n_cell_bottom);
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("tol_rel", tol_rel);
+        pp.query("max_iter_diff", max_iter_diff);
+
+        int nerr = 0;
+
+        {
+            Problem prob;
+            init_problem(false, n_cell_bottom, max_grid_size, prob);
+
+            MultiFab phi_ref(prob.ba, prob.dm, 1, 1);
+            MultiFab phi(prob.ba, prob.dm, 1, 1);
+            Real resid_ref, resid;
+            const int iters_ref = solve(prob, MLMG::BottomSolver::Default, 0, 1,
+                                        tol_rel, phi_ref, resid_ref);
+            const int iters = solve(prob, MLMG::BottomSolver::direct, 0, 1,
+                                    tol_rel, phi, resid);
+            const Real diff = solution_diff(prob, phi, phi_ref);
+
+            amrex::Print() << "Dirichlet problem without coarsening\n"
+                           << "  default bottom : " << iters_ref << " iterations, residual "
+                           << resid_ref << "\n"
+                           << "  direct bottom  : " << iters << " iterations, residual "
+                           << resid << "\n"
+                           << "  relative difference of the solutions : " << diff << "\n";
+
+            if (resid_ref > tol_rel || resid > tol_rel) ++nerr;
+            if (iters != 1) ++nerr;
+            if (diff > 100.*tol_rel) ++nerr;
+        }
+
+        {
+            Problem prob;
+            init_problem(true, n_cell, max_grid_size, prob);
+
+            MultiFab phi_ref(prob.ba, prob.dm, 1, 1);
+            Real resid_ref;
+            const int iters_ref = solve(prob, MLMG::BottomSolver::Default, -1, 1,
+                                        tol_rel, phi_ref, resid_ref);
+            amrex::Print() << "Periodic problem\n"
+                           << "  default bottom : " << iters_ref << " iterations, residual "
+                           << resid_ref << "\n";
+            if (resid_ref > tol_rel) ++nerr;
+
+            for (int per_node : {1, 0})
+            {
+                MultiFab phi(prob.ba, prob.dm, 1, 1);
+                Real resid;
+                const int iters = solve(prob, MLMG::BottomSolver::direct, -1, per_node,
+                                        tol_rel, phi, resid);
+                const Real diff = solution_diff(prob, phi, phi_ref);
+
+                amrex::Print() << "  direct bottom, " << (per_node ? "per node" : "single copy")
+                               << " : " << iters << " iterations, residual " << resid << "\n"
+                               << "  relative difference of the solutions : " << diff << "\n";
+
+                if (resid > tol_rel) ++nerr;
+                if (iters > iters_ref + max_iter_diff) ++nerr;
+                if (diff > 100.*tol_rel) ++nerr;
+            }
+        }
+
+        if (nerr > 0) {
+            amrex::Abort("DirectBottom test failed");
+        }
+        amrex::Print() << "DirectBottom test passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,250 @@
+//
+// Solves with a frozen operator whose coefficients are set again, first to
+// the same and then to new values, and checks that the operator and the
+// setup of the bottom solver are reused only while the coefficients are
+// unchanged.
+//
+// Without coarsening and with the direct bottom solver, every solve of one
+// MLMG object must take a single iteration, which fails if the
+// factorization of the old coefficients is reused after the change.  With
+// the default hierarchy, a new MLMG object on the frozen operator must
+// solve the changed problem like an operator built from scratch with the
+// new coefficients.  Residuals are always computed with such an operator.
+//
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+
+#include <cmath>
+#include <memory>
+
+using namespace amrex;
+
+namespace {
+
+struct Problem
+{
+    Geometry geom;
+    BoxArray ba;
+    DistributionMapping dm;
+    MultiFab rhs;
+    MultiFab acoef;
+    // The coefficients before and after the change.
+    Array<MultiFab,AMREX_SPACEDIM> bcoef;
+    Array<MultiFab,AMREX_SPACEDIM> bcoef_new;
+};
+
+// (a - div b grad) phi = rhs on the unit cube with phi = 0 on the
+// boundary, b varying by a factor of 20 and a small.  The new b varies
+// in another direction.
+void init_problem (int n_cell, int max_grid_size, Problem& prob)
+{
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+    Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+    prob.geom.define(domain, rb, CoordSys::cartesian, is_periodic);
+
+    prob.ba.define(domain);
+    prob.ba.maxSize(max_grid_size);
+    prob.dm.define(prob.ba);
+
+    prob.rhs.define(prob.ba, prob.dm, 1, 0);
+    prob.acoef.define(prob.ba, prob.dm, 1, 0);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const BoxArray& fba = amrex::convert(prob.ba, IntVect::TheDimensionVector(idim));
+        prob.bcoef[idim].define(fba, prob.dm, 1, 0);
+        prob.bcoef_new[idim].define(fba, prob.dm, 1, 0);
+    }
+
+    const auto dx = prob.geom.CellSizeArray();
+    const Real pi = 4.0*std::atan(1.0);
+    for (MFIter mfi(prob.rhs); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto rhs = prob.rhs.array(mfi);
+        const auto a = prob.acoef.array(mfi);
+        amrex::LoopOnCpu(bx, [&] (int i, int j, int k)
+        {
+            const Real x = (i+0.5)*dx[0];
+            const Real y = (j+0.5)*dx[1];
+            const Real z = (k+0.5)*dx[2];
+            rhs(i,j,k) = std::sin(pi*x)*std::sin(2.*pi*y)*std::sin(3.*pi*z) + (x-0.5)*y;
+            a(i,j,k) = 1.e-3;
+        });
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const Box& fbx = amrex::surroundingNodes(bx, idim);
+            const auto b = prob.bcoef[idim].array(mfi);
+            const auto bnew = prob.bcoef_new[idim].array(mfi);
+            amrex::LoopOnCpu(fbx, [&] (int i, int j, int k)
+            {
+                const Real x = (i + (idim == 0 ? 0.0 : 0.5))*dx[0];
+                const Real y = (j + (idim == 1 ? 0.0 : 0.5))*dx[1];
+                const Real z = (k + (idim == 2 ? 0.0 : 0.5))*dx[2];
+                b(i,j,k) = 1.0 + 9.5*(1.0 + std::sin(4.*pi*x)*std::cos(3.*pi*y)*std::sin(5.*pi*z));
+                bnew(i,j,k) = 1.0 + 9.5*(1.0 + std::cos(3.*pi*x)*std::sin(5.*pi*y)*std::sin(4.*pi*z));
+            });
+        }
+    }
+}
+
+std::unique_ptr<MLABecLaplacian>
+make_op (const Problem& prob, int max_coarsening_level, bool frozen,
+         const Array<MultiFab,AMREX_SPACEDIM>& bcoef)
+{
+    LPInfo info;
+    if (max_coarsening_level >= 0) info.setMaxCoarseningLevel(max_coarsening_level);
+
+    std::unique_ptr<MLABecLaplacian> op(new MLABecLaplacian({prob.geom}, {prob.ba}, {prob.dm}, info));
+    op->setFrozen(frozen);
+    op->setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                  LinOpBCType::Dirichlet,
+                                  LinOpBCType::Dirichlet)},
+                    {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                  LinOpBCType::Dirichlet,
+                                  LinOpBCType::Dirichlet)});
+    op->setLevelBC(0, nullptr);
+    op->setScalars(1.0, 1.0);
+    op->setACoeffs(0, prob.acoef);
+    op->setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+    return op;
+}
+
+// Sets the coefficients of op, bcoef for b and the old values for the others.
+void set_coeffs (MLABecLaplacian& op, const Problem& prob,
+                 const Array<MultiFab,AMREX_SPACEDIM>& bcoef)
+{
+    op.setScalars(1.0, 1.0);
+    op.setACoeffs(0, prob.acoef);
+    op.setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+}
+
+// Returns the number of iterations.
+int solve (MLMG& mlmg, const Problem& prob, Real tol_rel, MultiFab& phi)
+{
+    phi.setVal(0.0);
+    mlmg.solve({&phi}, {&prob.rhs}, tol_rel, 0.0);
+    return mlmg.getStats().numIters();
+}
+
+// The residual of phi relative to the right-hand side, computed with an
+// operator built from scratch.
+Real residual (const Problem& prob, const Array<MultiFab,AMREX_SPACEDIM>& bcoef, MultiFab& phi)
+{
+    auto op = make_op(prob, -1, false, bcoef);
+    MLMG mlmg(*op);
+    MultiFab res(prob.ba, prob.dm, 1, 0);
+    mlmg.compResidual({&res}, {&phi}, {&prob.rhs});
+    return res.norm0() / prob.rhs.norm0();
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        ParmParse pp;
+        int n_cell_bottom = 16;
+        int n_cell = 32;
+        int max_grid_size = 8;
+        Real tol_rel = 1.e-10;
+        pp.query("n_cell_bottom", n_cell_bottom);
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("tol_rel", tol_rel);
+
+        int nerr = 0;
+
+        {
+            Problem prob;
+            init_problem(n_cell_bottom, max_grid_size, prob);
+
+            auto op = make_op(prob, 0, true, prob.bcoef);
+            MLMG mlmg(*op);
+            mlmg.setVerbose(0);
+            mlmg.setCollectStats(1);
+            mlmg.setBottomSolver(MLMG::BottomSolver::direct);
+
+            MultiFab phi(prob.ba, prob.dm, 1, 1);
+            const int iters = solve(mlmg, prob, tol_rel, phi);
+            const Real resid = residual(prob, prob.bcoef, phi);
+
+            const long version = op->coeffsVersion();
+            set_coeffs(*op, prob, prob.bcoef);
+            const bool same_version = op->coeffsVersion() == version;
+            const int iters_same = solve(mlmg, prob, tol_rel, phi);
+            const Real resid_same = residual(prob, prob.bcoef, phi);
+
+            set_coeffs(*op, prob, prob.bcoef_new);
+            const bool new_version = op->coeffsVersion() != version;
+            const int iters_new = solve(mlmg, prob, tol_rel, phi);
+            const Real resid_new = residual(prob, prob.bcoef_new, phi);
+
+            amrex::Print() << "Direct bottom solver without coarsening\n"
+                           << "  first solve : " << iters << " iterations, residual "
+                           << resid << "\n"
+                           << "  same coefficients : " << iters_same << " iterations, residual "
+                           << resid_same << ", version " << (same_version ? "kept" : "changed")
+                           << "\n"
+                           << "  new coefficients : " << iters_new << " iterations, residual "
+                           << resid_new << ", version " << (new_version ? "changed" : "kept")
+                           << "\n";
+
+            if (resid > tol_rel || resid_same > tol_rel || resid_new > tol_rel) ++nerr;
+            if (iters != 1 || iters_same != 1 || iters_new != 1) ++nerr;
+            if (!same_version || !new_version) ++nerr;
+        }
+
+        {
+            Problem prob;
+            init_problem(n_cell, max_grid_size, prob);
+
+            auto op = make_op(prob, -1, true, prob.bcoef);
+            MultiFab phi(prob.ba, prob.dm, 1, 1);
+            {
+                MLMG mlmg(*op);
+                mlmg.setVerbose(0);
+                solve(mlmg, prob, tol_rel, phi);
+            }
+
+            set_coeffs(*op, prob, prob.bcoef_new);
+            MLMG mlmg(*op);
+            mlmg.setVerbose(0);
+            mlmg.setCollectStats(1);
+            const int iters = solve(mlmg, prob, tol_rel, phi);
+            const Real resid = residual(prob, prob.bcoef_new, phi);
+
+            auto op_ref = make_op(prob, -1, false, prob.bcoef_new);
+            MLMG mlmg_ref(*op_ref);
+            mlmg_ref.setVerbose(0);
+            mlmg_ref.setCollectStats(1);
+            MultiFab phi_ref(prob.ba, prob.dm, 1, 1);
+            const int iters_ref = solve(mlmg_ref, prob, tol_rel, phi_ref);
+
+            MultiFab::Subtract(phi, phi_ref, 0, 0, 1, 0);
+            const Real diff = phi.norm0() / phi_ref.norm0();
+
+            amrex::Print() << "Default hierarchy, new coefficients\n"
+                           << "  frozen operator : " << iters << " iterations, residual "
+                           << resid << "\n"
+                           << "  new operator : " << iters_ref << " iterations\n"
+                           << "  relative difference of the solutions : " << diff << "\n";
+
+            if (resid > tol_rel) ++nerr;
+            if (iters != iters_ref) ++nerr;
+            if (diff > 100.*tol_rel) ++nerr;
+        }
+
+        if (nerr > 0) {
+            amrex::Abort("FrozenOperator test failed");
+        }
+        amrex::Print() << "FrozenOperator test passed\n";
+    }
+    amrex::Finalize();
+}
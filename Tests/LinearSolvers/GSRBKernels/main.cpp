@@ -0,0 +1,237 @@
+//
+// Checks that the 3D Gauss-Seidel red-black kernels of MLPoisson and
+// MLABecLaplacian, which step over the cells of one color, give results
+// bit-for-bit identical to a loop over all the cells that tests the parity
+// of each.  The kernels are called on tiles whose lower corners have both
+// parities, with random masks on the faces of the valid box.
+//
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_IArrayBox.H>
+#include <AMReX_MLPoisson_K.H>
+#include <AMReX_MLABecLap_K.H>
+
+using namespace amrex;
+
+namespace {
+
+void fill_random (FArrayBox& fab, Real lo, Real hi)
+{
+    Real* p = fab.dataPtr();
+    const long n = fab.box().numPts() * fab.nComp();
+    for (long i = 0; i < n; ++i) {
+        p[i] = lo + (hi-lo)*amrex::Random();
+    }
+}
+
+void fill_random (IArrayBox& fab)
+{
+    int* p = fab.dataPtr();
+    const long n = fab.box().numPts() * fab.nComp();
+    for (long i = 0; i < n; ++i) {
+        p[i] = (amrex::Random() < 0.5) ? 0 : 1;
+    }
+}
+
+// The kernels as they were before they stepped over one color.
+void poisson_gsrb_ref (Box const& box, Array4<Real> const& phi, Array4<Real const> const& rhs,
+                       Real dhx, Real dhy, Real dhz,
+                       Array4<Real const> const* f, Array4<int const> const* m,
+                       Box const& vbox, int redblack)
+{
+    const auto lo = amrex::lbound(box);
+    const auto hi = amrex::ubound(box);
+    const auto vlo = amrex::lbound(vbox);
+    const auto vhi = amrex::ubound(vbox);
+
+    constexpr Real omega = 1.15;
+
+    const Real gamma = -2.*(dhx+dhy+dhz);
+
+    for         (int k = lo.z; k <= hi.z; ++k) {
+        for     (int j = lo.y; j <= hi.y; ++j) {
+            for (int i = lo.x; i <= hi.x; ++i) {
+                if ((i+j+k+redblack)%2 == 0) {
+                    Real cf0 = (i == vlo.x and m[0](vlo.x-1,j,k) > 0) ? f[0](vlo.x,j,k) : 0.0;
+                    Real cf1 = (j == vlo.y and m[1](i,vlo.y-1,k) > 0) ? f[1](i,vlo.y,k) : 0.0;
+                    Real cf2 = (k == vlo.z and m[2](i,j,vlo.z-1) > 0) ? f[2](i,j,vlo.z) : 0.0;
+                    Real cf3 = (i == vhi.x and m[3](vhi.x+1,j,k) > 0) ? f[3](vhi.x,j,k) : 0.0;
+                    Real cf4 = (j == vhi.y and m[4](i,vhi.y+1,k) > 0) ? f[4](i,vhi.y,k) : 0.0;
+                    Real cf5 = (k == vhi.z and m[5](i,j,vhi.z+1) > 0) ? f[5](i,j,vhi.z) : 0.0;
+
+                    Real g_m_d = gamma + dhx*(cf0+cf3) + dhy*(cf1+cf4) + dhz*(cf2+cf5);
+
+                    Real res = rhs(i,j,k) - gamma*phi(i,j,k)
+                        - dhx*(phi(i-1,j,k) + phi(i+1,j,k))
+                        - dhy*(phi(i,j-1,k) + phi(i,j+1,k))
+                        - dhz*(phi(i,j,k-1) + phi(i,j,k+1));
+
+                    phi(i,j,k) = phi(i,j,k) + omega/g_m_d * res;
+                }
+            }
+        }
+    }
+}
+
+void abec_gsrb_ref (Box const& box, Array4<Real> const& phi, Array4<Real const> const& rhs,
+                    Real alpha, Real dhx, Real dhy, Real dhz, Array4<Real const> const& a,
+                    Array4<Real const> const& bX, Array4<Real const> const& bY,
+                    Array4<Real const> const& bZ,
+                    Array4<Real const> const* f, Array4<int const> const* m,
+                    Box const& vbox, int redblack)
+{
+    const auto lo = amrex::lbound(box);
+    const auto hi = amrex::ubound(box);
+    const auto vlo = amrex::lbound(vbox);
+    const auto vhi = amrex::ubound(vbox);
+
+    constexpr Real omega = 1.15;
+
+    for         (int k = lo.z; k <= hi.z; ++k) {
+        for     (int j = lo.y; j <= hi.y; ++j) {
+            for (int i = lo.x; i <= hi.x; ++i) {
+                if ((i+j+k+redblack)%2 == 0) {
+                    Real cf0 = (i == vlo.x and m[0](vlo.x-1,j,k) > 0) ? f[0](vlo.x,j,k) : 0.0;
+                    Real cf1 = (j == vlo.y and m[1](i,vlo.y-1,k) > 0) ? f[1](i,vlo.y,k) : 0.0;
+                    Real cf2 = (k == vlo.z and m[2](i,j,vlo.z-1) > 0) ? f[2](i,j,vlo.z) : 0.0;
+                    Real cf3 = (i == vhi.x and m[3](vhi.x+1,j,k) > 0) ? f[3](vhi.x,j,k) : 0.0;
+                    Real cf4 = (j == vhi.y and m[4](i,vhi.y+1,k) > 0) ? f[4](i,vhi.y,k) : 0.0;
+                    Real cf5 = (k == vhi.z and m[5](i,j,vhi.z+1) > 0) ? f[5](i,j,vhi.z) : 0.0;
+
+                    Real gamma = alpha*a(i,j,k)
+                        +   dhx*(bX(i,j,k)+bX(i+1,j,k))
+                        +   dhy*(bY(i,j,k)+bY(i,j+1,k))
+                        +   dhz*(bZ(i,j,k)+bZ(i,j,k+1));
+
+                    Real g_m_d = gamma
+                        - (dhx*(bX(i,j,k)*cf0 + bX(i+1,j,k)*cf3)
+                        +  dhy*(bY(i,j,k)*cf1 + bY(i,j+1,k)*cf4)
+                        +  dhz*(bZ(i,j,k)*cf2 + bZ(i,j,k+1)*cf5));
+
+                    Real rho =  dhx*( bX(i  ,j,k)*phi(i-1,j,k)
+                              +       bX(i+1,j,k)*phi(i+1,j,k) )
+                              + dhy*( bY(i,j  ,k)*phi(i,j-1,k)
+                              +       bY(i,j+1,k)*phi(i,j+1,k) )
+                              + dhz*( bZ(i,j,k  )*phi(i,j,k-1)
+                              +       bZ(i,j,k+1)*phi(i,j,k+1) );
+
+                    Real res =  rhs(i,j,k) - (gamma*phi(i,j,k) - rho);
+                    phi(i,j,k) = phi(i,j,k) + omega/g_m_d * res;
+                }
+            }
+        }
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 32;
+        IntVect tile_size(AMREX_D_DECL(8,5,3));
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            Vector<int> ts;
+            if (pp.queryarr("tile_size", ts)) tile_size = IntVect(ts);
+        }
+
+        // an odd lower corner, so that the tiles start on both colors
+        const Box vbx(IntVect(1), IntVect(n_cell));
+        const Box gbx = amrex::grow(vbx,1);
+
+        FArrayBox rhs(vbx), acoef(vbx);
+        fill_random(rhs, -1.0, 1.0);
+        fill_random(acoef, 1.0, 2.0);
+        FArrayBox bx(amrex::surroundingNodes(vbx,0));
+        FArrayBox by(amrex::surroundingNodes(vbx,1));
+        FArrayBox bz(amrex::surroundingNodes(vbx,2));
+        fill_random(bx, 1.0, 2.0);
+        fill_random(by, 1.0, 2.0);
+        fill_random(bz, 1.0, 2.0);
+
+        // the boundary coefficients and masks of the six faces
+        Vector<FArrayBox> f(6);
+        Vector<IArrayBox> m(6);
+        for (int face = 0; face < 6; ++face) {
+            const int dir = face % 3;
+            const Box fbx = (face < 3) ? amrex::adjCellLo(vbx,dir) : amrex::adjCellHi(vbx,dir);
+            f[face].resize(amrex::grow(vbx,1), 1);
+            fill_random(f[face], -0.5, 0.5);
+            m[face].resize(amrex::grow(fbx,1), 1);
+            fill_random(m[face]);
+        }
+        const Array4<Real const> fa[6] = {f[0].const_array(), f[1].const_array(), f[2].const_array(),
+                                          f[3].const_array(), f[4].const_array(), f[5].const_array()};
+        const Array4<int const> ma[6] = {m[0].const_array(), m[1].const_array(), m[2].const_array(),
+                                         m[3].const_array(), m[4].const_array(), m[5].const_array()};
+
+        FArrayBox phi0(gbx);
+        fill_random(phi0, -1.0, 1.0);
+        FArrayBox phinew(gbx), phiref(gbx);
+
+        const Real dhx = 1.1, dhy = 0.9, dhz = 1.3, alpha = 0.7;
+        Vector<Box> tiles;
+        for (IntVect t = vbx.smallEnd(); t <= vbx.bigEnd(); vbx.next(t)) {
+            bool is_corner = true;
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                if ((t[d]-vbx.smallEnd(d)) % tile_size[d] != 0) is_corner = false;
+            }
+            if (is_corner) tiles.push_back(Box(t, t+tile_size-1) & vbx);
+        }
+        int nerr = 0;
+
+        // two full sweeps, tile by tile, for each kernel
+        for (int op = 0; op < 2; ++op) {
+            phinew.copy(phi0);
+            phiref.copy(phi0);
+            for (int sweep = 0; sweep < 2; ++sweep) {
+                for (int redblack = 0; redblack < 2; ++redblack) {
+                    for (const Box& tbx : tiles) {
+                        if (op == 0) {
+                            mlpoisson_gsrb(tbx, phinew.array(), rhs.const_array(), dhx, dhy, dhz,
+                                           fa[0], ma[0], fa[1], ma[1], fa[2], ma[2],
+                                           fa[3], ma[3], fa[4], ma[4], fa[5], ma[5],
+                                           vbx, redblack);
+                            poisson_gsrb_ref(tbx, phiref.array(), rhs.const_array(), dhx, dhy, dhz,
+                                             fa, ma, vbx, redblack);
+                        } else {
+                            abec_gsrb(tbx, phinew.array(), rhs.const_array(), alpha, dhx, dhy, dhz,
+                                      acoef.const_array(), bx.const_array(), by.const_array(),
+                                      bz.const_array(),
+                                      fa[0], ma[0], fa[1], ma[1], fa[2], ma[2],
+                                      fa[3], ma[3], fa[4], ma[4], fa[5], ma[5],
+                                      vbx, 1, redblack);
+                            abec_gsrb_ref(tbx, phiref.array(), rhs.const_array(), alpha, dhx, dhy, dhz,
+                                          acoef.const_array(), bx.const_array(), by.const_array(),
+                                          bz.const_array(), fa, ma, vbx, redblack);
+                        }
+                    }
+                }
+            }
+
+            long ndiff = 0;
+            const auto pn = phinew.const_array();
+            const auto pr = phiref.const_array();
+            amrex::LoopOnCpu(gbx, [&] (int i, int j, int k) noexcept
+            {
+                if (pn(i,j,k) != pr(i,j,k)) ++ndiff;
+            });
+            amrex::Print() << (op == 0 ? "mlpoisson_gsrb" : "abec_gsrb")
+                           << ": " << ndiff << " cells differ\n";
+            if (ndiff > 0) ++nerr;
+        }
+
+        if (nerr > 0) {
+            amrex::Abort("GSRBKernels test failed");
+        }
+        amrex::Print() << "GSRBKernels test passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,214 @@
+//
+// Checks the statistics collected by MLMG::setCollectStats against what
+// can be found out without them.  Collecting them must not change the
+// solution.  The recorded residuals must match the residuals of the
+// initial guess and of the solution computed with compResidual, and the
+// value returned by solve.  Their number must be the number of
+// iterations, which a solve with that fixed number of iterations must
+// reproduce.  The kernels of the V-cycles must have been counted on every
+// level, and ghost cells must have been sent to other ranks exactly when
+// there are several of them.
+//
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+namespace {
+
+struct Problem
+{
+    Geometry geom;
+    BoxArray ba;
+    DistributionMapping dm;
+    MultiFab rhs;
+    MultiFab acoef;
+    Array<MultiFab,AMREX_SPACEDIM> bcoef;
+};
+
+// (a - div b grad) phi = rhs on the unit cube with phi = 0 on the
+// boundary, b varying by a factor of 20 and a small.
+void init_problem (int n_cell, int max_grid_size, Problem& prob)
+{
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+    Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+    prob.geom.define(domain, rb, CoordSys::cartesian, is_periodic);
+
+    prob.ba.define(domain);
+    prob.ba.maxSize(max_grid_size);
+    prob.dm.define(prob.ba);
+
+    prob.rhs.define(prob.ba, prob.dm, 1, 0);
+    prob.acoef.define(prob.ba, prob.dm, 1, 0);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        prob.bcoef[idim].define(amrex::convert(prob.ba, IntVect::TheDimensionVector(idim)),
+                                prob.dm, 1, 0);
+    }
+
+    const auto dx = prob.geom.CellSizeArray();
+    const Real pi = 4.0*std::atan(1.0);
+    for (MFIter mfi(prob.rhs); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto rhs = prob.rhs.array(mfi);
+        const auto a = prob.acoef.array(mfi);
+        amrex::LoopOnCpu(bx, [&] (int i, int j, int k)
+        {
+            const Real x = (i+0.5)*dx[0];
+            const Real y = (j+0.5)*dx[1];
+            const Real z = (k+0.5)*dx[2];
+            rhs(i,j,k) = std::sin(pi*x)*std::sin(2.*pi*y)*std::sin(3.*pi*z) + (x-0.5)*y;
+            a(i,j,k) = 1.e-3;
+        });
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const Box& fbx = amrex::surroundingNodes(bx, idim);
+            const auto b = prob.bcoef[idim].array(mfi);
+            amrex::LoopOnCpu(fbx, [&] (int i, int j, int k)
+            {
+                const Real x = (i + (idim == 0 ? 0.0 : 0.5))*dx[0];
+                const Real y = (j + (idim == 1 ? 0.0 : 0.5))*dx[1];
+                const Real z = (k + (idim == 2 ? 0.0 : 0.5))*dx[2];
+                b(i,j,k) = 1.0 + 9.5*(1.0 + std::sin(4.*pi*x)*std::cos(3.*pi*y)*std::sin(5.*pi*z));
+            });
+        }
+    }
+}
+
+struct Solver
+{
+    MLABecLaplacian mlabec;
+    MLMG mlmg;
+
+    Solver (const Problem& prob)
+        : mlabec({prob.geom}, {prob.ba}, {prob.dm}),
+          mlmg((init(prob), mlabec))
+    {
+        mlmg.setVerbose(0);
+    }
+
+    MLABecLaplacian& init (const Problem& prob)
+    {
+        mlabec.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                         LinOpBCType::Dirichlet,
+                                         LinOpBCType::Dirichlet)},
+                           {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                         LinOpBCType::Dirichlet,
+                                         LinOpBCType::Dirichlet)});
+        mlabec.setLevelBC(0, nullptr);
+        mlabec.setScalars(1.0, 1.0);
+        mlabec.setACoeffs(0, prob.acoef);
+        mlabec.setBCoeffs(0, amrex::GetArrOfConstPtrs(prob.bcoef));
+        return mlabec;
+    }
+};
+
+Real residual_norm (MLMG& mlmg, const Problem& prob, MultiFab& phi)
+{
+    MultiFab res(prob.ba, prob.dm, 1, 0);
+    mlmg.compResidual({&res}, {&phi}, {&prob.rhs});
+    return res.norm0();
+}
+
+bool close (Real a, Real b)
+{
+    return std::abs(a-b) <= 1.e-8*std::max(std::abs(a),std::abs(b));
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        ParmParse pp;
+        int n_cell = 32;
+        int max_grid_size = 8;
+        Real tol_rel = 1.e-10;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("tol_rel", tol_rel);
+
+        Problem prob;
+        init_problem(n_cell, max_grid_size, prob);
+
+        int nerr = 0;
+
+        MultiFab phi_ref(prob.ba, prob.dm, 1, 1);
+        phi_ref.setVal(0.0);
+        {
+            Solver s(prob);
+            s.mlmg.solve({&phi_ref}, {&prob.rhs}, tol_rel, 0.0);
+        }
+
+        MultiFab phi(prob.ba, prob.dm, 1, 1);
+        phi.setVal(0.0);
+        Solver s(prob);
+        s.mlmg.setCollectStats(1);
+        const Real resid0 = residual_norm(s.mlmg, prob, phi);
+        const Real final_resid = s.mlmg.solve({&phi}, {&prob.rhs}, tol_rel, 0.0);
+        const Real resid = residual_norm(s.mlmg, prob, phi);
+        const MLMGStats& stats = s.mlmg.getStats();
+        const int niters = stats.numIters();
+
+        amrex::Print() << stats.toJSON() << "\n";
+
+        MultiFab::Subtract(phi, phi_ref, 0, 0, 1, 0);
+        const Real diff = phi.norm0();
+        amrex::Print() << "difference of the solutions with and without statistics : "
+                       << diff << "\n";
+        if (diff != 0.0) ++nerr;
+
+        amrex::Print() << "residuals : initial " << resid0 << ", final " << resid
+                       << ", returned by solve " << final_resid << "\n";
+        if (niters < 1 || stats.residual.size() != niters+1) ++nerr;
+        if (!close(stats.residual.front(), resid0)) ++nerr;
+        if (!close(stats.residual.back(), resid)) ++nerr;
+        if (stats.residual.back() != final_resid) ++nerr;
+        for (int i = 0; i < niters; ++i) {
+            if (!close(stats.convergence_factor[i]*stats.residual[i], stats.residual[i+1])) ++nerr;
+        }
+
+        {
+            MultiFab phi_fixed(prob.ba, prob.dm, 1, 1);
+            phi_fixed.setVal(0.0);
+            Solver sf(prob);
+            sf.mlmg.setFixedIter(niters);
+            const Real final_resid_fixed = sf.mlmg.solve({&phi_fixed}, {&prob.rhs}, tol_rel, 0.0);
+            amrex::Print() << "residual after " << niters << " fixed iterations : "
+                           << final_resid_fixed << "\n";
+            if (final_resid_fixed != final_resid) ++nerr;
+        }
+
+        // Each V-cycle smooths twice on every level above the bottom,
+        // restricts from and interpolates to it, and solves the bottom once.
+        const int nmglevs = stats.level[0].size();
+        for (int mglev = 0; mglev < nmglevs-1; ++mglev) {
+            if (stats.get(0, mglev, MLMGStats::smooth).calls != 2*niters) ++nerr;
+            if (stats.get(0, mglev, MLMGStats::smooth).bytes == 0) ++nerr;
+            if (stats.get(0, mglev, MLMGStats::restriction).calls != niters) ++nerr;
+            if (stats.get(0, mglev, MLMGStats::interpolation).calls != niters) ++nerr;
+        }
+        if (stats.get(0, nmglevs-1, MLMGStats::bottom).calls != niters) ++nerr;
+        if (stats.total(MLMGStats::apply).calls == 0) ++nerr;
+
+        const long comm_bytes = stats.total(MLMGStats::communication).bytes;
+        amrex::Print() << "bytes sent to other ranks : " << comm_bytes << "\n";
+        if ((comm_bytes > 0) != (ParallelDescriptor::NProcs() > 1)) ++nerr;
+
+        if (nerr > 0) {
+            amrex::Abort("MLMGStats test failed");
+        }
+        amrex::Print() << "MLMGStats test passed\n";
+    }
+    amrex::Finalize();
+}
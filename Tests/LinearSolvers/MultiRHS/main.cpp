@@ -0,0 +1,234 @@
+//
+// Solves a variable coefficient problem for several right-hand sides, once
+// together with a multi-component MLABecLaplacian and once one by one, with
+// the bicgstab and cg bottom solvers, whose batched variants are used for
+// the solves together.  This is done once without coarsening, so that the
+// bottom solver solves the whole problem, and once with the default
+// multigrid hierarchy.  Every right-hand side must be solved to the
+// tolerance, checked with a residual computed independently of the solver,
+// and the solutions of the two ways must agree.  Finally, a right-hand side
+// that is zero is solved together with a nonzero one; its solution must be
+// zero and must not spoil the solution of the other or cost iterations.
+//
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace amrex;
+
+namespace {
+
+struct Problem
+{
+    Geometry geom;
+    BoxArray ba;
+    DistributionMapping dm;
+    MultiFab rhs;
+    MultiFab acoef;
+    Array<MultiFab,AMREX_SPACEDIM> bcoef;
+};
+
+// (a - div b grad) phi = rhs on the unit cube with phi = 0 on the
+// boundary, b varying by a factor of 20 and a small.  The right-hand sides
+// have different modes, but are of the same size.
+void init_problem (int n_cell, int max_grid_size, int nrhs, Problem& prob)
+{
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+    Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+    prob.geom.define(domain, rb, CoordSys::cartesian, is_periodic);
+
+    prob.ba.define(domain);
+    prob.ba.maxSize(max_grid_size);
+    prob.dm.define(prob.ba);
+
+    prob.rhs.define(prob.ba, prob.dm, nrhs, 0);
+    prob.acoef.define(prob.ba, prob.dm, 1, 0);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        prob.bcoef[idim].define(amrex::convert(prob.ba, IntVect::TheDimensionVector(idim)),
+                                prob.dm, 1, 0);
+    }
+
+    const auto dx = prob.geom.CellSizeArray();
+    const Real pi = 4.0*std::atan(1.0);
+    for (MFIter mfi(prob.rhs); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto rhs = prob.rhs.array(mfi);
+        const auto a = prob.acoef.array(mfi);
+        amrex::LoopOnCpu(bx, nrhs, [&] (int i, int j, int k, int n)
+        {
+            const Real x = (i+0.5)*dx[0];
+            const Real y = (j+0.5)*dx[1];
+            const Real z = (k+0.5)*dx[2];
+            rhs(i,j,k,n) = std::sin((n+1)*pi*x)*std::sin(2.*pi*y)*std::sin((3-n%3)*pi*z)
+                + (x-0.5)*y*(n%2 == 0 ? 1.0 : -1.0);
+            if (n == 0) a(i,j,k) = 1.e-3;
+        });
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const Box& fbx = amrex::surroundingNodes(bx, idim);
+            const auto b = prob.bcoef[idim].array(mfi);
+            amrex::LoopOnCpu(fbx, [&] (int i, int j, int k)
+            {
+                const Real x = (i + (idim == 0 ? 0.0 : 0.5))*dx[0];
+                const Real y = (j + (idim == 1 ? 0.0 : 0.5))*dx[1];
+                const Real z = (k + (idim == 2 ? 0.0 : 0.5))*dx[2];
+                b(i,j,k) = 1.0 + 9.5*(1.0 + std::sin(4.*pi*x)*std::cos(3.*pi*y)*std::sin(5.*pi*z));
+            });
+        }
+    }
+}
+
+// Solves for the right-hand sides rhs, as many as phi has components, and
+// returns in resid the largest residual relative to its right-hand side, or
+// the residual itself for a right-hand side that is zero, and in niters the
+// number of MLMG iterations.
+void solve (const Problem& prob, MLMG::BottomSolver bottom_solver, int max_coarsening_level,
+            const MultiFab& rhs, Real tol_rel, MultiFab& phi, Real& resid, int& niters)
+{
+    LPInfo info;
+    if (max_coarsening_level >= 0) info.setMaxCoarseningLevel(max_coarsening_level);
+
+    const int ncomp = phi.nComp();
+    MLABecLaplacian mlabec({prob.geom}, {prob.ba}, {prob.dm}, info, {}, ncomp);
+    mlabec.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)},
+                       {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)});
+    phi.setVal(0.0);
+    mlabec.setLevelBC(0, &phi);
+    mlabec.setScalars(1.0, 1.0);
+    mlabec.setACoeffs(0, prob.acoef);
+    mlabec.setBCoeffs(0, amrex::GetArrOfConstPtrs(prob.bcoef));
+
+    MLMG mlmg(mlabec);
+    mlmg.setVerbose(0);
+    mlmg.setBottomSolver(bottom_solver);
+    mlmg.setBottomMaxIter(1000);
+    mlmg.setCollectStats(1);
+    mlmg.solve({&phi}, {&rhs}, tol_rel, 0.0);
+    niters = mlmg.getStats().numIters();
+
+    MultiFab res(prob.ba, prob.dm, ncomp, 0);
+    mlmg.compResidual({&res}, {&phi}, {&rhs});
+    resid = 0.0;
+    for (int n = 0; n < ncomp; ++n) {
+        const Real rhsnorm = rhs.norm0(n);
+        resid = std::max(resid, rhsnorm > 0.0 ? res.norm0(n) / rhsnorm : res.norm0(n));
+    }
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        ParmParse pp;
+        int n_cell = 32;
+        int max_grid_size = 8;
+        int nrhs = 3;
+        Real tol_rel = 1.e-10;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("nrhs", nrhs);
+        pp.query("tol_rel", tol_rel);
+
+        Problem prob;
+        init_problem(n_cell, max_grid_size, nrhs, prob);
+
+        const std::array<MLMG::BottomSolver,2> solvers
+            {MLMG::BottomSolver::bicgstab, MLMG::BottomSolver::cg};
+        const std::array<const char*,2> names {"bicgstab", "cg"};
+
+        int nerr = 0;
+        // Without coarsening and with the default number of levels.
+        for (int max_coarsening_level : {0, -1})
+        for (int is = 0; is < 2; ++is)
+        {
+            MultiFab phi(prob.ba, prob.dm, nrhs, 1);
+            Real resid;
+            int niters;
+            solve(prob, solvers[is], max_coarsening_level, prob.rhs, tol_rel, phi, resid, niters);
+
+            Real resid_single = 0.0;
+            Real diff = 0.0;
+            for (int n = 0; n < nrhs; ++n)
+            {
+                MultiFab rhs(prob.rhs, amrex::make_alias, n, 1);
+                MultiFab phi_single(prob.ba, prob.dm, 1, 1);
+                Real r;
+                int ni;
+                solve(prob, solvers[is], max_coarsening_level, rhs, tol_rel, phi_single, r, ni);
+                resid_single = std::max(resid_single, r);
+
+                MultiFab::Subtract(phi_single, phi, n, 0, 1, 0);
+                diff = std::max(diff, phi_single.norm0() / phi.norm0(n));
+            }
+
+            amrex::Print() << "max_coarsening_level " << max_coarsening_level << ", "
+                           << names[is] << " bottom solver\n"
+                           << "  " << nrhs << " right-hand sides together : residual "
+                           << resid << "\n"
+                           << "  one by one : residual " << resid_single << "\n"
+                           << "  relative difference of the solutions : " << diff << "\n";
+
+            if (resid > tol_rel || resid_single > tol_rel) ++nerr;
+            if (diff > 100.*tol_rel) ++nerr;
+        }
+
+        // A zero right-hand side next to a nonzero one.
+        for (int max_coarsening_level : {0, -1})
+        for (int is = 0; is < 2; ++is)
+        {
+            MultiFab rhs(prob.ba, prob.dm, 2, 0);
+            MultiFab::Copy(rhs, prob.rhs, 0, 0, 1, 0);
+            rhs.setVal(0.0, 1, 1);
+
+            MultiFab phi(prob.ba, prob.dm, 2, 1);
+            Real resid;
+            int niters;
+            solve(prob, solvers[is], max_coarsening_level, rhs, tol_rel, phi, resid, niters);
+
+            MultiFab rhs_single(prob.rhs, amrex::make_alias, 0, 1);
+            MultiFab phi_single(prob.ba, prob.dm, 1, 1);
+            Real r;
+            int niters_single;
+            solve(prob, solvers[is], max_coarsening_level, rhs_single, tol_rel, phi_single, r,
+                  niters_single);
+            MultiFab::Subtract(phi_single, phi, 0, 0, 1, 0);
+            const Real diff = phi_single.norm0() / phi.norm0(0);
+            const Real phizero = phi.norm0(1);
+
+            amrex::Print() << "max_coarsening_level " << max_coarsening_level << ", "
+                           << names[is] << " bottom solver\n"
+                           << "  with a zero right-hand side : residual " << resid
+                           << ", largest solution for the zero right-hand side " << phizero << "\n"
+                           << "  relative difference to the one by one solution : " << diff << "\n"
+                           << "  iterations " << niters << ", one by one " << niters_single << "\n";
+
+            // The zero right-hand side must not make the bottom solver fail,
+            // which would cost MLMG iterations.
+            if (resid > tol_rel || phizero != 0.0) ++nerr;
+            if (niters != niters_single) ++nerr;
+            if (diff > 100.*tol_rel) ++nerr;
+        }
+
+        if (nerr > 0) {
+            amrex::Abort("MultiRHS test failed");
+        }
+        amrex::Print() << "MultiRHS test passed\n";
+    }
+    amrex::Finalize();
+}
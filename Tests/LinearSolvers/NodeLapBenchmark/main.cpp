@@ -0,0 +1,319 @@
+//
+// Compares the C++ kernels of the 3D nodal Laplacian against the Fortran
+// routines they replace, on a single box with random coefficients.  The
+// restriction and interpolation of CoarseningStrategy::RAP are compared
+// too, although MLNodeLaplacian still calls the Fortran versions.
+//
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_IArrayBox.H>
+#include <AMReX_MLNodeLap_K.H>
+#include <AMReX_MLNodeLap_F.H>
+
+#include <functional>
+
+using namespace amrex;
+
+namespace {
+
+void fill_random (FArrayBox& fab, Real lo, Real hi)
+{
+    Real* p = fab.dataPtr();
+    const long n = fab.box().numPts() * fab.nComp();
+    for (long i = 0; i < n; ++i) {
+        p[i] = lo + (hi-lo)*amrex::Random();
+    }
+}
+
+Real max_diff (const FArrayBox& a, const FArrayBox& b, const Box& bx, int ncomp)
+{
+    FArrayBox d(bx, ncomp);
+    d.copy(a, bx, 0, bx, 0, ncomp);
+    d.minus(b, bx, 0, 0, ncomp);
+    return d.norm(bx, 0, 0, ncomp);
+}
+
+// Runs reset, new and ref nrep times, timing only new and ref, and compares
+// the first ncomp components of the results left in a and b on bx.
+void run (const std::string& name, int nrep, std::function<void()> const& reset,
+          std::function<void()> const& f_new, std::function<void()> const& f_ref,
+          const FArrayBox& a, const FArrayBox& b, const Box& bx, int ncomp = 1)
+{
+    double t_new = 0., t_ref = 0.;
+    for (int irep = 0; irep < nrep; ++irep) {
+        reset();
+        double t0 = amrex::second();
+        f_new();
+        double t1 = amrex::second();
+        f_ref();
+        double t2 = amrex::second();
+        t_new += t1-t0;
+        t_ref += t2-t1;
+    }
+    amrex::Print() << std::left << std::setw(28) << name
+                   << " new: " << std::setw(12) << t_new
+                   << " fortran: " << std::setw(12) << t_ref
+                   << " speedup: " << std::setw(8) << t_ref/t_new
+                   << " max diff: " << max_diff(a, b, bx, ncomp)
+                   << " (max " << b.norm(bx, 0, 0, ncomp) << ")\n";
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 64;
+        int nrep = 10;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("nrep", nrep);
+        }
+        AMREX_ALWAYS_ASSERT(n_cell % 2 == 0);
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        const Box nd = amrex::surroundingNodes(domain);
+        const Box cnd = amrex::coarsen(nd,2);
+
+        const Real dxinv_f[] = {Real(n_cell), Real(n_cell), Real(n_cell)};
+        const GpuArray<Real,AMREX_SPACEDIM> dxinv{Real(n_cell), Real(n_cell), Real(n_cell)};
+        const int bc[] = {0, 0, 0};
+
+        amrex::Print() << "n_cell = " << n_cell << ", nrep = " << nrep << "\n\n";
+
+        FArrayBox sx(amrex::grow(domain,2)), sy(amrex::grow(domain,2)), sz(amrex::grow(domain,2));
+        fill_random(sx, 1.0, 2.0);
+        fill_random(sy, 1.0, 2.0);
+        fill_random(sz, 1.0, 2.0);
+
+        // dirichlet on the domain boundary and outside
+        IArrayBox msk(amrex::grow(nd,1));
+        msk.setVal(nodelap_detail::dirichlet);
+        msk.setVal(0, amrex::grow(nd,-1));
+
+        const Box& nd1 = amrex::grow(nd,1);
+        FArrayBox sten(amrex::grow(nd,2), 9);
+        sten.setVal(0.0);
+        amrex_mlndlap_set_stencil(BL_TO_FORTRAN_BOX(nd1), BL_TO_FORTRAN_ANYD(sten),
+                                  BL_TO_FORTRAN_ANYD(sx), dxinv_f);
+        amrex_mlndlap_set_stencil_s0(BL_TO_FORTRAN_BOX(nd1), BL_TO_FORTRAN_ANYD(sten));
+
+        FArrayBox x(amrex::grow(nd,1)), rhs(amrex::grow(nd,1));
+        fill_random(x, -1.0, 1.0);
+        fill_random(rhs, -1.0, 1.0);
+
+        const FArrayBox& csx = sx;
+        const FArrayBox& csy = sy;
+        const FArrayBox& csz = sz;
+        const FArrayBox& csten = sten;
+        const FArrayBox& cx = x;
+        const FArrayBox& crhs = rhs;
+        const IArrayBox& cmsk = msk;
+
+        FArrayBox ynew(amrex::grow(nd,1)), yref(amrex::grow(nd,1));
+        auto nothing = [] () {};
+
+        run("adotx aa", nrep, nothing,
+            [&] () { mlndlap_adotx_aa(nd, ynew.array(), cx.array(), csx.array(), cmsk.array(), dxinv); },
+            [&] () { amrex_mlndlap_adotx_aa(BL_TO_FORTRAN_BOX(nd), BL_TO_FORTRAN_ANYD(yref),
+                                            BL_TO_FORTRAN_ANYD(x), BL_TO_FORTRAN_ANYD(sx),
+                                            BL_TO_FORTRAN_ANYD(msk), dxinv_f,
+                                            BL_TO_FORTRAN_BOX(nd), bc, bc); },
+            ynew, yref, nd);
+
+        run("adotx ha", nrep, nothing,
+            [&] () { mlndlap_adotx_ha(nd, ynew.array(), cx.array(), csx.array(), csy.array(),
+                                      csz.array(), cmsk.array(), dxinv); },
+            [&] () { amrex_mlndlap_adotx_ha(BL_TO_FORTRAN_BOX(nd), BL_TO_FORTRAN_ANYD(yref),
+                                            BL_TO_FORTRAN_ANYD(x), BL_TO_FORTRAN_ANYD(sx),
+                                            BL_TO_FORTRAN_ANYD(sy), BL_TO_FORTRAN_ANYD(sz),
+                                            BL_TO_FORTRAN_ANYD(msk), dxinv_f,
+                                            BL_TO_FORTRAN_BOX(nd), bc, bc); },
+            ynew, yref, nd);
+
+        run("adotx sten", nrep, nothing,
+            [&] () { mlndlap_adotx_sten(nd, ynew.array(), cx.array(), csten.array(), cmsk.array()); },
+            [&] () { amrex_mlndlap_adotx_sten(BL_TO_FORTRAN_BOX(nd), BL_TO_FORTRAN_ANYD(yref),
+                                              BL_TO_FORTRAN_ANYD(x), BL_TO_FORTRAN_ANYD(sten),
+                                              BL_TO_FORTRAN_ANYD(msk)); },
+            ynew, yref, nd);
+
+        FArrayBox Ax(amrex::grow(nd,1));
+        amrex_mlndlap_adotx_aa(BL_TO_FORTRAN_BOX(nd), BL_TO_FORTRAN_ANYD(Ax),
+                               BL_TO_FORTRAN_ANYD(x), BL_TO_FORTRAN_ANYD(sx),
+                               BL_TO_FORTRAN_ANYD(msk), dxinv_f, BL_TO_FORTRAN_BOX(nd), bc, bc);
+        const FArrayBox& cAx = Ax;
+        auto reset_sol = [&] () { ynew.copy(x); yref.copy(x); };
+
+        run("jacobi aa", nrep, reset_sol,
+            [&] () { mlndlap_jacobi_aa(nd, ynew.array(), cAx.array(), crhs.array(), csx.array(),
+                                       cmsk.array(), dxinv); },
+            [&] () { amrex_mlndlap_jacobi_aa(BL_TO_FORTRAN_BOX(nd), BL_TO_FORTRAN_ANYD(yref),
+                                             BL_TO_FORTRAN_ANYD(Ax), BL_TO_FORTRAN_ANYD(rhs),
+                                             BL_TO_FORTRAN_ANYD(sx), BL_TO_FORTRAN_ANYD(msk), dxinv_f,
+                                             BL_TO_FORTRAN_BOX(nd), bc, bc); },
+            ynew, yref, nd);
+
+        run("jacobi ha", nrep, reset_sol,
+            [&] () { mlndlap_jacobi_ha(nd, ynew.array(), cAx.array(), crhs.array(), csx.array(),
+                                       csy.array(), csz.array(), cmsk.array(), dxinv); },
+            [&] () { amrex_mlndlap_jacobi_ha(BL_TO_FORTRAN_BOX(nd), BL_TO_FORTRAN_ANYD(yref),
+                                             BL_TO_FORTRAN_ANYD(Ax), BL_TO_FORTRAN_ANYD(rhs),
+                                             BL_TO_FORTRAN_ANYD(sx), BL_TO_FORTRAN_ANYD(sy),
+                                             BL_TO_FORTRAN_ANYD(sz), BL_TO_FORTRAN_ANYD(msk), dxinv_f,
+                                             BL_TO_FORTRAN_BOX(nd), bc, bc); },
+            ynew, yref, nd);
+
+        run("jacobi sten", nrep, reset_sol,
+            [&] () { mlndlap_jacobi_sten(nd, ynew.array(), cAx.array(), crhs.array(), csten.array(),
+                                         cmsk.array()); },
+            [&] () { amrex_mlndlap_jacobi_sten(BL_TO_FORTRAN_BOX(nd), BL_TO_FORTRAN_ANYD(yref),
+                                               BL_TO_FORTRAN_ANYD(Ax), BL_TO_FORTRAN_ANYD(rhs),
+                                               BL_TO_FORTRAN_ANYD(sten), BL_TO_FORTRAN_ANYD(msk)); },
+            ynew, yref, nd);
+
+        run("gauss-seidel aa", nrep, reset_sol,
+            [&] () { mlndlap_gauss_seidel_aa(nd, ynew.array(), crhs.array(), csx.array(),
+                                             cmsk.array(), dxinv); },
+            [&] () { amrex_mlndlap_gauss_seidel_aa(BL_TO_FORTRAN_BOX(nd), BL_TO_FORTRAN_ANYD(yref),
+                                                   BL_TO_FORTRAN_ANYD(rhs), BL_TO_FORTRAN_ANYD(sx),
+                                                   BL_TO_FORTRAN_ANYD(msk), dxinv_f,
+                                                   BL_TO_FORTRAN_BOX(nd), bc, bc); },
+            ynew, yref, nd);
+
+        run("gauss-seidel ha", nrep, reset_sol,
+            [&] () { mlndlap_gauss_seidel_ha(nd, ynew.array(), crhs.array(), csx.array(),
+                                             csy.array(), csz.array(), cmsk.array(), dxinv); },
+            [&] () { amrex_mlndlap_gauss_seidel_ha(BL_TO_FORTRAN_BOX(nd), BL_TO_FORTRAN_ANYD(yref),
+                                                   BL_TO_FORTRAN_ANYD(rhs), BL_TO_FORTRAN_ANYD(sx),
+                                                   BL_TO_FORTRAN_ANYD(sy), BL_TO_FORTRAN_ANYD(sz),
+                                                   BL_TO_FORTRAN_ANYD(msk), dxinv_f,
+                                                   BL_TO_FORTRAN_BOX(nd), bc, bc); },
+            ynew, yref, nd);
+
+        run("gauss-seidel sten", nrep, reset_sol,
+            [&] () { mlndlap_gauss_seidel_sten(nd, ynew.array(), crhs.array(), csten.array(),
+                                               cmsk.array()); },
+            [&] () { amrex_mlndlap_gauss_seidel_sten(BL_TO_FORTRAN_BOX(nd), BL_TO_FORTRAN_ANYD(yref),
+                                                     BL_TO_FORTRAN_ANYD(rhs), BL_TO_FORTRAN_ANYD(sten),
+                                                     BL_TO_FORTRAN_ANYD(msk)); },
+            ynew, yref, nd);
+
+        run("normalize aa", nrep, reset_sol,
+            [&] () { mlndlap_normalize_aa(nd, ynew.array(), csx.array(), cmsk.array(), dxinv); },
+            [&] () { amrex_mlndlap_normalize_aa(BL_TO_FORTRAN_BOX(nd), BL_TO_FORTRAN_ANYD(yref),
+                                                BL_TO_FORTRAN_ANYD(sx), BL_TO_FORTRAN_ANYD(msk),
+                                                dxinv_f); },
+            ynew, yref, nd);
+
+        run("normalize ha", nrep, reset_sol,
+            [&] () { mlndlap_normalize_ha(nd, ynew.array(), csx.array(), csy.array(), csz.array(),
+                                          cmsk.array(), dxinv); },
+            [&] () { amrex_mlndlap_normalize_ha(BL_TO_FORTRAN_BOX(nd), BL_TO_FORTRAN_ANYD(yref),
+                                                BL_TO_FORTRAN_ANYD(sx), BL_TO_FORTRAN_ANYD(sy),
+                                                BL_TO_FORTRAN_ANYD(sz), BL_TO_FORTRAN_ANYD(msk),
+                                                dxinv_f); },
+            ynew, yref, nd);
+
+        const Real s0_norm0 = 1.e-3 * sten.norm(nd, 0, nodelap_detail::ist_000, 1);
+        run("normalize sten", nrep, reset_sol,
+            [&] () { mlndlap_normalize_sten(nd, ynew.array(), csten.array(), cmsk.array(), s0_norm0); },
+            [&] () { amrex_mlndlap_normalize_sten(BL_TO_FORTRAN_BOX(nd), BL_TO_FORTRAN_ANYD(yref),
+                                                  BL_TO_FORTRAN_ANYD(sten), BL_TO_FORTRAN_ANYD(msk),
+                                                  s0_norm0); },
+            ynew, yref, nd);
+
+        FArrayBox cnew(amrex::grow(cnd,1)), cref(amrex::grow(cnd,1));
+        const Box& cbx = amrex::grow(cnd,-1);
+
+        run("restriction", nrep, nothing,
+            [&] () { mlndlap_restriction(cbx, cnew.array(), cx.array(), cmsk.array()); },
+            [&] () { amrex_mlndlap_restriction(BL_TO_FORTRAN_BOX(cbx), BL_TO_FORTRAN_ANYD(cref),
+                                               BL_TO_FORTRAN_ANYD(x), BL_TO_FORTRAN_ANYD(msk)); },
+            cnew, cref, cbx);
+
+        run("restriction rap", nrep, nothing,
+            [&] () { mlndlap_restriction_rap(cbx, cnew.array(), cx.array(), csten.array(), cmsk.array()); },
+            [&] () { amrex_mlndlap_restriction_rap(BL_TO_FORTRAN_BOX(cbx), BL_TO_FORTRAN_ANYD(cref),
+                                                   BL_TO_FORTRAN_ANYD(x), BL_TO_FORTRAN_ANYD(sten),
+                                                   BL_TO_FORTRAN_ANYD(msk)); },
+            cnew, cref, cbx);
+
+        FArrayBox crse(amrex::grow(cnd,1));
+        fill_random(crse, -1.0, 1.0);
+        const FArrayBox& ccrse = crse;
+        auto reset_fine = [&] () { ynew.setVal(0.0); yref.setVal(0.0); };
+
+        run("interpolation aa", nrep, reset_fine,
+            [&] () { mlndlap_interpolation_aa(cnd, ynew.array(), ccrse.array(), csx.array(), cmsk.array()); },
+            [&] () { amrex_mlndlap_interpolation_aa(BL_TO_FORTRAN_BOX(cnd), BL_TO_FORTRAN_ANYD(yref),
+                                                    BL_TO_FORTRAN_ANYD(crse), BL_TO_FORTRAN_ANYD(sx),
+                                                    BL_TO_FORTRAN_ANYD(msk),
+                                                    BL_TO_FORTRAN_BOX(nd), bc, bc); },
+            ynew, yref, nd);
+
+        run("interpolation ha", nrep, reset_fine,
+            [&] () { mlndlap_interpolation_ha(cnd, ynew.array(), ccrse.array(), csx.array(),
+                                              csy.array(), csz.array(), cmsk.array()); },
+            [&] () { amrex_mlndlap_interpolation_ha(BL_TO_FORTRAN_BOX(cnd), BL_TO_FORTRAN_ANYD(yref),
+                                                    BL_TO_FORTRAN_ANYD(crse), BL_TO_FORTRAN_ANYD(sx),
+                                                    BL_TO_FORTRAN_ANYD(sy), BL_TO_FORTRAN_ANYD(sz),
+                                                    BL_TO_FORTRAN_ANYD(msk),
+                                                    BL_TO_FORTRAN_BOX(nd), bc, bc); },
+            ynew, yref, nd);
+
+        run("interpolation rap", nrep, reset_fine,
+            [&] () { mlndlap_interpadd_rap(nd, ynew.array(), ccrse.array(), csten.array(), cmsk.array()); },
+            [&] () { amrex_mlndlap_interpolation_rap(BL_TO_FORTRAN_BOX(cnd), BL_TO_FORTRAN_ANYD(yref),
+                                                     BL_TO_FORTRAN_ANYD(crse), BL_TO_FORTRAN_ANYD(sten),
+                                                     BL_TO_FORTRAN_ANYD(msk)); },
+            ynew, yref, nd);
+
+        FArrayBox stnew(amrex::grow(nd,2), 9), stref(amrex::grow(nd,2), 9);
+        auto reset_sten = [&] () { stnew.setVal(0.0); stref.setVal(0.0); };
+
+        run("set stencil", nrep, reset_sten,
+            [&] () { mlndlap_set_stencil(nd1, stnew.array(), csx.array(), dxinv); },
+            [&] () { amrex_mlndlap_set_stencil(BL_TO_FORTRAN_BOX(nd1), BL_TO_FORTRAN_ANYD(stref),
+                                               BL_TO_FORTRAN_ANYD(sx), dxinv_f); },
+            stnew, stref, nd1, 9);
+
+        auto copy_sten = [&] () { stnew.copy(sten); stref.copy(sten); };
+        run("set stencil s0", nrep, copy_sten,
+            [&] () { mlndlap_set_stencil_s0(nd, stnew.array()); },
+            [&] () { amrex_mlndlap_set_stencil_s0(BL_TO_FORTRAN_BOX(nd), BL_TO_FORTRAN_ANYD(stref)); },
+            stnew, stref, nd, 9);
+
+        // The coarse stencil needs the fine stencil two coarse nodes around it.
+        FArrayBox cstnew(amrex::grow(cnd,1), 9), cstref(amrex::grow(cnd,1), 9);
+        const Box& cbx2 = amrex::grow(cnd,-2);
+        Box wbx = cbx2;
+        wbx.growHi(0,1).growHi(1,1).growHi(2,1);
+        FArrayBox wfab(wbx, 27);
+        auto reset_csten = [&] () { cstnew.setVal(0.0); cstref.setVal(0.0); };
+
+        run("stencil rap", nrep, reset_csten,
+            [&] () { mlndlap_rap_weights(wbx, wfab.array(), csten.array());
+                     mlndlap_stencil_rap(cbx2, cstnew.array(), csten.array(), wfab.const_array()); },
+            [&] () { amrex_mlndlap_stencil_rap(BL_TO_FORTRAN_BOX(cbx2), BL_TO_FORTRAN_ANYD(cstref),
+                                               BL_TO_FORTRAN_ANYD(sten)); },
+            cstnew, cstref, cbx2, 9);
+
+        FArrayBox vel(amrex::grow(domain,1), AMREX_SPACEDIM);
+        fill_random(vel, -1.0, 1.0);
+        const FArrayBox& cvel = vel;
+
+        run("divu", nrep, nothing,
+            [&] () { mlndlap_divu(nd, ynew.array(), cvel.array(), cmsk.array(), dxinv); },
+            [&] () { amrex_mlndlap_divu(BL_TO_FORTRAN_BOX(nd), BL_TO_FORTRAN_ANYD(yref),
+                                        BL_TO_FORTRAN_ANYD(vel), BL_TO_FORTRAN_ANYD(msk), dxinv_f); },
+            ynew, yref, nd);
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,183 @@
+//
+// Solves a variable coefficient problem with the bicgstab and cg bottom
+// solvers and with their pipelined variants.  This is done once without
+// coarsening, so that the bottom solver solves the whole problem, and once
+// with the default multigrid hierarchy.  All solves must reach the
+// tolerance, checked with a residual computed independently of the solver,
+// and each pipelined variant must take about the same number of iterations
+// and give the same solution as the solver it is derived from.  Run on
+// several ranks, so that the non-blocking reductions span processes.
+//
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+namespace {
+
+struct Problem
+{
+    Geometry geom;
+    BoxArray ba;
+    DistributionMapping dm;
+    MultiFab rhs;
+    MultiFab acoef;
+    Array<MultiFab,AMREX_SPACEDIM> bcoef;
+};
+
+// (a - div b grad) phi = rhs on the unit cube with phi = 0 on the
+// boundary, b varying by a factor of 20 and a small.  The operator is
+// symmetric, so that cg can be used.
+void init_problem (int n_cell, int max_grid_size, Problem& prob)
+{
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+    Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+    prob.geom.define(domain, rb, CoordSys::cartesian, is_periodic);
+
+    prob.ba.define(domain);
+    prob.ba.maxSize(max_grid_size);
+    prob.dm.define(prob.ba);
+
+    prob.rhs.define(prob.ba, prob.dm, 1, 0);
+    prob.acoef.define(prob.ba, prob.dm, 1, 0);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        prob.bcoef[idim].define(amrex::convert(prob.ba, IntVect::TheDimensionVector(idim)),
+                                prob.dm, 1, 0);
+    }
+
+    const auto dx = prob.geom.CellSizeArray();
+    const Real pi = 4.0*std::atan(1.0);
+    for (MFIter mfi(prob.rhs); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto rhs = prob.rhs.array(mfi);
+        const auto a = prob.acoef.array(mfi);
+        amrex::LoopOnCpu(bx, [&] (int i, int j, int k)
+        {
+            const Real x = (i+0.5)*dx[0];
+            const Real y = (j+0.5)*dx[1];
+            const Real z = (k+0.5)*dx[2];
+            rhs(i,j,k) = std::sin(pi*x)*std::sin(2.*pi*y)*std::sin(3.*pi*z) + (x-0.5)*y;
+            a(i,j,k) = 1.e-3;
+        });
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const Box& fbx = amrex::surroundingNodes(bx, idim);
+            const auto b = prob.bcoef[idim].array(mfi);
+            amrex::LoopOnCpu(fbx, [&] (int i, int j, int k)
+            {
+                const Real x = (i + (idim == 0 ? 0.0 : 0.5))*dx[0];
+                const Real y = (j + (idim == 1 ? 0.0 : 0.5))*dx[1];
+                const Real z = (k + (idim == 2 ? 0.0 : 0.5))*dx[2];
+                b(i,j,k) = 1.0 + 9.5*(1.0 + std::sin(4.*pi*x)*std::cos(3.*pi*y)*std::sin(5.*pi*z));
+            });
+        }
+    }
+}
+
+// Returns the number of iterations, and in resid the residual of phi
+// relative to the right-hand side.
+int solve (const Problem& prob, MLMG::BottomSolver bottom_solver, int max_coarsening_level,
+           Real tol_rel, MultiFab& phi, Real& resid)
+{
+    LPInfo info;
+    if (max_coarsening_level >= 0) info.setMaxCoarseningLevel(max_coarsening_level);
+
+    MLABecLaplacian mlabec({prob.geom}, {prob.ba}, {prob.dm}, info);
+    mlabec.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)},
+                       {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)});
+    phi.setVal(0.0);
+    mlabec.setLevelBC(0, &phi);
+    mlabec.setScalars(1.0, 1.0);
+    mlabec.setACoeffs(0, prob.acoef);
+    mlabec.setBCoeffs(0, amrex::GetArrOfConstPtrs(prob.bcoef));
+
+    MLMG mlmg(mlabec);
+    mlmg.setVerbose(0);
+    mlmg.setCollectStats(1);
+    mlmg.setBottomSolver(bottom_solver);
+    mlmg.setBottomMaxIter(1000);
+    mlmg.solve({&phi}, {&prob.rhs}, tol_rel, 0.0);
+
+    MultiFab res(prob.ba, prob.dm, 1, 0);
+    mlmg.compResidual({&res}, {&phi}, {&prob.rhs});
+    resid = res.norm0() / prob.rhs.norm0();
+
+    return mlmg.getStats().numIters();
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        ParmParse pp;
+        int n_cell = 32;
+        int max_grid_size = 8;
+        Real tol_rel = 1.e-10;
+        int max_iter_diff = 1;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("tol_rel", tol_rel);
+        pp.query("max_iter_diff", max_iter_diff);
+
+        Problem prob;
+        init_problem(n_cell, max_grid_size, prob);
+
+        const std::array<MLMG::BottomSolver,2> solvers
+            {MLMG::BottomSolver::bicgstab, MLMG::BottomSolver::cg};
+        const std::array<MLMG::BottomSolver,2> pipelined
+            {MLMG::BottomSolver::pipelined_bicgstab, MLMG::BottomSolver::pipelined_cg};
+        const std::array<const char*,2> names {"bicgstab", "cg"};
+
+        int nerr = 0;
+        // Without coarsening and with the default number of levels.
+        for (int max_coarsening_level : {0, -1})
+        {
+            for (int is = 0; is < 2; ++is)
+            {
+                MultiFab phi(prob.ba, prob.dm, 1, 1);
+                MultiFab phi_pipe(prob.ba, prob.dm, 1, 1);
+                Real resid, resid_pipe;
+                const int iters = solve(prob, solvers[is], max_coarsening_level,
+                                        tol_rel, phi, resid);
+                const int iters_pipe = solve(prob, pipelined[is], max_coarsening_level,
+                                             tol_rel, phi_pipe, resid_pipe);
+
+                MultiFab::Subtract(phi_pipe, phi, 0, 0, 1, 0);
+                const Real diff = phi_pipe.norm0() / phi.norm0();
+
+                amrex::Print() << "max_coarsening_level " << max_coarsening_level << "\n"
+                               << "  " << names[is] << " : "
+                               << iters << " iterations, residual " << resid << "\n"
+                               << "  pipelined " << names[is] << " : "
+                               << iters_pipe << " iterations, residual " << resid_pipe << "\n"
+                               << "  relative difference of the solutions : " << diff << "\n";
+
+                if (resid > tol_rel || resid_pipe > tol_rel) ++nerr;
+                if (std::abs(iters_pipe - iters) > max_iter_diff) ++nerr;
+                if (diff > 100.*tol_rel) ++nerr;
+            }
+        }
+
+        if (nerr > 0) {
+            amrex::Abort("PipelinedBottom test failed");
+        }
+        amrex::Print() << "PipelinedBottom test passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,183 @@
+//
+// Solves a variable coefficient problem with Dirichlet and with Neumann
+// boundaries, with the default red-black Gauss-Seidel smoother and with
+// the L1-Jacobi and Chebyshev smoothers for two numbers of sweeps.  All
+// solves must reach the tolerance, checked with a residual computed
+// independently of the solver, with an average convergence factor below
+// max_convergence_factor, and give the same solution as with the default
+// smoother.
+//
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+namespace {
+
+struct Problem
+{
+    Geometry geom;
+    BoxArray ba;
+    DistributionMapping dm;
+    MultiFab rhs;
+    MultiFab acoef;
+    Array<MultiFab,AMREX_SPACEDIM> bcoef;
+};
+
+// (a - div b grad) phi = rhs on the unit cube, b varying by a factor of 20
+// and a small.
+void init_problem (int n_cell, int max_grid_size, Problem& prob)
+{
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+    Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+    prob.geom.define(domain, rb, CoordSys::cartesian, is_periodic);
+
+    prob.ba.define(domain);
+    prob.ba.maxSize(max_grid_size);
+    prob.dm.define(prob.ba);
+
+    prob.rhs.define(prob.ba, prob.dm, 1, 0);
+    prob.acoef.define(prob.ba, prob.dm, 1, 0);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        prob.bcoef[idim].define(amrex::convert(prob.ba, IntVect::TheDimensionVector(idim)),
+                                prob.dm, 1, 0);
+    }
+
+    const auto dx = prob.geom.CellSizeArray();
+    const Real pi = 4.0*std::atan(1.0);
+    for (MFIter mfi(prob.rhs); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto rhs = prob.rhs.array(mfi);
+        const auto a = prob.acoef.array(mfi);
+        amrex::LoopOnCpu(bx, [&] (int i, int j, int k)
+        {
+            const Real x = (i+0.5)*dx[0];
+            const Real y = (j+0.5)*dx[1];
+            const Real z = (k+0.5)*dx[2];
+            rhs(i,j,k) = std::sin(pi*x)*std::sin(2.*pi*y)*std::sin(3.*pi*z) + (x-0.5)*y;
+            a(i,j,k) = 1.e-3;
+        });
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const Box& fbx = amrex::surroundingNodes(bx, idim);
+            const auto b = prob.bcoef[idim].array(mfi);
+            amrex::LoopOnCpu(fbx, [&] (int i, int j, int k)
+            {
+                const Real x = (i + (idim == 0 ? 0.0 : 0.5))*dx[0];
+                const Real y = (j + (idim == 1 ? 0.0 : 0.5))*dx[1];
+                const Real z = (k + (idim == 2 ? 0.0 : 0.5))*dx[2];
+                b(i,j,k) = 1.0 + 9.5*(1.0 + std::sin(4.*pi*x)*std::cos(3.*pi*y)*std::sin(5.*pi*z));
+            });
+        }
+    }
+}
+
+// Returns the average convergence factor, and in resid the residual of phi
+// relative to the right-hand side.
+Real solve (const Problem& prob, LinOpBCType bc, MLSmoother smoother, int sweeps,
+            Real tol_rel, MultiFab& phi, int& iters, Real& resid)
+{
+    LPInfo info;
+    info.setSmoother(smoother);
+    info.setSmootherSweeps(sweeps);
+
+    MLABecLaplacian mlabec({prob.geom}, {prob.ba}, {prob.dm}, info);
+    mlabec.setDomainBC({AMREX_D_DECL(bc,bc,bc)}, {AMREX_D_DECL(bc,bc,bc)});
+    phi.setVal(0.0);
+    mlabec.setLevelBC(0, &phi);
+    mlabec.setScalars(1.0, 1.0);
+    mlabec.setACoeffs(0, prob.acoef);
+    mlabec.setBCoeffs(0, amrex::GetArrOfConstPtrs(prob.bcoef));
+
+    MLMG mlmg(mlabec);
+    mlmg.setVerbose(0);
+    mlmg.setCollectStats(1);
+    mlmg.solve({&phi}, {&prob.rhs}, tol_rel, 0.0);
+
+    MultiFab res(prob.ba, prob.dm, 1, 0);
+    mlmg.compResidual({&res}, {&phi}, {&prob.rhs});
+    resid = res.norm0() / prob.rhs.norm0();
+
+    iters = mlmg.getStats().numIters();
+    return mlmg.getStats().averageConvergenceFactor();
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        ParmParse pp;
+        int n_cell = 32;
+        int max_grid_size = 8;
+        Real tol_rel = 1.e-10;
+        Real max_convergence_factor = 0.6;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("tol_rel", tol_rel);
+        pp.query("max_convergence_factor", max_convergence_factor);
+
+        Problem prob;
+        init_problem(n_cell, max_grid_size, prob);
+
+        const std::array<MLSmoother,2> smoothers {MLSmoother::l1_jacobi, MLSmoother::chebyshev};
+        const std::array<const char*,2> names {"l1_jacobi", "chebyshev"};
+
+        int nerr = 0;
+        for (LinOpBCType bc : {LinOpBCType::Dirichlet, LinOpBCType::Neumann})
+        {
+            amrex::Print() << (bc == LinOpBCType::Dirichlet ? "Dirichlet" : "Neumann")
+                           << " boundaries\n";
+
+            MultiFab phi_ref(prob.ba, prob.dm, 1, 1);
+            int iters_ref;
+            Real resid_ref;
+            const Real factor_ref = solve(prob, bc, MLSmoother::gsrb, 4, tol_rel,
+                                          phi_ref, iters_ref, resid_ref);
+            amrex::Print() << "  gsrb : " << iters_ref << " iterations, convergence factor "
+                           << factor_ref << ", residual " << resid_ref << "\n";
+            if (resid_ref > tol_rel) ++nerr;
+
+            for (int is = 0; is < 2; ++is)
+            {
+                for (int sweeps : {2, 4})
+                {
+                    MultiFab phi(prob.ba, prob.dm, 1, 1);
+                    int iters;
+                    Real resid;
+                    const Real factor = solve(prob, bc, smoothers[is], sweeps, tol_rel,
+                                              phi, iters, resid);
+
+                    MultiFab::Subtract(phi, phi_ref, 0, 0, 1, 0);
+                    const Real diff = phi.norm0() / phi_ref.norm0();
+
+                    amrex::Print() << "  " << names[is] << " with " << sweeps << " sweeps : "
+                                   << iters << " iterations, convergence factor " << factor
+                                   << ", residual " << resid << "\n"
+                                   << "    relative difference from gsrb : " << diff << "\n";
+
+                    if (resid > tol_rel) ++nerr;
+                    if (factor > max_convergence_factor) ++nerr;
+                    if (diff > 100.*tol_rel) ++nerr;
+                }
+            }
+        }
+
+        if (nerr > 0) {
+            amrex::Abort("PolynomialSmoothers test failed");
+        }
+        amrex::Print() << "PolynomialSmoothers test passed\n";
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,158 @@
+//
+// Solves a variable coefficient problem with and without
+// MLMG::setSinglePrecisionHalo.  Both solves must reach the tolerance,
+// checked with a residual computed independently of the solver, in about
+// the same number of iterations.  Run on several ranks, so that the ghost
+// cells of the corrections are really exchanged in single precision.
+//
+
+#include <AMReX.H>
+#include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+
+#include <cmath>
+
+using namespace amrex;
+
+namespace {
+
+struct Problem
+{
+    Geometry geom;
+    BoxArray ba;
+    DistributionMapping dm;
+    MultiFab rhs;
+    MultiFab acoef;
+    Array<MultiFab,AMREX_SPACEDIM> bcoef;
+};
+
+// (a - div b grad) phi = rhs on the unit cube with phi = 0 on the
+// boundary, b varying by a factor of 20 and a small.
+void init_problem (int n_cell, int max_grid_size, Problem& prob)
+{
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    Array<int,AMREX_SPACEDIM> is_periodic{AMREX_D_DECL(0,0,0)};
+    Box domain(IntVect(AMREX_D_DECL(0,0,0)), IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1)));
+    prob.geom.define(domain, rb, CoordSys::cartesian, is_periodic);
+
+    prob.ba.define(domain);
+    prob.ba.maxSize(max_grid_size);
+    prob.dm.define(prob.ba);
+
+    prob.rhs.define(prob.ba, prob.dm, 1, 0);
+    prob.acoef.define(prob.ba, prob.dm, 1, 0);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        prob.bcoef[idim].define(amrex::convert(prob.ba, IntVect::TheDimensionVector(idim)),
+                                prob.dm, 1, 0);
+    }
+
+    const auto dx = prob.geom.CellSizeArray();
+    const Real pi = 4.0*std::atan(1.0);
+    for (MFIter mfi(prob.rhs); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.validbox();
+        const auto rhs = prob.rhs.array(mfi);
+        const auto a = prob.acoef.array(mfi);
+        amrex::LoopOnCpu(bx, [&] (int i, int j, int k)
+        {
+            const Real x = (i+0.5)*dx[0];
+            const Real y = (j+0.5)*dx[1];
+            const Real z = (k+0.5)*dx[2];
+            rhs(i,j,k) = std::sin(pi*x)*std::sin(2.*pi*y)*std::sin(3.*pi*z) + (x-0.5)*y;
+            a(i,j,k) = 1.e-3;
+        });
+
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const Box& fbx = amrex::surroundingNodes(bx, idim);
+            const auto b = prob.bcoef[idim].array(mfi);
+            amrex::LoopOnCpu(fbx, [&] (int i, int j, int k)
+            {
+                const Real x = (i + (idim == 0 ? 0.0 : 0.5))*dx[0];
+                const Real y = (j + (idim == 1 ? 0.0 : 0.5))*dx[1];
+                const Real z = (k + (idim == 2 ? 0.0 : 0.5))*dx[2];
+                b(i,j,k) = 1.0 + 9.5*(1.0 + std::sin(4.*pi*x)*std::cos(3.*pi*y)*std::sin(5.*pi*z));
+            });
+        }
+    }
+}
+
+// Returns the number of iterations, and in resid the residual of phi
+// relative to the right-hand side.
+int solve (const Problem& prob, int single_precision_halo, Real tol_rel, MultiFab& phi, Real& resid)
+{
+    MLABecLaplacian mlabec({prob.geom}, {prob.ba}, {prob.dm});
+    mlabec.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)},
+                       {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet,
+                                     LinOpBCType::Dirichlet)});
+    phi.setVal(0.0);
+    mlabec.setLevelBC(0, &phi);
+    mlabec.setScalars(1.0, 1.0);
+    mlabec.setACoeffs(0, prob.acoef);
+    mlabec.setBCoeffs(0, amrex::GetArrOfConstPtrs(prob.bcoef));
+
+    MLMG mlmg(mlabec);
+    mlmg.setVerbose(0);
+    mlmg.setCollectStats(1);
+    mlmg.setSinglePrecisionHalo(single_precision_halo);
+    mlmg.solve({&phi}, {&prob.rhs}, tol_rel, 0.0);
+
+    MultiFab res(prob.ba, prob.dm, 1, 0);
+    mlmg.compResidual({&res}, {&phi}, {&prob.rhs});
+    resid = res.norm0() / prob.rhs.norm0();
+
+    return mlmg.getStats().numIters();
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        ParmParse pp;
+        int n_cell = 64;
+        int max_grid_size = 16;
+        Real tol_rel = 1.e-10;
+        int max_iter_diff = 1;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("tol_rel", tol_rel);
+        pp.query("max_iter_diff", max_iter_diff);
+
+        Problem prob;
+        init_problem(n_cell, max_grid_size, prob);
+
+        MultiFab phi_double(prob.ba, prob.dm, 1, 1);
+        MultiFab phi_single(prob.ba, prob.dm, 1, 1);
+        Real resid_double, resid_single;
+        const int iters_double = solve(prob, 0, tol_rel, phi_double, resid_double);
+        const int iters_single = solve(prob, 1, tol_rel, phi_single, resid_single);
+
+        MultiFab::Subtract(phi_single, phi_double, 0, 0, 1, 0);
+        const Real diff = phi_single.norm0() / phi_double.norm0();
+
+        amrex::Print() << "double precision halo : " << iters_double << " iterations, residual "
+                       << resid_double << "\n"
+                       << "single precision halo : " << iters_single << " iterations, residual "
+                       << resid_single << "\n"
+                       << "relative difference of the solutions : " << diff << "\n";
+
+        int nerr = 0;
+        if (resid_double > tol_rel || resid_single > tol_rel) ++nerr;
+        if (std::abs(iters_single - iters_double) > max_iter_diff) ++nerr;
+        if (diff > 100.*tol_rel) ++nerr;
+
+        if (nerr > 0) {
+            amrex::Abort("SinglePrecisionHalo test failed");
+        }
+        amrex::Print() << "SinglePrecisionHalo test passed\n";
+    }
+    amrex::Finalize();
+}
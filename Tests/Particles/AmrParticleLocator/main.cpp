@@ -0,0 +1,183 @@
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Particles.H>
+
+using namespace amrex;
+
+struct TestParams {
+  int nx;
+  int ny;
+  int nz;
+  int max_grid_size;
+  int nlevs;
+  int nppc;
+  int nsteps;
+};
+
+typedef ParticleContainer<1, 0> MyParticleContainer;
+typedef MyParticleContainer::ParIterType MyParIter;
+typedef MyParticleContainer::ParticleType MyParticle;
+
+// The finest level and its grid containing p, found with
+// BoxArray::intersections on every level.
+std::pair<int, int> bruteForceWhere (const MyParticle& p, const Vector<Geometry>& geom,
+                                     const Vector<BoxArray>& ba)
+{
+  std::vector<std::pair<int, Box> > isects;
+  for (int lev = ba.size()-1; lev >= 0; --lev) {
+    const auto plo = geom[lev].ProbLoArray();
+    const auto dxi = geom[lev].InvCellSizeArray();
+    const IntVect iv = getParticleCell(p, plo, dxi, geom[lev].Domain());
+    ba[lev].intersections(Box(iv, iv), isects, true, 0);
+    if (!isects.empty()) return std::make_pair(lev, isects[0].first);
+  }
+  return std::make_pair(-1, -1);
+}
+
+void testLocator (const TestParams& parms)
+{
+  RealBox real_box;
+  for (int n = 0; n < BL_SPACEDIM; n++) {
+    real_box.setLo(n, 0.0);
+    real_box.setHi(n, 1.0);
+  }
+
+  IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+  IntVect domain_hi(AMREX_D_DECL(parms.nx - 1, parms.ny - 1, parms.nz - 1));
+  const Box domain(domain_lo, domain_hi);
+
+  int is_per[BL_SPACEDIM];
+  for (int i = 0; i < BL_SPACEDIM; i++)
+    is_per[i] = 1;
+
+  const int nlevs = parms.nlevs;
+  Vector<int> rr(nlevs-1, 2);
+  Vector<Geometry> geom(nlevs);
+  geom[0].define(domain, &real_box, CoordSys::cartesian, is_per);
+  for (int lev = 1; lev < nlevs; lev++) {
+    geom[lev].define(amrex::refine(geom[lev-1].Domain(), rr[lev-1]),
+                     &real_box, CoordSys::cartesian, is_per);
+  }
+
+  // Each level refines a third of the boxes of the level below, so the
+  // fine grids are scattered over the domain.
+  Vector<BoxArray> ba(nlevs);
+  Vector<DistributionMapping> dmap(nlevs);
+  ba[0].define(domain);
+  ba[0].maxSize(parms.max_grid_size);
+  for (int lev = 1; lev < nlevs; lev++) {
+    BoxList bl;
+    for (int i = 0; i < ba[lev-1].size(); i += 3) {
+      bl.push_back(amrex::refine(ba[lev-1][i], rr[lev-1]));
+    }
+    ba[lev].define(bl);
+    ba[lev].maxSize(parms.max_grid_size);
+  }
+  for (int lev = 0; lev < nlevs; lev++) {
+    dmap[lev].define(ba[lev]);
+    amrex::Print() << "Level " << lev << " : " << ba[lev].size() << " grids\n";
+  }
+
+  MyParticleContainer pc(geom, dmap, ba, rr);
+  const long num_particles = static_cast<long>(parms.nppc) * parms.nx * parms.ny * parms.nz;
+  MyParticleContainer::ParticleInitData pdata = {1.0};
+  pc.InitRandom(num_particles, 451, pdata, false);
+
+  int nerr = 0;
+
+  // Moves the particles by up to a coarse cell and redistributes them.
+  Real t_redistribute = 0.0;
+  for (int step = 0; step < parms.nsteps; ++step) {
+    const Real dx = geom[0].CellSize(0);
+    for (int lev = 0; lev < nlevs; ++lev) {
+      for (MyParIter pti(pc, lev); pti.isValid(); ++pti) {
+        auto& aos = pti.GetArrayOfStructs();
+        for (int i = 0; i < pti.numParticles(); ++i) {
+          for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            aos[i].pos(idim) += dx * std::sin(aos[i].id() * (idim + 1.0) + step);
+          }
+        }
+      }
+    }
+    ParallelDescriptor::Barrier();
+    const Real t0 = amrex::second();
+    pc.Redistribute();
+    t_redistribute += amrex::second() - t0;
+  }
+  amrex::Print() << "Redistribute : " << t_redistribute / parms.nsteps << " s per step\n";
+
+  if (pc.TotalNumberOfParticles() != num_particles) ++nerr;
+
+  // Every particle is on the finest level containing it, and the
+  // locator finds the same level and grid.
+  AmrParticleLocator locator;
+  locator.build(ba, geom);
+  if (!locator.isValid(ba)) ++nerr;
+  const auto assign_grid = locator.getGridAssignor();
+
+  long nwrong = 0;
+  Real t_brute = 0.0, t_locator = 0.0;
+  for (int lev = 0; lev < nlevs; ++lev) {
+    for (MyParIter pti(pc, lev); pti.isValid(); ++pti) {
+      const auto& aos = pti.GetArrayOfStructs();
+      const int np = pti.numParticles();
+      std::vector<std::pair<int, int> > brute(np);
+      Real t0 = amrex::second();
+      for (int i = 0; i < np; ++i) {
+        brute[i] = bruteForceWhere(aos[i], geom, ba);
+      }
+      t_brute += amrex::second() - t0;
+
+      std::vector<GpuTuple<int, int> > located(np);
+      t0 = amrex::second();
+      for (int i = 0; i < np; ++i) {
+        located[i] = assign_grid(aos[i]);
+      }
+      t_locator += amrex::second() - t0;
+
+      for (int i = 0; i < np; ++i) {
+        if (brute[i].first != lev || brute[i].second != pti.index() ||
+            amrex::get<1>(located[i]) != lev || amrex::get<0>(located[i]) != pti.index()) {
+          ++nwrong;
+        }
+      }
+    }
+  }
+  ParallelDescriptor::ReduceLongSum(nwrong);
+  ParallelDescriptor::ReduceRealMax(t_brute);
+  ParallelDescriptor::ReduceRealMax(t_locator);
+  amrex::Print() << "Locating all particles, intersections / locator : "
+                 << t_brute << " / " << t_locator << " s\n";
+  if (nwrong != 0) ++nerr;
+
+  ParallelDescriptor::ReduceIntMax(nerr);
+  if (nerr > 0) {
+    amrex::Abort("AmrParticleLocator test failed");
+  }
+  amrex::Print() << "AmrParticleLocator test passed\n";
+}
+
+int main(int argc, char* argv[])
+{
+  amrex::Initialize(argc,argv);
+
+  ParmParse pp;
+
+  TestParams parms;
+
+  pp.get("nx", parms.nx);
+  pp.get("ny", parms.ny);
+  pp.get("nz", parms.nz);
+  pp.get("max_grid_size", parms.max_grid_size);
+  pp.get("nlevs", parms.nlevs);
+  pp.get("nppc", parms.nppc);
+  parms.nsteps = 4;
+  pp.query("nsteps", parms.nsteps);
+
+  testLocator(parms);
+
+  amrex::Finalize();
+}
@@ -0,0 +1,163 @@
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Particles.H>
+
+using namespace amrex;
+
+struct TestParams {
+  int nx;
+  int ny;
+  int nz;
+  int max_grid_size;
+  int new_max_grid_size;
+  int nppc;
+};
+
+typedef ParticleContainer<2, 1, 1, 1> MyParticleContainer;
+typedef MyParticleContainer::ParIterType MyParIter;
+
+// An order independent checksum of all the particle data: the sum over
+// the particles of a hash of their id and of the bits of their data.
+long checksum (MyParticleContainer& pc)
+{
+  const long mask = (1L << 40) - 1;
+  long sum = 0;
+  for (MyParIter pti(pc, 0); pti.isValid(); ++pti) {
+    const auto& aos = pti.GetArrayOfStructs();
+    const auto& soa = pti.GetStructOfArrays();
+    for (int i = 0; i < pti.numParticles(); ++i) {
+      const auto& p = aos[i];
+      if (p.id() <= 0) continue;
+      unsigned long h = 1469598103934665603UL ^ static_cast<unsigned long>(p.id());
+      auto mix = [&h] (const void* data, std::size_t n) {
+        const unsigned char* c = static_cast<const unsigned char*>(data);
+        for (std::size_t k = 0; k < n; ++k) {
+          h = (h ^ c[k]) * 1099511628211UL;
+        }
+      };
+      mix(&p.m_rdata, sizeof(p.m_rdata));
+      mix(&p.m_idata, sizeof(p.m_idata));
+      mix(&soa.GetRealData(0)[i], sizeof(Real));
+      mix(&soa.GetIntData(0)[i], sizeof(int));
+      sum += static_cast<long>(h) & mask;
+    }
+  }
+  ParallelDescriptor::ReduceLongSum(sum);
+  return sum;
+}
+
+void testCheckpointRestart (const TestParams& parms)
+{
+  RealBox real_box;
+  for (int n = 0; n < BL_SPACEDIM; n++) {
+    real_box.setLo(n, 0.0);
+    real_box.setHi(n, 1.0);
+  }
+
+  IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+  IntVect domain_hi(AMREX_D_DECL(parms.nx - 1, parms.ny - 1, parms.nz - 1));
+  const Box domain(domain_lo, domain_hi);
+
+  int is_per[BL_SPACEDIM];
+  for (int i = 0; i < BL_SPACEDIM; i++)
+    is_per[i] = 1;
+  Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
+
+  BoxArray ba(domain);
+  ba.maxSize(parms.max_grid_size);
+  DistributionMapping dmap(ba);
+
+  MyParticleContainer pc(geom, dmap, ba);
+  const long num_particles = static_cast<long>(parms.nppc) * parms.nx * parms.ny * parms.nz;
+  MyParticleContainer::ParticleInitData pdata = {{1.0, 2.0}, {3}, {4.0}, {5}};
+  pc.InitRandom(num_particles, 451, pdata, false);
+
+  // Make every particle different.
+  for (MyParIter pti(pc, 0); pti.isValid(); ++pti) {
+    auto& aos = pti.GetArrayOfStructs();
+    auto& soa = pti.GetStructOfArrays();
+    for (int i = 0; i < pti.numParticles(); ++i) {
+      auto& p = aos[i];
+      p.rdata(0) = p.pos(0) + p.pos(1);
+      p.rdata(1) = p.pos(2) * p.id();
+      p.idata(0) = p.id() % 97;
+      soa.GetRealData(0)[i] = p.pos(0) - p.pos(2);
+      soa.GetIntData(0)[i] = p.id() % 89;
+    }
+  }
+  pc.Redistribute();
+
+  const long sum = checksum(pc);
+  amrex::Print() << "Total number of particles    : " << num_particles << "\n";
+
+  pc.Checkpoint("chk", "particle0");
+  ParallelDescriptor::Barrier();
+
+  int nerr = 0;
+
+  // Onto the same grids.
+  {
+    MyParticleContainer pc2(geom, dmap, ba);
+    ParallelDescriptor::Barrier();
+    const Real t0 = amrex::second();
+    pc2.Restart("chk", "particle0");
+    const Real t = amrex::second() - t0;
+    const long sum2 = checksum(pc2);
+    if (sum2 != sum || pc2.TotalNumberOfParticles() != num_particles) ++nerr;
+    amrex::Print() << "Restart onto the same grids : " << t << " s, "
+                   << (sum2 == sum ? "same" : "different") << " particles\n";
+  }
+
+  // Onto smaller grids distributed in reverse order, as after a load
+  // balance or on a different number of processes.
+  BoxArray new_ba(domain);
+  new_ba.maxSize(parms.new_max_grid_size);
+  Vector<int> pmap(new_ba.size());
+  const int nprocs = ParallelDescriptor::NProcs();
+  for (int i = 0; i < new_ba.size(); ++i) {
+    pmap[i] = nprocs - 1 - (i % nprocs);
+  }
+  DistributionMapping new_dm(pmap);
+  {
+    MyParticleContainer pc2(geom, dmap, ba);
+    ParallelDescriptor::Barrier();
+    const Real t0 = amrex::second();
+    pc2.Restart("chk", "particle0", {new_ba}, {new_dm});
+    const Real t = amrex::second() - t0;
+    const long sum2 = checksum(pc2);
+    if (sum2 != sum || pc2.TotalNumberOfParticles() != num_particles) ++nerr;
+    if (pc2.ParticleBoxArray(0) != new_ba || pc2.ParticleDistributionMap(0) != new_dm) ++nerr;
+    if (!pc2.OK()) ++nerr;
+    amrex::Print() << "Restart onto new grids      : " << t << " s, "
+                   << (sum2 == sum ? "same" : "different") << " particles\n";
+  }
+
+  ParallelDescriptor::ReduceIntMax(nerr);
+  if (nerr > 0) {
+    amrex::Abort("CheckpointRestart test failed");
+  }
+  amrex::Print() << "CheckpointRestart test passed\n";
+}
+
+int main(int argc, char* argv[])
+{
+  amrex::Initialize(argc,argv);
+
+  ParmParse pp;
+
+  TestParams parms;
+
+  pp.get("nx", parms.nx);
+  pp.get("ny", parms.ny);
+  pp.get("nz", parms.nz);
+  pp.get("max_grid_size", parms.max_grid_size);
+  pp.get("new_max_grid_size", parms.new_max_grid_size);
+  pp.get("nppc", parms.nppc);
+
+  testCheckpointRestart(parms);
+
+  amrex::Finalize();
+}
@@ -0,0 +1,218 @@
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Particles.H>
+#include <AMReX_LoadBalanceKD.H>
+
+using namespace amrex;
+
+struct TestParams {
+  int nx;
+  int ny;
+  int nz;
+  int max_grid_size;
+  int nppc;
+  int nsteps;
+  int mesh_work;
+  int particle_work;
+  int boxes_per_proc;
+};
+
+typedef ParticleContainer<1, 0> MyParticleContainer;
+typedef MyParticleContainer::ParIterType MyParIter;
+
+// One step of work: particle_work evaluations per particle and mesh_work
+// stencil sweeps over every cell, with each box timed for the cost model.
+// Returns the time this process spent working.
+Real doStep (MyParticleContainer& pc, MultiFab& phi, MultiFab& tmp,
+             const TestParams& parms, loadBalanceKD::CostModel& model)
+{
+  const Real t0 = amrex::second();
+
+  for (MyParIter pti(pc, 0); pti.isValid(); ++pti) {
+    loadBalanceKD::CostTimer timer(model, pti.numParticles(), 0);
+    auto& aos = pti.GetArrayOfStructs();
+    const int np = pti.numParticles();
+    for (int i = 0; i < np; ++i) {
+      auto& p = aos[i];
+      Real w = p.rdata(0);
+      for (int n = 0; n < parms.particle_work; ++n) {
+        w = std::sin(w + p.pos(0)) * std::cos(w - p.pos(1));
+      }
+      p.rdata(0) = w;
+    }
+  }
+
+  for (MFIter mfi(phi); mfi.isValid(); ++mfi) {
+    const Box& bx = mfi.validbox();
+    loadBalanceKD::CostTimer timer(model, 0, bx.numPts());
+    auto const a = phi.array(mfi);
+    auto const b = tmp.array(mfi);
+    for (int n = 0; n < parms.mesh_work; ++n) {
+      amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+      {
+        b(i,j,k) = (a(i,j,k) + a(i-1,j,k) + a(i+1,j,k) + a(i,j-1,k)
+                    + a(i,j+1,k) + a(i,j,k-1) + a(i,j,k+1)) / 7.0;
+      });
+      amrex::LoopOnCpu(bx, [=] (int i, int j, int k) noexcept
+      {
+        a(i,j,k) = b(i,j,k);
+      });
+    }
+  }
+
+  return amrex::second() - t0;
+}
+
+// Runs nsteps steps and prints the maximum and average over the processes
+// of the time spent working.  Returns their ratio.
+Real timeSteps (MyParticleContainer& pc, MultiFab& phi, MultiFab& tmp,
+                const TestParams& parms, loadBalanceKD::CostModel& model,
+                const std::string& label)
+{
+  Real t = 0.0;
+  for (int step = 0; step < parms.nsteps; ++step) {
+    t += doStep(pc, phi, tmp, parms, model);
+  }
+  Real tmax = t, tavg = t;
+  ParallelDescriptor::ReduceRealMax(tmax);
+  ParallelDescriptor::ReduceRealSum(tavg);
+  tavg /= ParallelDescriptor::NProcs();
+  amrex::Print() << label << " : max / average work time per process " << tmax
+                 << " / " << tavg << " s\n";
+  return (tmax > 0.0) ? tavg/tmax : 1.0;
+}
+
+// The model is fitted to samples that follow it exactly.  Returns the
+// number of errors.
+int testFit ()
+{
+  const Real a = 2.e-6;
+  const Real b = 3.e-8;
+  loadBalanceKD::CostModel model;
+  for (int i = 0; i < 10; ++i) {
+    const long np = 1000*(i + ParallelDescriptor::MyProc());
+    const long nc = 4096*(i%3 + 1);
+    model.addSample(a*np, np, 0);
+    model.addSample(b*nc, 0, nc);
+    model.addSample(a*np + b*nc, np, nc);
+  }
+  model.fit();
+
+  int nerr = 0;
+  if (std::abs(model.particleCost() - a) > 1.e-8*a) ++nerr;
+  if (std::abs(model.cellCost() - b) > 1.e-8*b) ++nerr;
+  if (model.numSamples() != 0) ++nerr;
+  amrex::Print() << "Fitted costs per particle / cell : " << model.particleCost()
+                 << " / " << model.cellCost() << " s\n";
+  return nerr;
+}
+
+void testLoadBalance (const TestParams& parms)
+{
+  RealBox real_box;
+  for (int n = 0; n < BL_SPACEDIM; n++) {
+    real_box.setLo(n, 0.0);
+    real_box.setHi(n, 1.0);
+  }
+
+  IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+  IntVect domain_hi(AMREX_D_DECL(parms.nx - 1, parms.ny - 1, parms.nz - 1));
+  const Box domain(domain_lo, domain_hi);
+
+  int is_per[BL_SPACEDIM];
+  for (int i = 0; i < BL_SPACEDIM; i++)
+    is_per[i] = 1;
+  Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
+
+  BoxArray ba(domain);
+  ba.maxSize(parms.max_grid_size);
+  DistributionMapping dmap(ba);
+
+  int nerr = testFit();
+
+  // The particles are clustered towards the low corner of the domain, so
+  // that the processes owning it have most of the particle work.
+  MyParticleContainer pc(geom, dmap, ba);
+  const long num_particles = static_cast<long>(parms.nppc) * parms.nx * parms.ny * parms.nz;
+  MyParticleContainer::ParticleInitData pdata = {0.5};
+  pc.InitRandom(num_particles, 451, pdata, false);
+  for (MyParIter pti(pc, 0); pti.isValid(); ++pti) {
+    auto& aos = pti.GetArrayOfStructs();
+    for (int i = 0; i < pti.numParticles(); ++i) {
+      for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const Real x = aos[i].pos(idim);
+        aos[i].pos(idim) = x*x*x;
+      }
+    }
+  }
+  pc.Redistribute();
+  amrex::Print() << "Total number of particles    : " << num_particles << "\n";
+
+  MultiFab phi(ba, dmap, 1, 1);
+  MultiFab tmp(ba, dmap, 1, 0);
+  phi.setVal(1.0);
+
+  loadBalanceKD::CostModel model;
+  timeSteps(pc, phi, tmp, parms, model, "Before balancing");
+  model.fit();
+  amrex::Print() << "Measured costs per particle / cell : " << model.particleCost()
+                 << " / " << model.cellCost() << " s\n";
+  if (model.particleCost() <= 0.0 || model.cellCost() <= 0.0) ++nerr;
+
+  const Real eff_before = loadBalanceKD::efficiency(loadBalanceKD::boxCosts(pc, model), dmap);
+
+  BoxArray new_ba;
+  DistributionMapping new_dm;
+  loadBalanceKD::balanceAndRedistribute(pc, model, new_ba, new_dm, parms.boxes_per_proc);
+
+  const Real eff_after = loadBalanceKD::efficiency(loadBalanceKD::boxCosts(pc, model), new_dm);
+  amrex::Print() << "Predicted efficiency before / after : " << eff_before
+                 << " / " << eff_after << " with " << new_ba.size() << " boxes\n";
+
+  if (new_ba.numPts() != domain.numPts() || !new_ba.isDisjoint() ||
+      new_ba.minimalBox() != domain) ++nerr;
+  if (pc.TotalNumberOfParticles() != num_particles) ++nerr;
+  if (!pc.OK()) ++nerr;
+  if (eff_after < eff_before) ++nerr;
+
+  phi.define(new_ba, new_dm, 1, 1);
+  tmp.define(new_ba, new_dm, 1, 0);
+  phi.setVal(1.0);
+  timeSteps(pc, phi, tmp, parms, model, "After balancing ");
+
+  ParallelDescriptor::ReduceIntMax(nerr);
+  if (nerr > 0) {
+    amrex::Abort("CostModelLoadBalance test failed");
+  }
+  amrex::Print() << "CostModelLoadBalance test passed\n";
+}
+
+int main(int argc, char* argv[])
+{
+  amrex::Initialize(argc,argv);
+
+  ParmParse pp;
+
+  TestParams parms;
+
+  pp.get("nx", parms.nx);
+  pp.get("ny", parms.ny);
+  pp.get("nz", parms.nz);
+  pp.get("max_grid_size", parms.max_grid_size);
+  pp.get("nppc", parms.nppc);
+  parms.nsteps = 4;
+  pp.query("nsteps", parms.nsteps);
+  parms.mesh_work = 4;
+  pp.query("mesh_work", parms.mesh_work);
+  parms.particle_work = 8;
+  pp.query("particle_work", parms.particle_work);
+  parms.boxes_per_proc = 1;
+  pp.query("boxes_per_proc", parms.boxes_per_proc);
+
+  testLoadBalance(parms);
+
+  amrex::Finalize();
+}
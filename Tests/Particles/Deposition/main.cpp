@@ -0,0 +1,231 @@
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Particles.H>
+#include <AMReX_ParticleMesh.H>
+
+using namespace amrex;
+
+struct TestParams {
+  int nx;
+  int ny;
+  int nz;
+  int max_grid_size;
+  int nppc;
+  int nrep;
+  Vector<int> bin_sizes;
+};
+
+typedef ParticleContainer<1, 0> MyParticleContainer;
+
+// Shape factors of the given order on a cell-centered grid.  x is the
+// particle position in units of the cell size; the weights are for the
+// cells i, i+1, ..., i+order, and i is returned.
+template <int order> AMREX_FORCE_INLINE int shape (Real x, Real* s);
+
+template <> AMREX_FORCE_INLINE int shape<1> (Real x, Real* s)
+{
+  const Real xm = x - 0.5;
+  const int i = std::floor(xm);
+  const Real f = xm - i;
+  s[0] = 1.0 - f;
+  s[1] = f;
+  return i;
+}
+
+template <> AMREX_FORCE_INLINE int shape<2> (Real x, Real* s)
+{
+  const int i = std::floor(x);
+  const Real d = x - (i + 0.5);
+  s[0] = 0.5*(0.5 - d)*(0.5 - d);
+  s[1] = 0.75 - d*d;
+  s[2] = 0.5*(0.5 + d)*(0.5 + d);
+  return i - 1;
+}
+
+template <> AMREX_FORCE_INLINE int shape<3> (Real x, Real* s)
+{
+  const Real xm = x - 0.5;
+  const int i = std::floor(xm);
+  const Real f = xm - i;
+  const Real f2 = f*f;
+  const Real f3 = f2*f;
+  s[0] = (1.0 - 3.0*f + 3.0*f2 - f3)/6.0;
+  s[1] = (4.0 - 6.0*f2 + 3.0*f3)/6.0;
+  s[2] = (1.0 + 3.0*f + 3.0*f2 - 3.0*f3)/6.0;
+  s[3] = f3/6.0;
+  return i - 1;
+}
+
+template <int order>
+struct DepositCharge
+{
+  GpuArray<Real,AMREX_SPACEDIM> plo;
+  GpuArray<Real,AMREX_SPACEDIM> dxi;
+
+  AMREX_FORCE_INLINE
+  void operator() (const MyParticleContainer::ParticleType& p,
+                   Array4<Real> const& rho) const
+  {
+    Real sx[order+1], sy[order+1], sz[order+1];
+    const int i = shape<order>((p.pos(0) - plo[0]) * dxi[0], sx);
+    const int j = shape<order>((p.pos(1) - plo[1]) * dxi[1], sy);
+    const int k = shape<order>((p.pos(2) - plo[2]) * dxi[2], sz);
+    const Real q = p.rdata(0);
+    for (int kk = 0; kk <= order; ++kk) {
+      for (int jj = 0; jj <= order; ++jj) {
+        const Real wyz = q*sy[jj]*sz[kk];
+        for (int ii = 0; ii <= order; ++ii) {
+          rho(i+ii, j+jj, k+kk) += sx[ii]*wyz;
+        }
+      }
+    }
+  }
+};
+
+// Straightforward deposition into each fab, one tile after the other.
+template <int order>
+void depositReference (MyParticleContainer const& pc, MultiFab& rho, const Geometry& geom)
+{
+  rho.setVal(0.0);
+  const DepositCharge<order> f{geom.ProbLoArray(), geom.InvCellSizeArray()};
+  for (MyParticleContainer::ParConstIterType pti(pc, 0); pti.isValid(); ++pti) {
+    const auto& aos = pti.GetArrayOfStructs();
+    auto rho_arr = rho[pti].array();
+    for (int i = 0; i < pti.numParticles(); ++i) {
+      f(aos[i], rho_arr);
+    }
+  }
+  rho.SumBoundary(geom.periodicity());
+}
+
+template <int order>
+Real timeDeposit (MyParticleContainer const& pc, MultiFab& rho, const Geometry& geom,
+                  int bin_size, int nrep)
+{
+  const DepositCharge<order> f{geom.ProbLoArray(), geom.InvCellSizeArray()};
+  const IntVect bsize(AMREX_D_DECL(bin_size, bin_size, bin_size));
+  amrex::ParticleToMesh(pc, rho, 0, f, bsize);
+  ParallelDescriptor::Barrier();
+  Real t0 = amrex::second();
+  for (int n = 0; n < nrep; ++n) {
+    amrex::ParticleToMesh(pc, rho, 0, f, bsize);
+  }
+  ParallelDescriptor::Barrier();
+  return (amrex::second() - t0) / nrep;
+}
+
+// Returns the number of errors.
+template <int order>
+int testOrder (MyParticleContainer const& pc, const Geometry& geom,
+               const BoxArray& ba, const DistributionMapping& dmap,
+               int bin_size, int nrep, const std::string& label)
+{
+  int nerr = 0;
+  const int ng = 2;
+  MultiFab rho_ref(ba, dmap, 1, ng);
+  MultiFab rho(ba, dmap, 1, ng);
+
+  depositReference<order>(pc, rho_ref, geom);
+  const Real np = pc.TotalNumberOfParticles();
+  if (std::abs(rho_ref.sum() - np) > 1.e-8*np) ++nerr;
+
+  const Real t = timeDeposit<order>(pc, rho, geom, bin_size, nrep);
+  MultiFab::Subtract(rho, rho_ref, 0, 0, 1, 0);
+  const Real diff = rho.norm0() / rho_ref.norm0();
+  if (diff > 1.e-12) ++nerr;
+
+  amrex::Print() << label << " order " << order << ", bin size " << bin_size
+                 << " : " << t << " s, relative difference " << diff << "\n";
+  return nerr;
+}
+
+int testAllOrders (MyParticleContainer const& pc, const Geometry& geom,
+                   const BoxArray& ba, const DistributionMapping& dmap,
+                   int bin_size, int nrep, const std::string& label)
+{
+  int nerr = 0;
+  nerr += testOrder<1>(pc, geom, ba, dmap, bin_size, nrep, label);
+  nerr += testOrder<2>(pc, geom, ba, dmap, bin_size, nrep, label);
+  nerr += testOrder<3>(pc, geom, ba, dmap, bin_size, nrep, label);
+  return nerr;
+}
+
+void testDeposition (TestParams& parms)
+{
+  RealBox real_box;
+  for (int n = 0; n < BL_SPACEDIM; n++) {
+    real_box.setLo(n, 0.0);
+    real_box.setHi(n, 1.0);
+  }
+
+  IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+  IntVect domain_hi(AMREX_D_DECL(parms.nx - 1, parms.ny - 1, parms.nz-1));
+  const Box domain(domain_lo, domain_hi);
+
+  int is_per[BL_SPACEDIM];
+  for (int i = 0; i < BL_SPACEDIM; i++)
+    is_per[i] = 1;
+  Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
+
+  BoxArray ba(domain);
+  ba.maxSize(parms.max_grid_size);
+  DistributionMapping dmap(ba);
+
+  long num_particles = static_cast<long>(parms.nppc) * parms.nx * parms.ny * parms.nz;
+  amrex::Print() << "Total number of particles    : " << num_particles << "\n";
+
+  MyParticleContainer::ParticleInitData pdata = {1.0};
+
+  // The particles are deposited as they come from InitRandom, and after
+  // sorting them into the same bins as those used by ParticleToMesh, or
+  // by cell when whole tiles are deposited.
+  int nerr = 0;
+  for (int bin_size : parms.bin_sizes) {
+    MyParticleContainer myPC(geom, dmap, ba);
+    myPC.InitRandom(num_particles, 451, pdata, false);
+    nerr += testAllOrders(myPC, geom, ba, dmap, bin_size, parms.nrep, "Unsorted");
+
+    if (bin_size > 0) {
+      const IntVect bsize(AMREX_D_DECL(bin_size, bin_size, bin_size));
+      Gpu::ManagedDeviceVector<int> bin_start, bin_stop;
+      for (MyParticleContainer::ParIterType pti(myPC, 0); pti.isValid(); ++pti) {
+        myPC.SortParticlesByBin(pti, 0, bin_start, bin_stop, bsize);
+      }
+    } else {
+      myPC.SortParticlesByCell();
+    }
+    nerr += testAllOrders(myPC, geom, ba, dmap, bin_size, parms.nrep, "Sorted  ");
+  }
+
+  ParallelDescriptor::ReduceIntMax(nerr);
+  if (nerr > 0) {
+    amrex::Abort("Deposition test failed");
+  }
+  amrex::Print() << "Deposition test passed\n";
+}
+
+int main(int argc, char* argv[])
+{
+  amrex::Initialize(argc,argv);
+
+  ParmParse pp;
+
+  TestParams parms;
+
+  pp.get("nx", parms.nx);
+  pp.get("ny", parms.ny);
+  pp.get("nz", parms.nz);
+  pp.get("max_grid_size", parms.max_grid_size);
+  pp.get("nppc", parms.nppc);
+  parms.nrep = 5;
+  pp.query("nrep", parms.nrep);
+  parms.bin_sizes = {0, 4, 8, 16};
+  pp.queryarr("bin_sizes", parms.bin_sizes);
+
+  testDeposition(parms);
+
+  amrex::Finalize();
+}
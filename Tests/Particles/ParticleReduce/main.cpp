@@ -206,5 +206,50 @@ void testReduce ()
         AMREX_ALWAYS_ASSERT(r == 0);
     }
 
+    {
+        ReduceOps<ReduceOpSum, ReduceOpMax, ReduceOpMin, ReduceOpSum> reduce_ops;
+        auto r = amrex::ParticleReduce<ReduceData<Real, Real, int, long>>(pc,
+                 [=] AMREX_GPU_DEVICE (const PType& p) -> GpuTuple<Real, Real, int, long>
+                 {
+                     return {p.rdata(1), p.rdata(3), p.id(), 1};
+                 }, reduce_ops);
+        ParallelAllReduceTuple(reduce_ops, r);
+        AMREX_ALWAYS_ASSERT(amrex::get<0>(r) == pc.TotalNumberOfParticles());
+        AMREX_ALWAYS_ASSERT(amrex::get<1>(r) == 3);
+        AMREX_ALWAYS_ASSERT(amrex::get<2>(r) == 1);
+        AMREX_ALWAYS_ASSERT(amrex::get<3>(r) == pc.TotalNumberOfParticles());
+    }
+
+    // The same four quantities with one pass each, and fused.
+    {
+        ParallelDescriptor::Barrier();
+        Real t0 = amrex::second();
+        Real sm = amrex::ReduceSum(pc, [=] AMREX_GPU_DEVICE (const PType& p) -> Real { return p.rdata(1); });
+        Real mx = amrex::ReduceMax(pc, [=] AMREX_GPU_DEVICE (const PType& p) -> Real { return p.rdata(3); });
+        Real mn = amrex::ReduceMin(pc, [=] AMREX_GPU_DEVICE (const PType& p) -> Real { return p.rdata(2); });
+        Real np = amrex::ReduceSum(pc, [=] AMREX_GPU_DEVICE (const PType& p) -> Real { return 1.0; });
+        ParallelDescriptor::ReduceRealSum(sm);
+        ParallelDescriptor::ReduceRealMax(mx);
+        ParallelDescriptor::ReduceRealMin(mn);
+        ParallelDescriptor::ReduceRealSum(np);
+        const Real t_separate = amrex::second() - t0;
+
+        ParallelDescriptor::Barrier();
+        t0 = amrex::second();
+        ReduceOps<ReduceOpSum, ReduceOpMax, ReduceOpMin, ReduceOpSum> reduce_ops;
+        auto r = amrex::ParticleReduce<ReduceData<Real, Real, Real, Real>>(pc,
+                 [=] AMREX_GPU_DEVICE (const PType& p) -> GpuTuple<Real, Real, Real, Real>
+                 {
+                     return {p.rdata(1), p.rdata(3), p.rdata(2), 1.0};
+                 }, reduce_ops);
+        ParallelAllReduceTuple(reduce_ops, r);
+        const Real t_fused = amrex::second() - t0;
+
+        AMREX_ALWAYS_ASSERT(amrex::get<0>(r) == sm && amrex::get<1>(r) == mx &&
+                            amrex::get<2>(r) == mn && amrex::get<3>(r) == np);
+        amrex::Print() << "Four reductions, separate / fused : " << t_separate
+                       << " / " << t_fused << " s\n";
+    }
+
     amrex::Print() << "Passed! \n";
 }
@@ -0,0 +1,221 @@
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Particles.H>
+
+using namespace amrex;
+
+struct TestParams {
+  int nx;
+  int ny;
+  int nz;
+  int max_grid_size;
+  int nppc;
+  int nrep;
+};
+
+typedef ParticleContainer<2, 1, 1, 1> MyParticleContainer;
+typedef MyParticleContainer::ParIterType MyParIter;
+
+// An order independent checksum of the ids and of the components other
+// than the positions, optionally rounded to float, and the sum of the
+// positions.  Rounded positions may cross a periodic boundary, so they are
+// only compared approximately.
+std::pair<long, Real> checksum (MyParticleContainer& pc, bool round_to_float)
+{
+  const long mask = (1L << 40) - 1;
+  long sum = 0;
+  Real pos_sum = 0.0;
+  for (MyParIter pti(pc, 0); pti.isValid(); ++pti) {
+    const auto& aos = pti.GetArrayOfStructs();
+    const auto& soa = pti.GetStructOfArrays();
+    for (int i = 0; i < pti.numParticles(); ++i) {
+      const auto& p = aos[i];
+      if (p.id() <= 0) continue;
+      const Real r[3] = {p.rdata(0), p.rdata(1), soa.GetRealData(0)[i]};
+      const int n[3] = {p.id(), p.idata(0), soa.GetIntData(0)[i]};
+      unsigned long h = 1469598103934665603UL;
+      auto mix = [&h] (const void* data, std::size_t nbytes) {
+        const unsigned char* c = static_cast<const unsigned char*>(data);
+        for (std::size_t k = 0; k < nbytes; ++k) {
+          h = (h ^ c[k]) * 1099511628211UL;
+        }
+      };
+      if (round_to_float) {
+        const float f[3] = {static_cast<float>(r[0]), static_cast<float>(r[1]), static_cast<float>(r[2])};
+        mix(f, sizeof(f));
+      } else {
+        mix(r, sizeof(r));
+      }
+      mix(n, sizeof(n));
+      sum += static_cast<long>(h) & mask;
+      for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        pos_sum += p.pos(idim);
+      }
+    }
+  }
+  ParallelDescriptor::ReduceLongSum(sum);
+  ParallelDescriptor::ReduceRealSum(pos_sum);
+  return std::make_pair(sum, pos_sum);
+}
+
+// The total size of the particle data files of level 0.
+long dataSize (const std::string& dir, const std::string& name)
+{
+  long size = 0;
+  if (ParallelDescriptor::IOProcessor()) {
+    for (int i = 0; i < ParallelDescriptor::NProcs(); ++i) {
+      const std::string file = NFilesIter::FileName(i, dir + "/" + name + "/Level_0/" +
+                                                    MyParticleContainer::ParticleType::DataPrefix());
+      std::ifstream ifs(file, std::ios::binary | std::ios::ate);
+      if (ifs.good()) size += ifs.tellg();
+    }
+  }
+  ParallelDescriptor::Bcast(&size, 1, ParallelDescriptor::IOProcessorNumber());
+  return size;
+}
+
+template <class F>
+Real timeWrite (int nrep, F&& write)
+{
+  ParallelDescriptor::Barrier();
+  const Real t0 = amrex::second();
+  for (int n = 0; n < nrep; ++n) {
+    write();
+    ParallelDescriptor::Barrier();
+  }
+  return (amrex::second() - t0) / nrep;
+}
+
+void testPlotFileOutput (const TestParams& parms)
+{
+  RealBox real_box;
+  for (int n = 0; n < BL_SPACEDIM; n++) {
+    real_box.setLo(n, 0.0);
+    real_box.setHi(n, 1.0);
+  }
+
+  IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+  IntVect domain_hi(AMREX_D_DECL(parms.nx - 1, parms.ny - 1, parms.nz - 1));
+  const Box domain(domain_lo, domain_hi);
+
+  int is_per[BL_SPACEDIM];
+  for (int i = 0; i < BL_SPACEDIM; i++)
+    is_per[i] = 1;
+  Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
+
+  BoxArray ba(domain);
+  ba.maxSize(parms.max_grid_size);
+  DistributionMapping dmap(ba);
+
+  MyParticleContainer pc(geom, dmap, ba);
+  const long num_particles = static_cast<long>(parms.nppc) * parms.nx * parms.ny * parms.nz;
+  MyParticleContainer::ParticleInitData pdata = {{1.0, 2.0}, {3}, {4.0}, {5}};
+  pc.InitRandom(num_particles, 451, pdata, false);
+
+  // Make every particle different.
+  for (MyParIter pti(pc, 0); pti.isValid(); ++pti) {
+    auto& aos = pti.GetArrayOfStructs();
+    auto& soa = pti.GetStructOfArrays();
+    for (int i = 0; i < pti.numParticles(); ++i) {
+      auto& p = aos[i];
+      p.rdata(0) = p.pos(0) + p.pos(1);
+      p.rdata(1) = p.pos(2) * p.id();
+      p.idata(0) = p.id() % 97;
+      soa.GetRealData(0)[i] = p.pos(0) - p.pos(2);
+      soa.GetIntData(0)[i] = p.id() % 89;
+    }
+  }
+  pc.Redistribute();
+  amrex::Print() << "Total number of particles    : " << num_particles << "\n";
+
+  int nerr = 0;
+  const Vector<std::string> real_names = {"a", "b", "c"};
+  const Vector<std::string> int_names = {"i", "j"};
+  const Vector<int> all_real = {1, 1, 1};
+  const Vector<int> all_int = {1, 1};
+  const Vector<int> some_real = {1, 0, 1};
+  const Vector<int> some_int = {0, 1};
+
+  const Real t_double = timeWrite(parms.nrep, [&] () {
+      pc.WritePlotFile("plt_double", "particle0", all_real, all_int, real_names, int_names);
+    });
+
+  {
+    ParmParse pp("particles");
+    pp.add("plotfile_single_precision", 1);
+  }
+
+  const Real t_single = timeWrite(parms.nrep, [&] () {
+      pc.WritePlotFile("plt_single", "particle0", all_real, all_int, real_names, int_names);
+    });
+  const Real t_subset = timeWrite(parms.nrep, [&] () {
+      pc.WritePlotFile("plt_subset", "particle0", some_real, some_int, real_names, int_names);
+    });
+
+  amrex::Print() << "WritePlotFile, double / float / float subset : "
+                 << t_double << " / " << t_single << " / " << t_subset << " s\n";
+
+  // Every particle has its id and cpu, the selected ints, and its
+  // positions and selected reals.
+  const long nbytes_double = num_particles * (4*(2+2) + 8*(AMREX_SPACEDIM+3));
+  const long nbytes_single = num_particles * (4*(2+2) + 4*(AMREX_SPACEDIM+3));
+  const long nbytes_subset = num_particles * (4*(2+1) + 4*(AMREX_SPACEDIM+2));
+  if (dataSize("plt_double", "particle0") != nbytes_double) ++nerr;
+  if (dataSize("plt_single", "particle0") != nbytes_single) ++nerr;
+  if (dataSize("plt_subset", "particle0") != nbytes_subset) ++nerr;
+
+  // The older form of Checkpoint honors is_checkpoint as well.
+  pc.Checkpoint("plt_older", "particle0", false, real_names, int_names);
+  pc.Checkpoint("chk_older", "particle0", true, real_names, int_names);
+  if (dataSize("plt_older", "particle0") != nbytes_single) ++nerr;
+  if (dataSize("chk_older", "particle0") != nbytes_double) ++nerr;
+
+  // Plot files with all the components can be read back.
+  const auto sum = checksum(pc, false);
+  const auto sum_float = checksum(pc, true);
+  {
+    MyParticleContainer pc2(geom, dmap, ba);
+    pc2.Restart("plt_double", "particle0");
+    const auto sum2 = checksum(pc2, false);
+    if (sum2.first != sum.first || sum2.second != sum.second) ++nerr;
+    if (pc2.TotalNumberOfParticles() != num_particles) ++nerr;
+  }
+  {
+    MyParticleContainer pc2(geom, dmap, ba);
+    pc2.Restart("plt_single", "particle0");
+    const auto sum2 = checksum(pc2, true);
+    if (sum2.first != sum_float.first) ++nerr;
+    if (std::abs(sum2.second - sum.second) > 1.e-6*sum.second) ++nerr;
+    if (pc2.TotalNumberOfParticles() != num_particles) ++nerr;
+  }
+
+  ParallelDescriptor::ReduceIntMax(nerr);
+  if (nerr > 0) {
+    amrex::Abort("PlotFileOutput test failed");
+  }
+  amrex::Print() << "PlotFileOutput test passed\n";
+}
+
+int main(int argc, char* argv[])
+{
+  amrex::Initialize(argc,argv);
+
+  ParmParse pp;
+
+  TestParams parms;
+
+  pp.get("nx", parms.nx);
+  pp.get("ny", parms.ny);
+  pp.get("nz", parms.nz);
+  pp.get("max_grid_size", parms.max_grid_size);
+  pp.get("nppc", parms.nppc);
+  parms.nrep = 3;
+  pp.query("nrep", parms.nrep);
+
+  testPlotFileOutput(parms);
+
+  amrex::Finalize();
+}
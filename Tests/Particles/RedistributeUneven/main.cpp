@@ -0,0 +1,237 @@
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Particles.H>
+
+using namespace amrex;
+
+struct TestParams {
+  int nx;
+  int ny;
+  int nz;
+  int max_grid_size;
+  int nppc;
+  int nsteps;
+};
+
+typedef ParticleContainer<1, 1> MyParticleContainer;
+typedef MyParticleContainer::ParIterType MyParIter;
+typedef MyParticleContainer::ParticleType MyParticle;
+
+// The number of particles and the sum of their ids, including those in
+// the tiles of grids owned by other processes.
+std::pair<long, long> countAndSum (MyParticleContainer& pc)
+{
+  long n = 0, sum = 0;
+  for (const auto& kv : pc.GetParticles(0)) {
+    const auto& aos = kv.second.GetArrayOfStructs();
+    for (int i = 0; i < kv.second.numParticles(); ++i) {
+      if (aos[i].id() <= 0) continue;
+      ++n;
+      sum += aos[i].id();
+    }
+  }
+  ParallelDescriptor::ReduceLongSum(n);
+  ParallelDescriptor::ReduceLongSum(sum);
+  return std::make_pair(n, sum);
+}
+
+// The processes start with very different numbers of particles: process
+// r has r+1 times nppc particles per cell in its grids, except the last
+// process, which has none.  Process 0 also holds particles in the tile of
+// a grid owned by process 1, as after a regrid, so that only some of the
+// processes could use the copy-plan Redistribute on their own.
+void testRedistributeUneven (const TestParams& parms)
+{
+  RealBox real_box;
+  for (int n = 0; n < BL_SPACEDIM; n++) {
+    real_box.setLo(n, 0.0);
+    real_box.setHi(n, 1.0);
+  }
+
+  IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+  IntVect domain_hi(AMREX_D_DECL(parms.nx - 1, parms.ny - 1, parms.nz - 1));
+  const Box domain(domain_lo, domain_hi);
+
+  int is_per[BL_SPACEDIM];
+  for (int i = 0; i < BL_SPACEDIM; i++)
+    is_per[i] = 1;
+  Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
+
+  BoxArray ba(domain);
+  ba.maxSize(parms.max_grid_size);
+  DistributionMapping dmap(ba);
+
+  MyParticleContainer pc(geom, dmap, ba);
+
+  const int MyProc = ParallelDescriptor::MyProc();
+  const int NProcs = ParallelDescriptor::NProcs();
+  const Real* dx = geom.CellSize();
+
+  auto addParticles = [&] (int gid, int nppc) {
+    auto& tile = pc.DefineAndReturnParticleTile(0, gid, 0);
+    const Box& bx = ba[gid];
+    int k = 0;
+    for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+      for (int n = 0; n < nppc; ++n, ++k) {
+        MyParticle p;
+        p.id() = MyParticle::NextID();
+        p.cpu() = MyProc;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+          p.pos(idim) = (iv[idim] + (n + 0.5) / nppc) * dx[idim];
+        }
+        p.rdata(0) = 1.0;
+        p.idata(0) = k;
+        tile.push_back(p);
+      }
+    }
+  };
+
+  if (MyProc != NProcs-1 || NProcs == 1) {
+    for (int gid = 0; gid < ba.size(); ++gid) {
+      if (dmap[gid] == MyProc) addParticles(gid, (MyProc+1)*parms.nppc);
+    }
+  }
+  if (MyProc == 0 && NProcs > 1) {
+    for (int gid = 0; gid < ba.size(); ++gid) {
+      if (dmap[gid] == 1) {
+        addParticles(gid, 1);
+        break;
+      }
+    }
+  }
+
+  const auto start = countAndSum(pc);
+  amrex::Print() << "Total number of particles    : " << start.first << "\n";
+
+  int nerr = 0;
+  pc.Redistribute();
+  if (countAndSum(pc) != start || !pc.OK()) ++nerr;
+
+  // Particles of some processes move by up to two cells, those of the
+  // others stay where they are, so that some processes have nothing to
+  // send.  Local and global redistributes alternate.
+  for (int step = 0; step < parms.nsteps; ++step) {
+    if (MyProc % 2 == step % 2) {
+      for (MyParIter pti(pc, 0); pti.isValid(); ++pti) {
+        auto& aos = pti.GetArrayOfStructs();
+        for (int i = 0; i < pti.numParticles(); ++i) {
+          for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            aos[i].pos(idim) += 2.0 * dx[idim] * std::sin(aos[i].id() * (idim + 1.0) + step);
+          }
+        }
+      }
+    }
+    if (step % 2 == 0) {
+      pc.Redistribute(0, 0, 0, 2);
+    } else {
+      pc.Redistribute();
+    }
+    if (countAndSum(pc) != start || !pc.OK()) ++nerr;
+  }
+
+  ParallelDescriptor::ReduceIntMax(nerr);
+  if (nerr > 0) {
+    amrex::Abort("RedistributeUneven test failed");
+  }
+  amrex::Print() << "RedistributeUneven test passed\n";
+}
+
+// A single grid in a non-periodic domain, owned by process 0, so that no
+// process ever sends particles to another.  The particles are moved around
+// inside the domain and redistributed, locally and globally.
+void testRedistributeSingleBox (const TestParams& parms)
+{
+  RealBox real_box;
+  for (int n = 0; n < BL_SPACEDIM; n++) {
+    real_box.setLo(n, 0.0);
+    real_box.setHi(n, 1.0);
+  }
+
+  IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+  IntVect domain_hi(AMREX_D_DECL(parms.nx - 1, parms.ny - 1, parms.nz - 1));
+  const Box domain(domain_lo, domain_hi);
+
+  int is_per[BL_SPACEDIM];
+  for (int i = 0; i < BL_SPACEDIM; i++)
+    is_per[i] = 0;
+  Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
+
+  BoxArray ba(domain);
+  DistributionMapping dmap(ba);
+
+  MyParticleContainer pc(geom, dmap, ba);
+
+  const int MyProc = ParallelDescriptor::MyProc();
+  const Real* dx = geom.CellSize();
+
+  if (dmap[0] == MyProc) {
+    auto& tile = pc.DefineAndReturnParticleTile(0, 0, 0);
+    for (IntVect iv = domain.smallEnd(); iv <= domain.bigEnd(); domain.next(iv)) {
+      MyParticle p;
+      p.id() = MyParticle::NextID();
+      p.cpu() = MyProc;
+      for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        p.pos(idim) = (iv[idim] + 0.5) * dx[idim];
+      }
+      p.rdata(0) = 1.0;
+      p.idata(0) = 0;
+      tile.push_back(p);
+    }
+  }
+
+  const auto start = countAndSum(pc);
+  amrex::Print() << "Total number of particles in a single grid : " << start.first << "\n";
+
+  int nerr = 0;
+  pc.Redistribute();
+  if (countAndSum(pc) != start || !pc.OK()) ++nerr;
+
+  for (int step = 0; step < parms.nsteps; ++step) {
+    for (MyParIter pti(pc, 0); pti.isValid(); ++pti) {
+      auto& aos = pti.GetArrayOfStructs();
+      for (int i = 0; i < pti.numParticles(); ++i) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+          const Real x = aos[i].pos(idim) + 0.5 * dx[idim] * std::sin(aos[i].id() * (idim + 1.0) + step);
+          aos[i].pos(idim) = std::min(std::max(x, 0.5 * dx[idim]), 1.0 - 0.5 * dx[idim]);
+        }
+      }
+    }
+    if (step % 2 == 0) {
+      pc.Redistribute(0, 0, 0, 2);
+    } else {
+      pc.Redistribute();
+    }
+    if (countAndSum(pc) != start || !pc.OK()) ++nerr;
+  }
+
+  ParallelDescriptor::ReduceIntMax(nerr);
+  if (nerr > 0) {
+    amrex::Abort("RedistributeUneven single grid test failed");
+  }
+  amrex::Print() << "RedistributeUneven single grid test passed\n";
+}
+
+int main(int argc, char* argv[])
+{
+  amrex::Initialize(argc,argv);
+
+  ParmParse pp;
+
+  TestParams parms;
+
+  pp.get("nx", parms.nx);
+  pp.get("ny", parms.ny);
+  pp.get("nz", parms.nz);
+  pp.get("max_grid_size", parms.max_grid_size);
+  pp.get("nppc", parms.nppc);
+  parms.nsteps = 10;
+  pp.query("nsteps", parms.nsteps);
+
+  testRedistributeUneven(parms);
+  testRedistributeSingleBox(parms);
+
+  amrex::Finalize();
+}
@@ -0,0 +1,359 @@
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Particles.H>
+#include <AMReX_ParticleMesh.H>
+#include <AMReX_SoAParticles.H>
+
+using namespace amrex;
+
+struct TestParams {
+  int nx;
+  int ny;
+  int nz;
+  int max_grid_size;
+  int nppc;
+  int nsteps;
+};
+
+// The same particles in both layouts: rdata(0) is the charge, rdata(1)
+// sets the velocity, and idata(0) is a copy of the id.
+typedef ParticleContainer<2, 1> AoSContainer;
+typedef SoAParticleContainer<2, 1> SoAContainer;
+typedef SoAContainer::ParticleTileType::ConstParticleTileDataType SoAConstData;
+
+struct Diagnostics {
+  long np;
+  long idsum;
+  long nbad;
+  Real charge;
+  Real xmax;
+  Real zmin;
+};
+
+// Cloud-in-cell weights of the cells i and i+1 for a position x in units
+// of the cell size.
+AMREX_FORCE_INLINE int cic (Real x, Real* s)
+{
+  const Real xm = x - 0.5;
+  const int i = std::floor(xm);
+  s[1] = xm - i;
+  s[0] = 1.0 - s[1];
+  return i;
+}
+
+AMREX_FORCE_INLINE void depositCIC (Real x, Real y, Real z, Real q,
+                                    const GpuArray<Real,AMREX_SPACEDIM>& plo,
+                                    const GpuArray<Real,AMREX_SPACEDIM>& dxi,
+                                    Array4<Real> const& rho)
+{
+  Real sx[2], sy[2], sz[2];
+  const int i = cic((x - plo[0]) * dxi[0], sx);
+  const int j = cic((y - plo[1]) * dxi[1], sy);
+  const int k = cic((z - plo[2]) * dxi[2], sz);
+  for (int kk = 0; kk <= 1; ++kk) {
+    for (int jj = 0; jj <= 1; ++jj) {
+      for (int ii = 0; ii <= 1; ++ii) {
+        rho(i+ii, j+jj, k+kk) += q*sx[ii]*sy[jj]*sz[kk];
+      }
+    }
+  }
+}
+
+Diagnostics diagnostics (const AoSContainer& pc)
+{
+  using P = AoSContainer::ParticleType;
+  Diagnostics d;
+  d.np = pc.TotalNumberOfParticles();
+  d.idsum = ReduceSum(pc, [=] (const P& p) -> long { return p.id(); });
+  d.nbad = ReduceSum(pc, [=] (const P& p) -> long { return p.idata(0) != p.id(); });
+  d.charge = ReduceSum(pc, [=] (const P& p) -> Real { return p.rdata(0); });
+  d.xmax = ReduceMax(pc, [=] (const P& p) -> Real { return p.pos(0); });
+  d.zmin = ReduceMin(pc, [=] (const P& p) -> Real { return p.pos(2); });
+  ParallelDescriptor::ReduceLongSum(d.idsum);
+  ParallelDescriptor::ReduceLongSum(d.nbad);
+  ParallelDescriptor::ReduceRealSum(d.charge);
+  ParallelDescriptor::ReduceRealMax(d.xmax);
+  ParallelDescriptor::ReduceRealMin(d.zmin);
+  return d;
+}
+
+Diagnostics diagnostics (const SoAContainer& pc)
+{
+  Diagnostics d;
+  d.np = pc.TotalNumberOfParticles();
+  d.idsum = ReduceSum(pc, [=] (const SoAConstData& ptd, int i) -> long { return ptd.id(i); });
+  d.nbad = ReduceSum(pc, [=] (const SoAConstData& ptd, int i) -> long
+                     { return ptd.idata<0>(i) != ptd.id(i); });
+  d.charge = ReduceSum(pc, [=] (const SoAConstData& ptd, int i) -> Real { return ptd.rdata<0>(i); });
+  d.xmax = ReduceMax(pc, [=] (const SoAConstData& ptd, int i) -> Real { return ptd.pos(0, i); });
+  d.zmin = ReduceMin(pc, [=] (const SoAConstData& ptd, int i) -> Real { return ptd.pos(2, i); });
+  ParallelDescriptor::ReduceLongSum(d.idsum);
+  ParallelDescriptor::ReduceLongSum(d.nbad);
+  ParallelDescriptor::ReduceRealSum(d.charge);
+  ParallelDescriptor::ReduceRealMax(d.xmax);
+  ParallelDescriptor::ReduceRealMin(d.zmin);
+  return d;
+}
+
+void deposit (const AoSContainer& pc, MultiFab& rho, const Geometry& geom)
+{
+  const auto plo = geom.ProbLoArray();
+  const auto dxi = geom.InvCellSizeArray();
+  ParticleToMesh(pc, rho, 0,
+      [=] (const AoSContainer::ParticleType& p, Array4<Real> const& arr)
+      {
+        depositCIC(p.pos(0), p.pos(1), p.pos(2), p.rdata(0), plo, dxi, arr);
+      });
+}
+
+void deposit (const SoAContainer& pc, MultiFab& rho, const Geometry& geom)
+{
+  const auto plo = geom.ProbLoArray();
+  const auto dxi = geom.InvCellSizeArray();
+  ParticleToMesh(pc, rho, 0,
+      [=] (const SoAConstData& ptd, int i, Array4<Real> const& arr)
+      {
+        depositCIC(ptd.pos(0, i), ptd.pos(1, i), ptd.pos(2, i), ptd.rdata<0>(i), plo, dxi, arr);
+      });
+}
+
+// Both pushes do the same floating point operations, so that the
+// particles stay bitwise identical in the two layouts.
+void push (AoSContainer& pc, Real dt)
+{
+  for (AoSContainer::ParIterType pti(pc, 0); pti.isValid(); ++pti) {
+    auto& aos = pti.GetArrayOfStructs();
+    const int np = pti.numParticles();
+    for (int i = 0; i < np; ++i) {
+      auto& p = aos[i];
+      const Real v = p.rdata(1);
+      p.pos(0) += dt * v;
+      p.pos(1) -= dt * (0.5 * v);
+      p.pos(2) += dt * (0.25 * v);
+    }
+  }
+}
+
+void push (SoAContainer& pc, Real dt)
+{
+  for (SoAContainer::ParIterType pti(pc, 0); pti.isValid(); ++pti) {
+    const auto ptd = pti.GetParticleTile().getParticleTileData();
+    const int np = pti.numParticles();
+    Real* AMREX_RESTRICT x = ptd.m_rdata[0];
+    Real* AMREX_RESTRICT y = ptd.m_rdata[1];
+    Real* AMREX_RESTRICT z = ptd.m_rdata[2];
+    const Real* AMREX_RESTRICT v = ptd.m_rdata[AMREX_SPACEDIM+1];
+    for (int i = 0; i < np; ++i) {
+      x[i] += dt * v[i];
+      y[i] -= dt * (0.5 * v[i]);
+      z[i] += dt * (0.25 * v[i]);
+    }
+  }
+}
+
+// Returns the number of differences.
+int compare (const AoSContainer& aos, const SoAContainer& soa,
+             const Geometry& geom, const BoxArray& ba, const DistributionMapping& dmap,
+             const std::string& label)
+{
+  int nerr = 0;
+  const Diagnostics a = diagnostics(aos);
+  const Diagnostics s = diagnostics(soa);
+  if (a.np != s.np || a.idsum != s.idsum) ++nerr;
+  if (a.nbad != 0 || s.nbad != 0) ++nerr;
+  if (std::abs(a.charge - s.charge) > 1.e-10 * a.charge) ++nerr;
+  if (a.xmax != s.xmax || a.zmin != s.zmin) ++nerr;
+  if (!soa.OK()) ++nerr;
+
+  MultiFab rho_a(ba, dmap, 1, 1);
+  MultiFab rho_s(ba, dmap, 1, 1);
+  deposit(aos, rho_a, geom);
+  deposit(soa, rho_s, geom);
+  MultiFab::Subtract(rho_s, rho_a, 0, 0, 1, 0);
+  const Real diff = rho_s.norm0() / rho_a.norm0();
+  if (diff > 1.e-12) ++nerr;
+
+  amrex::Print() << label << " : " << s.np << " particles, relative density difference "
+                 << diff << (nerr > 0 ? ", FAILED" : "") << "\n";
+  return nerr;
+}
+
+// The total size of the particle data files of level 0.
+long dataSize (const std::string& dir, const std::string& name)
+{
+  long size = 0;
+  if (ParallelDescriptor::IOProcessor()) {
+    for (int i = 0; i < ParallelDescriptor::NProcs(); ++i) {
+      const std::string file = NFilesIter::FileName(i, dir + "/" + name + "/Level_0/" +
+                                                    SoAContainer::ParticleType::DataPrefix());
+      std::ifstream ifs(file, std::ios::binary | std::ios::ate);
+      if (ifs.good()) size += ifs.tellg();
+    }
+  }
+  ParallelDescriptor::Bcast(&size, 1, ParallelDescriptor::IOProcessorNumber());
+  return size;
+}
+
+template <class PC>
+Real timePush (PC& pc, Real dt)
+{
+  ParallelDescriptor::Barrier();
+  Real t0 = amrex::second();
+  push(pc, dt);
+  ParallelDescriptor::Barrier();
+  return amrex::second() - t0;
+}
+
+template <class PC>
+Real timeRedistribute (PC& pc)
+{
+  ParallelDescriptor::Barrier();
+  Real t0 = amrex::second();
+  pc.Redistribute();
+  ParallelDescriptor::Barrier();
+  return amrex::second() - t0;
+}
+
+template <class PC>
+Real timeDeposit (const PC& pc, MultiFab& rho, const Geometry& geom)
+{
+  ParallelDescriptor::Barrier();
+  Real t0 = amrex::second();
+  deposit(pc, rho, geom);
+  ParallelDescriptor::Barrier();
+  return amrex::second() - t0;
+}
+
+void testSoAParticles (TestParams& parms)
+{
+  RealBox real_box;
+  for (int n = 0; n < BL_SPACEDIM; n++) {
+    real_box.setLo(n, 0.0);
+    real_box.setHi(n, 1.0);
+  }
+
+  IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+  IntVect domain_hi(AMREX_D_DECL(parms.nx - 1, parms.ny - 1, parms.nz-1));
+  const Box domain(domain_lo, domain_hi);
+
+  int is_per[BL_SPACEDIM];
+  for (int i = 0; i < BL_SPACEDIM; i++)
+    is_per[i] = 1;
+  Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
+
+  BoxArray ba(domain);
+  ba.maxSize(parms.max_grid_size);
+  DistributionMapping dmap(ba);
+
+  long num_particles = static_cast<long>(parms.nppc) * parms.nx * parms.ny * parms.nz;
+  amrex::Print() << "Total number of particles    : " << num_particles << "\n";
+
+  AoSContainer aos(geom, dmap, ba);
+  AoSContainer::ParticleInitData pdata = {{1.0, 0.0}, {0}, {}, {}};
+  aos.InitRandom(num_particles, 451, pdata, false);
+  for (AoSContainer::ParIterType pti(aos, 0); pti.isValid(); ++pti) {
+    auto& particles = pti.GetArrayOfStructs();
+    for (int i = 0; i < pti.numParticles(); ++i) {
+      auto& p = particles[i];
+      p.rdata(1) = 0.5 + 0.1 * (p.id() % 11);
+      p.idata(0) = p.id();
+    }
+  }
+
+  SoAContainer soa(geom, dmap, ba);
+  soa.copyParticles(aos);
+
+  int nerr = compare(aos, soa, geom, ba, dmap, "Initial     ");
+
+  // Move the particles about a third of a cell per step, across the
+  // periodic boundaries too.
+  const Real dt = 0.33 / (parms.nx * 1.6);
+  Real t_push[2] = {0.0, 0.0};
+  Real t_redist[2] = {0.0, 0.0};
+  for (int step = 0; step < parms.nsteps; ++step) {
+    t_push[0] += timePush(aos, dt);
+    t_push[1] += timePush(soa, dt);
+    t_redist[0] += timeRedistribute(aos);
+    t_redist[1] += timeRedistribute(soa);
+  }
+  nerr += compare(aos, soa, geom, ba, dmap, "Moved       ");
+
+  MultiFab rho(ba, dmap, 1, 1);
+  const Real t_dep_aos = timeDeposit(aos, rho, geom);
+  const Real t_dep_soa = timeDeposit(soa, rho, geom);
+
+  // Each layout restarts from the checkpoint of the other.
+  soa.Checkpoint("soa_chk", "particles");
+  aos.Checkpoint("aos_chk", "particles");
+  AoSContainer aos_restart(geom, dmap, ba);
+  aos_restart.Restart("soa_chk", "particles");
+  SoAContainer soa_restart(geom, dmap, ba);
+  soa_restart.Restart("aos_chk", "particles");
+  nerr += compare(aos_restart, soa, geom, ba, dmap, "AoS restart ");
+  nerr += compare(aos, soa_restart, geom, ba, dmap, "SoA restart ");
+
+  // Restarting onto other grids reads each grid of the checkpoint where
+  // most of its particles go.
+  BoxArray ba_new(domain);
+  ba_new.maxSize(parms.max_grid_size/2);
+  DistributionMapping dmap_new(ba_new);
+  SoAContainer soa_new_grids(geom, dmap, ba);
+  soa_new_grids.Restart("aos_chk", "particles", {ba_new}, {dmap_new});
+  if (soa_new_grids.ParticleBoxArray(0) != ba_new) ++nerr;
+  nerr += compare(aos, soa_new_grids, geom, ba_new, dmap_new, "New grids   ");
+
+  // Checkpoints keep the precision of the particles, plot files may be
+  // written in single precision.  Both layouts write the same files.
+  {
+    ParmParse pp("particles");
+    pp.add("plotfile_single_precision", 1);
+  }
+  soa.WritePlotFile("soa_plt", "particles");
+  aos.WritePlotFile("aos_plt", "particles");
+  const long nbytes_chk = num_particles * (4*(2+1) + sizeof(SoAContainer::RealType)*(AMREX_SPACEDIM+2));
+  const long nbytes_plt = num_particles * (4*(2+1) + 4*(AMREX_SPACEDIM+2));
+  if (dataSize("soa_chk", "particles") != nbytes_chk) ++nerr;
+  if (dataSize("soa_plt", "particles") != nbytes_plt) ++nerr;
+  if (dataSize("aos_plt", "particles") != nbytes_plt) ++nerr;
+  SoAContainer soa_plt(geom, dmap, ba);
+  soa_plt.Restart("soa_plt", "particles");
+  const Diagnostics d_plt = diagnostics(soa_plt);
+  const Diagnostics d_soa = diagnostics(soa);
+  if (d_plt.np != d_soa.np || d_plt.idsum != d_soa.idsum || d_plt.nbad != 0) ++nerr;
+  if (std::abs(d_plt.xmax - d_soa.xmax) > 1.e-6) ++nerr;
+
+  ParallelDescriptor::ReduceIntMax(nerr);
+
+  amrex::Print() << "Push, AoS / SoA              : " << t_push[0] << " / " << t_push[1] << " s\n"
+                 << "Redistribute, AoS / SoA      : " << t_redist[0] << " / " << t_redist[1] << " s\n"
+                 << "Deposition, AoS / SoA        : " << t_dep_aos << " / " << t_dep_soa << " s\n";
+
+  if (nerr > 0) {
+    amrex::Abort("SoAParticles test failed");
+  }
+  amrex::Print() << "SoAParticles test passed\n";
+}
+
+int main(int argc, char* argv[])
+{
+  amrex::Initialize(argc,argv);
+
+  ParmParse pp;
+
+  TestParams parms;
+
+  pp.get("nx", parms.nx);
+  pp.get("ny", parms.ny);
+  pp.get("nz", parms.nz);
+  pp.get("max_grid_size", parms.max_grid_size);
+  pp.get("nppc", parms.nppc);
+  parms.nsteps = 10;
+  pp.query("nsteps", parms.nsteps);
+
+  testSoAParticles(parms);
+
+  amrex::Finalize();
+}
@@ -0,0 +1,223 @@
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_Particles.H>
+#include <AMReX_ParticleMesh.H>
+
+using namespace amrex;
+
+struct TestParams {
+  int nx;
+  int ny;
+  int nz;
+  int max_grid_size;
+  int nppc;
+  int nrep;
+  int bin_size;
+};
+
+// The id of each particle is also stored in its first real and int
+// components, to check that they are moved together with the particle.
+typedef ParticleContainer<1, 0, 1, 1> MyParticleContainer;
+
+void deposit (MyParticleContainer const& pc, MultiFab& rho, const Geometry& geom)
+{
+  const auto plo = geom.ProbLoArray();
+  const auto dxi = geom.InvCellSizeArray();
+  amrex::ParticleToMesh(pc, rho, 0,
+      [=] AMREX_GPU_DEVICE (const MyParticleContainer::ParticleType& p,
+                            amrex::Array4<amrex::Real> const& rho_arr)
+      {
+          amrex::Real lx = (p.pos(0) - plo[0]) * dxi[0] + 0.5;
+          amrex::Real ly = (p.pos(1) - plo[1]) * dxi[1] + 0.5;
+          amrex::Real lz = (p.pos(2) - plo[2]) * dxi[2] + 0.5;
+
+          int i = std::floor(lx);
+          int j = std::floor(ly);
+          int k = std::floor(lz);
+
+          amrex::Real xint = lx - i;
+          amrex::Real yint = ly - j;
+          amrex::Real zint = lz - k;
+
+          amrex::Real sx[] = {1.-xint, xint};
+          amrex::Real sy[] = {1.-yint, yint};
+          amrex::Real sz[] = {1.-zint, zint};
+
+          for (int kk = 0; kk <= 1; ++kk) {
+              for (int jj = 0; jj <= 1; ++jj) {
+                  for (int ii = 0; ii <= 1; ++ii) {
+                      amrex::Gpu::Atomic::Add(&rho_arr(i+ii-1, j+jj-1, k+kk-1, 0),
+                                              sx[ii]*sy[jj]*sz[kk]*p.rdata(0));
+                  }
+              }
+          }
+      });
+}
+
+Real timeDeposit (MyParticleContainer const& pc, MultiFab& rho, const Geometry& geom, int nrep)
+{
+  deposit(pc, rho, geom);
+  ParallelDescriptor::Barrier();
+  Real t0 = amrex::second();
+  for (int n = 0; n < nrep; ++n) {
+    deposit(pc, rho, geom);
+  }
+  ParallelDescriptor::Barrier();
+  return (amrex::second() - t0) / nrep;
+}
+
+// Returns the number of errors on this process.
+int checkSorted (MyParticleContainer& pc, const Geometry& geom)
+{
+  int nerr = 0;
+  const auto plo = geom.ProbLoArray();
+  const auto dxi = geom.InvCellSizeArray();
+  const Box domain = geom.Domain();
+  for (MyParticleContainer::ParIterType pti(pc, 0); pti.isValid(); ++pti) {
+    const auto& aos = pti.GetArrayOfStructs();
+    const auto& soa = pti.GetStructOfArrays();
+    const Box& box = pti.tilebox();
+    long last = -1;
+    for (int i = 0; i < pti.numParticles(); ++i) {
+      const auto& p = aos[i];
+      const IntVect iv = getParticleCell(p, plo, dxi, domain);
+      const long idx = box.index(iv);
+      if (idx < last) ++nerr;
+      last = idx;
+      if (soa.GetRealData(0)[i] != p.id()) ++nerr;
+      if (soa.GetIntData(0)[i] != p.id()) ++nerr;
+    }
+  }
+  return nerr;
+}
+
+int checkBins (MyParticleContainer& pc, const Geometry& geom, int bin_size)
+{
+  int nerr = 0;
+  const auto plo = geom.ProbLoArray();
+  const auto dxi = geom.InvCellSizeArray();
+  const Box domain = geom.Domain();
+  const IntVect bsize(AMREX_D_DECL(bin_size, bin_size, bin_size));
+  Gpu::ManagedDeviceVector<int> bin_start, bin_stop;
+  for (MyParticleContainer::ParIterType pti(pc, 0); pti.isValid(); ++pti) {
+    pc.SortParticlesByBin(pti, 0, bin_start, bin_stop, bsize);
+    const auto& aos = pti.GetArrayOfStructs();
+    const auto& soa = pti.GetStructOfArrays();
+    const Box& bins = amrex::coarsen(pti.tilebox(), bsize);
+    if (static_cast<long>(bin_start.size()) != bins.numPts()) ++nerr;
+    int np = 0;
+    for (int b = 0; b < static_cast<int>(bin_start.size()); ++b) {
+      for (int i = bin_start[b]; i < bin_stop[b]; ++i) {
+        const auto& p = aos[i];
+        const IntVect iv = amrex::coarsen(getParticleCell(p, plo, dxi, domain), bsize);
+        if (bins.index(iv) != b) ++nerr;
+        if (soa.GetRealData(0)[i] != p.id()) ++nerr;
+        if (soa.GetIntData(0)[i] != p.id()) ++nerr;
+      }
+      np += bin_stop[b] - bin_start[b];
+    }
+    if (np != pti.numParticles()) ++nerr;
+  }
+  return nerr;
+}
+
+void testSortParticles (TestParams& parms)
+{
+  RealBox real_box;
+  for (int n = 0; n < BL_SPACEDIM; n++) {
+    real_box.setLo(n, 0.0);
+    real_box.setHi(n, 1.0);
+  }
+
+  IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+  IntVect domain_hi(AMREX_D_DECL(parms.nx - 1, parms.ny - 1, parms.nz-1));
+  const Box domain(domain_lo, domain_hi);
+
+  int is_per[BL_SPACEDIM];
+  for (int i = 0; i < BL_SPACEDIM; i++)
+    is_per[i] = 1;
+  Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
+
+  BoxArray ba(domain);
+  ba.maxSize(parms.max_grid_size);
+  DistributionMapping dmap(ba);
+
+  MyParticleContainer myPC(geom, dmap, ba);
+
+  long num_particles = static_cast<long>(parms.nppc) * parms.nx * parms.ny * parms.nz;
+  amrex::Print() << "Total number of particles    : " << num_particles << "\n";
+
+  MyParticleContainer::ParticleInitData pdata = {1.0};
+  myPC.InitRandom(num_particles, 451, pdata, false);
+
+  for (MyParticleContainer::ParIterType pti(myPC, 0); pti.isValid(); ++pti) {
+    auto& aos = pti.GetArrayOfStructs();
+    auto& soa = pti.GetStructOfArrays();
+    for (int i = 0; i < pti.numParticles(); ++i) {
+      soa.GetRealData(0)[i] = aos[i].id();
+      soa.GetIntData(0)[i] = aos[i].id();
+    }
+  }
+
+  MultiFab rho0(ba, dmap, 1, 1);
+  MultiFab rho1(ba, dmap, 1, 1);
+
+  const Real t_unsorted = timeDeposit(myPC, rho0, geom, parms.nrep);
+
+  const long np_before = myPC.TotalNumberOfParticles();
+  ParallelDescriptor::Barrier();
+  Real t0 = amrex::second();
+  myPC.SortParticlesByCell();
+  ParallelDescriptor::Barrier();
+  const Real t_sort = amrex::second() - t0;
+
+  const Real t_sorted = timeDeposit(myPC, rho1, geom, parms.nrep);
+
+  int nerr = checkSorted(myPC, geom);
+  if (myPC.TotalNumberOfParticles() != np_before) ++nerr;
+
+  MultiFab::Subtract(rho1, rho0, 0, 0, 1, 0);
+  const Real diff = rho1.norm0() / rho0.norm0();
+  if (diff > 1.e-12) ++nerr;
+
+  nerr += checkBins(myPC, geom, parms.bin_size);
+
+  ParallelDescriptor::ReduceIntSum(nerr);
+
+  amrex::Print() << "Sort by cell                 : " << t_sort << " s\n"
+                 << "Deposition, unsorted         : " << t_unsorted << " s\n"
+                 << "Deposition, sorted           : " << t_sorted << " s\n"
+                 << "Speedup                      : " << t_unsorted/t_sorted << "\n"
+                 << "Relative density difference  : " << diff << "\n";
+
+  if (nerr > 0) {
+    amrex::Abort("SortParticles test failed");
+  }
+  amrex::Print() << "SortParticles test passed\n";
+}
+
+int main(int argc, char* argv[])
+{
+  amrex::Initialize(argc,argv);
+
+  ParmParse pp;
+
+  TestParams parms;
+
+  pp.get("nx", parms.nx);
+  pp.get("ny", parms.ny);
+  pp.get("nz", parms.nz);
+  pp.get("max_grid_size", parms.max_grid_size);
+  pp.get("nppc", parms.nppc);
+  parms.nrep = 5;
+  pp.query("nrep", parms.nrep);
+  parms.bin_size = 4;
+  pp.query("bin_size", parms.bin_size);
+
+  testSortParticles(parms);
+
+  amrex::Finalize();
+}
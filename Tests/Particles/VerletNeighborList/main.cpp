@@ -0,0 +1,195 @@
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_NeighborParticles.H>
+
+using namespace amrex;
+
+struct TestParams {
+  int nx;
+  int ny;
+  int nz;
+  int max_grid_size;
+  int nppc;
+  int nsteps;
+};
+
+// rdata holds the particle velocity
+typedef NeighborParticleContainer<AMREX_SPACEDIM, 0> MyParticleContainer;
+typedef MyParticleContainer::ParticleType MyParticle;
+typedef MyParticleContainer::ParIterType MyParIter;
+
+struct CheckPair
+{
+  Real cutoff2;
+
+  bool operator() (const MyParticle& p1, const MyParticle& p2) const
+  {
+    Real d2 = 0.0;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+      const Real d = p1.pos(idim) - p2.pos(idim);
+      d2 += d*d;
+    }
+    return d2 < cutoff2;
+  }
+};
+
+// The number of pairs closer than the cutoff found through the neighbor
+// list, and a checksum of their ids, both summed over all processes.
+std::pair<long, long> pairSums (MyParticleContainer& pc, Real cutoff)
+{
+  const CheckPair within{cutoff*cutoff};
+  long npairs = 0, hash = 0;
+  for (MyParIter pti(pc, 0); pti.isValid(); ++pti) {
+    const auto& particles = pti.GetArrayOfStructs();
+    const auto& neighbors = pc.GetNeighbors(0, pti.index(), pti.LocalTileIndex());
+    const auto& nl = pc.GetNeighborList(0, pti.index(), pti.LocalTileIndex());
+    const int np = pti.numParticles();
+    int k = 0;
+    for (int i = 0; i < np; ++i) {
+      const int nn = nl[k++];
+      for (int n = 0; n < nn; ++n) {
+        const int j = nl[k++] - 1;
+        const MyParticle& pj = (j < np) ? particles[j] : neighbors[j-np];
+        if (within(particles[i], pj)) {
+          ++npairs;
+          hash += (long(particles[i].id()) * 7919 + pj.id()) % 1000003;
+        }
+      }
+    }
+  }
+  ParallelDescriptor::ReduceLongSum(npairs);
+  ParallelDescriptor::ReduceLongSum(hash);
+  return std::make_pair(npairs, hash);
+}
+
+// Particles drift with a fixed velocity.  The container with a Verlet skin
+// reuses its neighbor list until some particle has moved more than half the
+// skin; at every step its list must give the same pairs as a list built
+// from scratch on a copy of the particles.  Every other step uses a plain
+// Redistribute, which keeps the neighbor buffers, instead of RedistributeLocal,
+// so that fillNeighbors also has to notice on its own that a rebuild is due.
+void testVerletNeighborList (const TestParams& parms)
+{
+  RealBox real_box;
+  for (int n = 0; n < BL_SPACEDIM; n++) {
+    real_box.setLo(n, 0.0);
+    real_box.setHi(n, 1.0);
+  }
+
+  IntVect domain_lo(AMREX_D_DECL(0, 0, 0));
+  IntVect domain_hi(AMREX_D_DECL(parms.nx - 1, parms.ny - 1, parms.nz - 1));
+  const Box domain(domain_lo, domain_hi);
+
+  int is_per[BL_SPACEDIM];
+  for (int i = 0; i < BL_SPACEDIM; i++)
+    is_per[i] = 1;
+  Geometry geom(domain, &real_box, CoordSys::cartesian, is_per);
+
+  BoxArray ba(domain);
+  ba.maxSize(parms.max_grid_size);
+  DistributionMapping dmap(ba);
+
+  const int ncells = 1;
+  MyParticleContainer pc(geom, dmap, ba, ncells);
+
+  const int MyProc = ParallelDescriptor::MyProc();
+  const Real* dx = geom.CellSize();
+
+  // the cutoff plus the skin fills one cell
+  const Real cutoff = 0.6 * dx[0];
+  const Real skin = 0.4 * dx[0];
+  const Real dt = 1.0;
+
+  for (MFIter mfi = pc.MakeMFIter(0); mfi.isValid(); ++mfi) {
+    auto& tile = pc.DefineAndReturnParticleTile(0, mfi.index(), mfi.LocalTileIndex());
+    const Box& bx = mfi.tilebox();
+    for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+      for (int n = 0; n < parms.nppc; ++n) {
+        MyParticle p;
+        p.id() = MyParticle::NextID();
+        p.cpu() = MyProc;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+          p.pos(idim) = (iv[idim] + amrex::Random()) * dx[idim];
+          p.rdata(idim) = 0.045 * dx[idim] * (2.0 * amrex::Random() - 1.0);
+        }
+        tile.push_back(p);
+      }
+    }
+  }
+
+  pc.setVerletSkin(skin);
+  pc.Redistribute();
+
+  int nerr = 0;
+  for (int step = 0; step <= parms.nsteps; ++step) {
+    if (step > 0) {
+      for (MyParIter pti(pc, 0); pti.isValid(); ++pti) {
+        auto& aos = pti.GetArrayOfStructs();
+        for (int i = 0; i < pti.numParticles(); ++i) {
+          for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            aos[i].pos(idim) += dt * aos[i].rdata(idim);
+          }
+        }
+      }
+      if (step % 2 == 0) {
+        pc.RedistributeLocal();
+      } else {
+        pc.Redistribute();
+      }
+    }
+    pc.fillNeighbors();
+    pc.buildNeighborList(CheckPair{(cutoff+skin)*(cutoff+skin)});
+
+    MyParticleContainer fresh(geom, dmap, ba, ncells);
+    for (MyParIter pti(pc, 0); pti.isValid(); ++pti) {
+      auto& tile = fresh.DefineAndReturnParticleTile(0, pti.index(), pti.LocalTileIndex());
+      const auto& aos = pti.GetArrayOfStructs();
+      for (int i = 0; i < pti.numParticles(); ++i) tile.push_back(aos[i]);
+    }
+    fresh.Redistribute();
+    fresh.fillNeighbors();
+    fresh.buildNeighborList(CheckPair{cutoff*cutoff});
+
+    const auto reused = pairSums(pc, cutoff);
+    const auto expected = pairSums(fresh, cutoff);
+    amrex::Print() << "Step " << step << ": " << reused.first << " pairs, "
+                   << pc.numVerletRebuilds() << " rebuilds, "
+                   << pc.numVerletReuses() << " reuses\n";
+    if (reused != expected) {
+      amrex::Print() << "  expected " << expected.first << " pairs\n";
+      ++nerr;
+    }
+  }
+
+  // the velocities are chosen so that the run needs both
+  if (pc.numVerletReuses() == 0 || pc.numVerletRebuilds() < 2) ++nerr;
+
+  ParallelDescriptor::ReduceIntMax(nerr);
+  if (nerr > 0) {
+    amrex::Abort("VerletNeighborList test failed");
+  }
+  amrex::Print() << "VerletNeighborList test passed\n";
+}
+
+int main(int argc, char* argv[])
+{
+  amrex::Initialize(argc,argv);
+
+  ParmParse pp;
+
+  TestParams parms;
+
+  pp.get("nx", parms.nx);
+  pp.get("ny", parms.ny);
+  pp.get("nz", parms.nz);
+  pp.get("max_grid_size", parms.max_grid_size);
+  pp.get("nppc", parms.nppc);
+  parms.nsteps = 12;
+  pp.query("nsteps", parms.nsteps);
+
+  testVerletNeighborList(parms);
+
+  amrex::Finalize();
+}